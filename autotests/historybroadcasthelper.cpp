@@ -0,0 +1,149 @@
+/* This file is part of KDE
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+// Helper process for historybroadcasttest: adds a number of history entries,
+// waits until it knows about the entries of the other instance too and prints
+// a summary of its history.
+// With "legacy" as last argument, it behaves like the instances of older
+// versions instead, which only know the notifyHistoryEntry signal.
+
+#include <konqhistorymanager.h>
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <iostream>
+#include <string>
+
+static void printSummary(const KonqHistoryList &entries)
+{
+    QStringList urls;
+    for (const KonqHistoryEntry &entry : entries) {
+        urls.append(entry.url.url() + QLatin1Char(' ') + entry.title + QLatin1Char(' ') + QString::number(entry.numberOfTimesVisited));
+    }
+    urls.sort();
+    const QByteArray hash = QCryptographicHash::hash(urls.join(QLatin1Char('\n')).toUtf8(), QCryptographicHash::Md5).toHex();
+    std::cout << urls.count() << ' ' << hash.constData() << std::endl;
+}
+
+// Receives the entries of the others through notifyHistoryEntry only, and
+// sends its own ones that way
+class LegacyInstance : public QObject
+{
+    Q_OBJECT
+public:
+    KonqHistoryList entries;
+
+    LegacyInstance()
+    {
+        QDBusConnection::sessionBus().connect(QString(), QStringLiteral("/KonqHistoryManager"), QStringLiteral("org.kde.Konqueror.HistoryManager"),
+                                              QStringLiteral("notifyHistoryEntry"), this, SLOT(slotNotifyHistoryEntry(QByteArray)));
+    }
+
+    void send(const KonqHistoryEntry &entry)
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        entry.save(stream, KonqHistoryEntry::MarshalUrlAsStrings);
+        stream << QDBusConnection::sessionBus().baseService();
+        QDBusMessage message = QDBusMessage::createSignal(QStringLiteral("/KonqHistoryManager"), QStringLiteral("org.kde.Konqueror.HistoryManager"),
+                                                          QStringLiteral("notifyHistoryEntry"));
+        message << data;
+        QDBusConnection::sessionBus().send(message);
+    }
+
+public Q_SLOTS:
+    void slotNotifyHistoryEntry(const QByteArray &data)
+    {
+        // Older versions only read the entry
+        QDataStream stream(data);
+        KonqHistoryEntry entry;
+        entry.load(stream, KonqHistoryEntry::MarshalUrlAsStrings);
+        KonqHistoryList::iterator it = entries.findEntry(entry.url);
+        if (it == entries.end()) {
+            entries.append(entry);
+        } else {
+            it->numberOfTimesVisited += entry.numberOfTimesVisited;
+            it->title = entry.title;
+        }
+    }
+};
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc != 4 && (argc != 5 || qstrcmp(argv[4], "legacy") != 0)) {
+        std::cerr << "usage: historybroadcasthelper <name> <entries> <expected total> [legacy]" << std::endl;
+        return 1;
+    }
+    const QString name = QString::fromLocal8Bit(argv[1]);
+    const int count = QByteArray(argv[2]).toInt();
+    const int expected = QByteArray(argv[3]).toInt();
+
+    if (argc == 5) {
+        LegacyInstance legacy;
+        std::cout << "ready" << std::endl;
+        std::string line;
+        std::getline(std::cin, line);
+
+        for (int i = 0; i < count; ++i) {
+            KonqHistoryEntry entry;
+            entry.url = QUrl(QStringLiteral("http://%1.example.org/page%2.html").arg(name).arg(i));
+            entry.title = QStringLiteral("%1 %2").arg(name).arg(i);
+            entry.numberOfTimesVisited = 1;
+            entry.firstVisited = entry.lastVisited = QDateTime::currentDateTime();
+            legacy.send(entry);
+        }
+        std::cout << "sent" << std::endl;
+
+        QElapsedTimer timer;
+        timer.start();
+        QTimer poll;
+        QObject::connect(&poll, &QTimer::timeout, &app, [&]() {
+            if (legacy.entries.count() >= expected || timer.elapsed() > 10000) {
+                app.quit();
+            }
+        });
+        poll.start(50);
+        app.exec();
+        printSummary(legacy.entries);
+        return 0;
+    }
+
+    KonqHistoryManager mgr(nullptr);
+
+    // Wait until the other instance is listening as well
+    std::cout << "ready" << std::endl;
+    std::string line;
+    std::getline(std::cin, line);
+
+    for (int i = 0; i < count; ++i) {
+        const QUrl url(QStringLiteral("http://%1.example.org/page%2.html").arg(name).arg(i));
+        mgr.addPending(url);
+        mgr.confirmPending(url, QString(), QStringLiteral("%1 %2").arg(name).arg(i));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &app, [&]() {
+        if (mgr.entries().count() >= expected || timer.elapsed() > 10000) {
+            app.quit();
+        }
+    });
+    poll.start(50);
+    app.exec();
+
+    printSummary(mgr.entries());
+    return 0;
+}
+
+#include "historybroadcasthelper.moc"
@@ -0,0 +1,129 @@
+/* This file is part of KDE
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <QObject>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+// Runs two history managers in separate processes on a private session bus
+// and checks that they end up with the same history.
+class HistoryBroadcastTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testHistoriesConverge();
+    void testLegacyInstance();
+
+private:
+    void startHelper(QProcess &process, const QString &name, const QString &dataDir, int count, int expected, bool legacy = false);
+
+    QProcess m_bus;
+    QString m_busAddress;
+};
+
+QTEST_GUILESS_MAIN(HistoryBroadcastTest)
+
+void HistoryBroadcastTest::initTestCase()
+{
+    const QString dbusDaemon = QStandardPaths::findExecutable(QStringLiteral("dbus-daemon"));
+    if (dbusDaemon.isEmpty()) {
+        QSKIP("dbus-daemon not found");
+    }
+    m_bus.start(dbusDaemon, {QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address")});
+    QVERIFY(m_bus.waitForStarted());
+    QVERIFY(m_bus.waitForReadyRead());
+    m_busAddress = QString::fromLocal8Bit(m_bus.readLine()).trimmed();
+    QVERIFY(!m_busAddress.isEmpty());
+}
+
+void HistoryBroadcastTest::cleanupTestCase()
+{
+    if (m_bus.state() != QProcess::NotRunning) {
+        m_bus.terminate();
+        m_bus.waitForFinished();
+    }
+}
+
+void HistoryBroadcastTest::startHelper(QProcess &process, const QString &name, const QString &dataDir, int count, int expected, bool legacy)
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("DBUS_SESSION_BUS_ADDRESS"), m_busAddress);
+    env.insert(QStringLiteral("XDG_DATA_HOME"), dataDir + QLatin1String("/data"));
+    env.insert(QStringLiteral("XDG_CONFIG_HOME"), dataDir + QLatin1String("/config"));
+    process.setProcessEnvironment(env);
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    QStringList arguments = {name, QString::number(count), QString::number(expected)};
+    if (legacy) {
+        arguments.append(QStringLiteral("legacy"));
+    }
+    process.start(QCoreApplication::applicationDirPath() + QLatin1String("/historybroadcasthelper"), arguments);
+}
+
+void HistoryBroadcastTest::testHistoriesConverge()
+{
+    const int count = 200;
+    QTemporaryDir dir1, dir2;
+    QProcess helper1, helper2;
+    startHelper(helper1, QStringLiteral("first"), dir1.path(), count, 2 * count);
+    startHelper(helper2, QStringLiteral("second"), dir2.path(), count, 2 * count);
+
+    QVERIFY(helper1.waitForReadyRead());
+    QCOMPARE(helper1.readLine().trimmed(), QByteArray("ready"));
+    QVERIFY(helper2.waitForReadyRead());
+    QCOMPARE(helper2.readLine().trimmed(), QByteArray("ready"));
+
+    helper1.write("go\n");
+    helper2.write("go\n");
+
+    QVERIFY(helper1.waitForFinished(20000));
+    QVERIFY(helper2.waitForFinished(20000));
+    QCOMPARE(helper1.exitCode(), 0);
+    QCOMPARE(helper2.exitCode(), 0);
+
+    const QByteArray summary1 = helper1.readAll().trimmed();
+    const QByteArray summary2 = helper2.readAll().trimmed();
+    QVERIFY(summary1.startsWith(QByteArray::number(2 * count) + ' '));
+    QCOMPARE(summary1, summary2);
+}
+
+// An instance of an older version, only knowing notifyHistoryEntry, still
+// gets the entries of the new ones once they know it's there
+void HistoryBroadcastTest::testLegacyInstance()
+{
+    const int count = 200;
+    QTemporaryDir dir1, dir2;
+    QProcess helper, legacyHelper;
+    startHelper(helper, QStringLiteral("new"), dir1.path(), count, count + 1);
+    startHelper(legacyHelper, QStringLiteral("old"), dir2.path(), 1, count, true);
+
+    QVERIFY(helper.waitForReadyRead());
+    QCOMPARE(helper.readLine().trimmed(), QByteArray("ready"));
+    QVERIFY(legacyHelper.waitForReadyRead());
+    QCOMPARE(legacyHelper.readLine().trimmed(), QByteArray("ready"));
+
+    legacyHelper.write("go\n");
+    QVERIFY(legacyHelper.waitForReadyRead());
+    QCOMPARE(legacyHelper.readLine().trimmed(), QByteArray("sent"));
+    QTest::qWait(200); // ### fragile. Let the new instance see the old one
+    helper.write("go\n");
+
+    QVERIFY(helper.waitForFinished(20000));
+    QVERIFY(legacyHelper.waitForFinished(20000));
+    QCOMPARE(helper.exitCode(), 0);
+    QCOMPARE(legacyHelper.exitCode(), 0);
+
+    // The new instance has its entries and the old one's, the old one has the new one's
+    QVERIFY(helper.readAll().trimmed().startsWith(QByteArray::number(count + 1) + ' '));
+    QVERIFY(legacyHelper.readAll().trimmed().startsWith(QByteArray::number(count) + ' '));
+}
+
+#include "historybroadcasttest.moc"
@@ -8,9 +8,24 @@
 #include <QSignalSpy>
 #include <konqhistorymanager.h>
 
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <QDBusConnection>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QObject>
+#include <QSaveFile>
 #include <QStandardPaths>
 
+#include <zlib.h> // for crc32
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 class HistoryManagerTest : public QObject
 {
     Q_OBJECT
@@ -20,6 +35,27 @@ private Q_SLOTS:
     void testGetSetMaxCount();
     void testGetSetMaxAge();
     void testAddHistoryEntry();
+    void testSavedAtShutdown();
+    void testContainsEquivalentUrls();
+    void benchmarkBatchedExpiry();
+    void benchmarkBroadcastMessages();
+    void benchmarkMemoryPerEntry();
+    void testUnsortedHistoryFile();
+    void benchmarkStartup_data();
+    void benchmarkStartup();
+};
+
+// Counts the history broadcasts seen on the bus
+class MessageCounter : public QObject
+{
+    Q_OBJECT
+public:
+    int messages = 0;
+public Q_SLOTS:
+    void count()
+    {
+        ++messages;
+    }
 };
 
 QTEST_MAIN(HistoryManagerTest)
@@ -128,4 +164,325 @@ void HistoryManagerTest::testAddHistoryEntry()
     QCOMPARE(int(entry.numberOfTimesVisited), 1);
 }
 
+static QString historyFileName()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/konqueror/konq_history");
+}
+
+// Writes a history file in the V4 format, which is still supported for loading
+static bool writeHistoryFile(int count)
+{
+    QDir().mkpath(QFileInfo(historyFileName()).absolutePath());
+    QSaveFile file(historyFileName());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    const QDateTime now = QDateTime::currentDateTime();
+    for (int i = 0; i < count; ++i) {
+        KonqHistoryEntry entry;
+        entry.url = QUrl(QStringLiteral("http://host%1.historymgrtest.org/page%2.html").arg(i % 500).arg(i));
+        entry.title = QStringLiteral("Page %1").arg(i);
+        entry.firstVisited = now.addSecs(i - count);
+        entry.lastVisited = entry.firstVisited;
+        entry.save(stream, KonqHistoryEntry::NoFlags);
+    }
+
+    QDataStream fileStream(&file);
+    const quint32 crc = crc32(0, reinterpret_cast<unsigned char *>(data.data()), data.size());
+    fileStream << quint32(4) << crc << data;
+    return file.commit();
+}
+
+void HistoryManagerTest::testSavedAtShutdown()
+{
+    const QUrl url(QStringLiteral("http://shutdown.historymgrtest.org/"));
+    {
+        KonqHistoryManager mgr(nullptr);
+        mgr.addPending(url);
+        mgr.confirmPending(url, QString(), QStringLiteral("Closed at once"));
+        // Destroyed before the broadcast comes back
+    }
+    KonqHistoryManager mgr(nullptr);
+    const KonqHistoryEntry entry = mgr.findEntry(url);
+    QCOMPARE(entry.url, url);
+    QCOMPARE(entry.title, QStringLiteral("Closed at once"));
+
+    mgr.emitRemoveFromHistory(url);
+    waitForRemovedSignal(&mgr);
+}
+
+// The links of a page aren't necessarily encoded like the history urls
+void HistoryManagerTest::testContainsEquivalentUrls()
+{
+    KonqHistoryManager mgr(nullptr);
+    const QUrl url(QStringLiteral("http://contains.historymgrtest.org/~user/caf%C3%A9 menu.html"));
+    mgr.addPending(url);
+    waitForAddedSignal(&mgr);
+
+    QVERIFY(mgr.contains(url.url()));
+    QVERIFY(mgr.contains(url.toDisplayString()));
+    QVERIFY(mgr.contains(QStringLiteral("http://contains.historymgrtest.org/%7Euser/caf%C3%A9%20menu.html")));
+    QVERIFY(mgr.contains(QStringLiteral("http://contains.historymgrtest.org/~user/café menu.html")));
+    QVERIFY(!mgr.contains(QStringLiteral("http://contains.historymgrtest.org/~user/cafe menu.html")));
+
+    mgr.emitRemoveFromHistory(url);
+    waitForRemovedSignal(&mgr);
+    QVERIFY(!mgr.contains(url.url()));
+}
+
+void HistoryManagerTest::benchmarkBatchedExpiry()
+{
+    const int total = 100000;
+    const int kept = 50000;
+
+    KConfigGroup cs(KSharedConfig::openConfig(QStringLiteral("konquerorrc")), "HistorySettings");
+    const int oldMaxCount = cs.readEntry("Maximum of History entries", 500);
+    cs.writeEntry("Maximum of History entries", total);
+    cs.sync();
+    QVERIFY(writeHistoryFile(total));
+
+    {
+        KonqHistoryManager mgr(nullptr);
+        QCOMPARE(mgr.entries().count(), total);
+
+        qRegisterMetaType<KonqHistoryList>("KonqHistoryList");
+        QSignalSpy removedSpy(&mgr, SIGNAL(entryRemoved(KonqHistoryEntry)));
+        QSignalSpy bulkRemovedSpy(&mgr, SIGNAL(entriesRemoved(KonqHistoryList)));
+
+        QElapsedTimer timer;
+        qint64 expiryTime = 0;
+        connect(&mgr, &KonqHistoryProvider::entriesRemoved, this, [&]() {
+            expiryTime = timer.elapsed();
+        });
+        timer.start();
+        mgr.emitSetMaxCount(kept);
+        QVERIFY(bulkRemovedSpy.wait());
+        qDebug() << "Expired" << (total - kept) << "of" << total << "entries in" << expiryTime << "ms";
+
+        QCOMPARE(mgr.entries().count(), kept);
+        QCOMPARE(bulkRemovedSpy.count(), 1);
+        QCOMPARE(removedSpy.count(), 0);
+        QCOMPARE(qvariant_cast<KonqHistoryList>(bulkRemovedSpy.at(0).at(0)).count(), total - kept);
+        // The oldest entries went away
+        QCOMPARE(mgr.entries().first().url.path(), QStringLiteral("/page%1.html").arg(total - kept));
+
+        mgr.emitSetMaxCount(oldMaxCount);
+        QTest::qWait(100);   // ### fragile. Wait again otherwise the change will be lost
+    }
+
+    QFile::remove(historyFileName());
+}
+
+void HistoryManagerTest::benchmarkBroadcastMessages()
+{
+    const int visits = 1000;
+
+    KonqHistoryManager mgr(nullptr);
+    MessageCounter counter;
+    QDBusConnection dbus = QDBusConnection::sessionBus();
+    const QString path = QStringLiteral("/KonqHistoryManager");
+    const QString interface = QStringLiteral("org.kde.Konqueror.HistoryManager");
+    QVERIFY(dbus.connect(QString(), path, interface, QStringLiteral("notifyHistoryEntry"), &counter, SLOT(count())));
+    QVERIFY(dbus.connect(QString(), path, interface, QStringLiteral("notifyHistoryEntries"), &counter, SLOT(count())));
+
+    // Simulate an automated page-cycling workload: every page is added as
+    // pending, then confirmed, and the event loop keeps running in between.
+    QList<QUrl> urls;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < visits; ++i) {
+        const QUrl url(QStringLiteral("http://cycle%1.historymgrtest.org/index.html").arg(i));
+        urls.append(url);
+        mgr.addPending(url);
+        mgr.confirmPending(url, QString(), QStringLiteral("Page %1").arg(i));
+        QTest::qWait(1);
+    }
+    QTRY_VERIFY(!mgr.entries().isEmpty() && mgr.entries().last().url == urls.last());
+    qDebug() << counter.messages << "history messages for" << visits << "visits in" << timer.elapsed() << "ms";
+    QVERIFY(counter.messages < visits);
+
+    mgr.emitRemoveListFromHistory(urls);
+    QTest::qWait(100);   // ### fragile. Wait for the removal to be saved
+}
+
+#ifdef __GLIBC__
+static qint64 allocatedBytes()
+{
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return mallinfo().uordblks;
+#endif
+}
+#endif
+
+void HistoryManagerTest::benchmarkMemoryPerEntry()
+{
+#ifndef __GLIBC__
+    QSKIP("Needs mallinfo");
+#else
+    const int total = 100000;
+
+    KConfigGroup cs(KSharedConfig::openConfig(QStringLiteral("konquerorrc")), "HistorySettings");
+    const int oldMaxCount = cs.readEntry("Maximum of History entries", 500);
+    cs.writeEntry("Maximum of History entries", total);
+    cs.sync();
+    QVERIFY(writeHistoryFile(total));
+
+    {
+        // Only the provider, to leave the completion object out of the picture
+        const qint64 before = allocatedBytes();
+        KonqHistoryProvider provider;
+        QVERIFY(provider.loadHistory());
+        QCOMPARE(provider.entries().count(), total);
+        const qint64 providerBytes = allocatedBytes() - before;
+        qDebug() << "KonqHistoryProvider:" << providerBytes / total << "bytes per entry";
+
+        // The same entries as a KonqHistoryList, as the provider kept them
+        // before it stored them in a compact form
+        const qint64 beforeList = allocatedBytes();
+        const KonqHistoryList entries = provider.entries();
+        const qint64 listBytes = allocatedBytes() - beforeList;
+        qDebug() << "KonqHistoryList:" << listBytes / total << "bytes per entry";
+        QVERIFY(providerBytes < listBytes);
+    }
+    {
+        const qint64 before = allocatedBytes();
+        KonqHistoryManager mgr(nullptr);
+        QCOMPARE(mgr.entries().count(), total);
+        const qint64 managerBytes = allocatedBytes() - before;
+        qDebug() << "KonqHistoryManager (with completion):" << managerBytes / total << "bytes per entry";
+    }
+
+    cs.writeEntry("Maximum of History entries", oldMaxCount);
+    cs.sync();
+    QFile::remove(historyFileName());
+#endif
+}
+
+static quint32 historyFileVersion()
+{
+    QFile file(historyFileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QDataStream stream(&file);
+    quint32 version = 0;
+    stream >> version;
+    return version;
+}
+
+// Writes a history file in the current format, with the records in the given order
+static bool writeMappedHistoryFile(const KonqHistoryList &entries)
+{
+    QDir().mkpath(QFileInfo(historyFileName()).absolutePath());
+    QSaveFile file(historyFileName());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream fileStream(&file);
+    fileStream << quint32(5) << quint32(entries.count());
+    for (const KonqHistoryEntry &entry : entries) {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_12);
+        entry.save(stream, KonqHistoryEntry::NoFlags);
+        const quint32 crc = crc32(0, reinterpret_cast<unsigned char *>(data.data()), data.size());
+        fileStream << quint32(data.size()) << crc << entry.lastVisited.toMSecsSinceEpoch();
+        fileStream.writeRawData(data.constData(), data.size());
+    }
+    return file.commit();
+}
+
+// Entries visited again are updated in place, so the file isn't sorted:
+// the oldest ones must still be the ones which expire
+void HistoryManagerTest::testUnsortedHistoryFile()
+{
+    const int total = 100;
+    const int kept = 10;
+    KConfigGroup cs(KSharedConfig::openConfig(QStringLiteral("konquerorrc")), "HistorySettings");
+    const int oldMaxCount = cs.readEntry("Maximum of History entries", 500);
+    cs.writeEntry("Maximum of History entries", kept);
+    cs.sync();
+
+    const QDateTime now = QDateTime::currentDateTime();
+    KonqHistoryList entries;
+    for (int i = 0; i < total; ++i) {
+        KonqHistoryEntry entry;
+        entry.url = QUrl(QStringLiteral("http://unsorted.historymgrtest.org/page%1.html").arg(i));
+        entry.firstVisited = now.addSecs(i - total);
+        // The first entries were visited last
+        entry.lastVisited = i < kept ? now : entry.firstVisited;
+        entries.append(entry);
+    }
+    QVERIFY(writeMappedHistoryFile(entries));
+
+    {
+        KonqHistoryProvider provider;
+        QVERIFY(provider.loadHistory());
+        const KonqHistoryList loaded = provider.entries();
+        QCOMPARE(loaded.count(), kept);
+        for (int i = 0; i < kept; ++i) {
+            QVERIFY2(loaded.constFindEntry(entries.at(i).url) != loaded.constEnd(), qPrintable(entries.at(i).url.url()));
+        }
+    }
+
+    cs.writeEntry("Maximum of History entries", oldMaxCount);
+    cs.sync();
+    QFile::remove(historyFileName());
+}
+
+void HistoryManagerTest::benchmarkStartup_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("500k") << 500000;
+}
+
+void HistoryManagerTest::benchmarkStartup()
+{
+    QFETCH(int, count);
+
+    KConfigGroup cs(KSharedConfig::openConfig(QStringLiteral("konquerorrc")), "HistorySettings");
+    const int oldMaxCount = cs.readEntry("Maximum of History entries", 500);
+    cs.writeEntry("Maximum of History entries", count);
+    cs.sync();
+    QVERIFY(writeHistoryFile(count));
+
+    {
+        // Convert the file to the current format: the sender of a
+        // notification saves the history.
+        KonqHistoryProvider provider;
+        QVERIFY(provider.loadHistory());
+        QCOMPARE(provider.entries().count(), count);
+        provider.emitSetMaxCount(count);
+        QTRY_COMPARE(historyFileVersion(), quint32(5));
+    }
+
+    // What the first window waits for: the entries are decoded later
+    QBENCHMARK {
+        KonqHistoryProvider provider;
+        QVERIFY(provider.loadHistory());
+        QCOMPARE(provider.entryCount(), count);
+    }
+
+    {
+        KonqHistoryProvider provider;
+        QVERIFY(provider.loadHistory());
+        QElapsedTimer timer;
+        timer.start();
+        QCOMPARE(provider.entries().count(), count);
+        qDebug() << "Decoding" << count << "entries on demand took" << timer.elapsed() << "ms";
+    }
+
+    cs.writeEntry("Maximum of History entries", oldMaxCount);
+    cs.sync();
+    QFile::remove(historyFileName());
+}
+
 #include "historymanagertest.moc"
@@ -0,0 +1,172 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <KonquerorAdaptor.h>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+class KfmclientTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+    void testNewTabsLoadsOnlyTheFirst();
+    void benchmarkOpenUrls_data();
+    void benchmarkOpenUrls();
+
+private:
+    bool runKfmclient(const QStringList &args);
+    QList<KonqView *> viewsShowing(const QList<QUrl> &urls) const;
+
+    QTemporaryDir m_tempDir;
+    QList<QUrl> m_urls;
+};
+
+QTEST_MAIN(KfmclientTest)
+
+void KfmclientTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    QVERIFY(m_tempDir.isValid());
+
+    if (!QFile::exists(QCoreApplication::applicationDirPath() + QLatin1String("/kfmclient"))) {
+        QSKIP("kfmclient wasn't built");
+    }
+    // kfmclient has to find this process instead of starting Konqueror
+    QDBusConnection dbus = QDBusConnection::sessionBus();
+    if (!dbus.isConnected()) {
+        QSKIP("No session bus");
+    }
+    if (!dbus.registerService(QStringLiteral("org.kde.konqueror"))) {
+        QSKIP("Konqueror is running");
+    }
+    new KonquerorAdaptor;
+
+    for (int i = 0; i < 100; ++i) {
+        QFile file(m_tempDir.filePath(QStringLiteral("page%1.html").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("<html><head><title>Page " + QByteArray::number(i) + "</title></head><body><p>Hello World</p></body></html>");
+        m_urls.append(QUrl::fromLocalFile(file.fileName()));
+    }
+}
+
+void KfmclientTest::cleanup()
+{
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    if (windows) {
+        const QList<KonqMainWindow *> windowsToDelete = *windows;
+        qDeleteAll(windowsToDelete);
+    }
+}
+
+bool KfmclientTest::runKfmclient(const QStringList &args)
+{
+    // The event loop has to run meanwhile, to answer its D-Bus calls
+    QProcess kfmclient;
+    kfmclient.setProcessChannelMode(QProcess::ForwardedChannels);
+    QSignalSpy spyFinished(&kfmclient, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished));
+    kfmclient.start(QCoreApplication::applicationDirPath() + QLatin1String("/kfmclient"), args);
+    if (!spyFinished.wait(30000)) {
+        return false;
+    }
+    return kfmclient.exitStatus() == QProcess::NormalExit && kfmclient.exitCode() == 0;
+}
+
+QList<KonqView *> KfmclientTest::viewsShowing(const QList<QUrl> &urls) const
+{
+    QList<KonqView *> views;
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    if (!windows) {
+        return views;
+    }
+    for (const QUrl &url : urls) {
+        for (KonqMainWindow *window : qAsConst(*windows)) {
+            for (KonqView *view : window->viewMap()) {
+                if (view->url() == url) {
+                    views.append(view);
+                }
+            }
+        }
+    }
+    return views;
+}
+
+void KfmclientTest::testNewTabsLoadsOnlyTheFirst()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+
+    const QList<QUrl> urls = m_urls.mid(0, 5);
+    QVERIFY(runKfmclient(QStringList{QStringLiteral("newTabs")} + QUrl::toStringList(urls)));
+
+    const QList<KonqView *> views = viewsShowing(urls);
+    QCOMPARE(views.count(), urls.count());
+    QVERIFY(!views.first()->isHibernated());
+    for (int i = 1; i < views.count(); ++i) {
+        KonqView *view = views.at(i);
+        QVERIFY(view->isHibernated());
+        QCOMPARE(view->locationBarURL(), urls.at(i).toDisplayString());
+    }
+
+    // The tab is loaded when activated
+    KonqView *view = views.last();
+    KonqMainWindow *window = view->mainWindow();
+    window->viewManager()->showTab(view);
+    QTRY_VERIFY(!view->isHibernated());
+    QTRY_COMPARE(view->caption(), QStringLiteral("Page 4"));
+    QCOMPARE(view->url(), urls.last());
+}
+
+void KfmclientTest::benchmarkOpenUrls_data()
+{
+    QTest::addColumn<bool>("batch");
+
+    QTest::newRow("one kfmclient newTab per URL") << false;
+    QTest::newRow("one kfmclient newTabs for all URLs") << true;
+}
+
+void KfmclientTest::benchmarkOpenUrls()
+{
+    QFETCH(bool, batch);
+
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+
+    QElapsedTimer timer;
+    timer.start();
+    if (batch) {
+        QVERIFY(runKfmclient(QStringList{QStringLiteral("newTabs")} + QUrl::toStringList(m_urls)));
+    } else {
+        for (const QUrl &url : qAsConst(m_urls)) {
+            QVERIFY(runKfmclient({QStringLiteral("newTab"), url.toString()}));
+        }
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(viewsShowing(m_urls).count(), m_urls.count(), 60000);
+    const qint64 elapsed = timer.elapsed();
+
+    qDebug() << "Time to open" << m_urls.count() << "URLs:" << elapsed << "ms";
+    QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+#include "kfmclienttest.moc"
@@ -0,0 +1,112 @@
+/* This file is part of KDE
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+// Helper process for konqclosedwindowsmanagertest: either closes a number of
+// windows and waits until they have all been reopened elsewhere, or waits
+// until it knows about the windows closed by the other instance and reopens
+// them all. Prints the number of windows left or reopened correctly, and the
+// time it took in milliseconds.
+
+#include <konqcloseditem.h>
+#include <konqclosedwindowsmanager.h>
+#include <konqsettingsxt.h>
+#include <konqundomanager.h>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+static const int s_tabs = 5;
+static const int s_historyItems = 10;
+
+// What KonqMainWindow::saveProperties() would write, roughly
+static void writeWindowState(KConfigGroup &group, const QString &title)
+{
+    group.writeEntry("Title", title);
+    for (int tab = 0; tab < s_tabs; ++tab) {
+        for (int item = 0; item < s_historyItems; ++item) {
+            const QString prefix = QStringLiteral("HistoryItemViewT%1_%2").arg(tab).arg(item);
+            group.writeEntry(prefix + QLatin1String("Url"), QStringLiteral("https://www.example.org/%1/page%2.html").arg(title).arg(item));
+            group.writeEntry(prefix + QLatin1String("Title"), QStringLiteral("Page %1 of %2").arg(item).arg(title));
+        }
+    }
+}
+
+static bool isWindowStateComplete(const KConfigGroup &group, const QString &title)
+{
+    return group.readEntry("Title", QString()) == title
+           && group.keyList().count() == 1 + 2 * s_tabs * s_historyItems;
+}
+
+static void waitUntil(const std::function<bool()> &condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition() && timer.elapsed() < 20000) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 50);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    if (argc != 3) {
+        std::cerr << "usage: konqclosedwindowshelper close|undo <windows>" << std::endl;
+        return 1;
+    }
+    const QByteArray mode = argv[1];
+    const int count = QByteArray(argv[2]).toInt();
+
+    KonqSettings::setMaxNumClosedItems(count);
+    KonqClosedWindowsManager *manager = KonqClosedWindowsManager::self();
+    KonqUndoManager *undoManager = new KonqUndoManager(manager, nullptr);
+
+    // Wait until the other instance is listening as well
+    std::cout << "ready" << std::endl;
+    std::string line;
+    std::getline(std::cin, line);
+
+    QElapsedTimer timer;
+    int result = 0;
+    if (mode == "close") {
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            const QString title = QStringLiteral("Window%1").arg(i);
+            KonqClosedWindowItem *item = new KonqClosedWindowItem(title, manager->memoryStore(),
+                    undoManager->newCommandSerialNumber(), s_tabs);
+            writeWindowState(item->configGroup(), title);
+            undoManager->addClosedWindowItem(item);
+        }
+        const qint64 elapsed = timer.elapsed();
+        waitUntil([manager]() {
+            return manager->closedWindowItemList().isEmpty();
+        });
+        result = manager->closedWindowItemList().count();
+        std::cout << result << ' ' << elapsed << std::endl;
+    } else {
+        waitUntil([undoManager, count]() {
+            return undoManager->closedItemsList().count() >= count;
+        });
+        QObject::connect(undoManager, &KonqUndoManager::openClosedWindow, [&result](const KonqClosedWindowItem &item) {
+            if (isWindowStateComplete(item.configGroup(), item.title())) {
+                ++result;
+            }
+        });
+        timer.start();
+        while (!undoManager->closedItemsList().isEmpty()) {
+            undoManager->undoLastClosedItem();
+        }
+        std::cout << result << ' ' << timer.elapsed() << std::endl;
+    }
+
+    delete undoManager;
+    KonqClosedWindowsManager::destroy();
+    return 0;
+}
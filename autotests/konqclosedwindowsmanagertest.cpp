@@ -0,0 +1,156 @@
+/* This file is part of KDE
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <konqcloseditem.h>
+#include <konqclosedwindowsmanager.h>
+#include <konqsettingsxt.h>
+
+#include <KSharedConfig>
+#include <QDirIterator>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <qtest_gui.h>
+
+// Runs the closed windows managers of two processes on a private session
+// bus: windows closed in one of them are reopened in the other.
+class KonqClosedWindowsManagerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testSavedWindowsLoadedOnDemand();
+    void benchmarkCloseAndUndoWindows();
+
+private:
+    void startHelper(QProcess &process, const QString &dataDir, const QString &mode, int count);
+
+    QProcess m_bus;
+    QString m_busAddress;
+};
+
+QTEST_MAIN(KonqClosedWindowsManagerTest)
+
+void KonqClosedWindowsManagerTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    const QString dbusDaemon = QStandardPaths::findExecutable(QStringLiteral("dbus-daemon"));
+    if (dbusDaemon.isEmpty()) {
+        QSKIP("dbus-daemon not found");
+    }
+    m_bus.start(dbusDaemon, {QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address")});
+    QVERIFY(m_bus.waitForStarted());
+    QVERIFY(m_bus.waitForReadyRead());
+    m_busAddress = QString::fromLocal8Bit(m_bus.readLine()).trimmed();
+    QVERIFY(!m_busAddress.isEmpty());
+    // Before anything connects to the session bus
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_busAddress.toLocal8Bit());
+}
+
+void KonqClosedWindowsManagerTest::cleanupTestCase()
+{
+    if (m_bus.state() != QProcess::NotRunning) {
+        m_bus.terminate();
+        m_bus.waitForFinished();
+    }
+}
+
+void KonqClosedWindowsManagerTest::testSavedWindowsLoadedOnDemand()
+{
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir(dataDir + QLatin1String("/closedwindows")).removeRecursively();
+    QFile::remove(dataDir + QLatin1String("/closeditems_saved"));
+    KConfigGroup(KSharedConfig::openConfig(), "Undo").writeEntry("Number of Closed Windows", 0);
+
+    // GIVEN a window closed in a previous session
+    {
+        KonqClosedWindowsManager manager;
+        KonqClosedWindowItem *item = new KonqClosedWindowItem(QStringLiteral("Closed"), manager.memoryStore(), 1, 2);
+        item->configGroup().writeEntry("URL", "https://www.kde.org");
+        manager.addClosedWindowItem(nullptr, item);
+        QCOMPARE(QDir(dataDir + QLatin1String("/closedwindows")).entryList(QDir::Files).count(), 1);
+    }
+    // The state is kept for the next session
+    QCOMPARE(QDir(dataDir + QLatin1String("/closedwindows")).entryList(QDir::Files).count(), 1);
+
+    // WHEN starting again
+    KonqClosedWindowsManager manager;
+    const QList<KonqClosedWindowItem *> items = manager.closedWindowItemList();
+
+    // THEN only the summary is in memory, and the state is read when needed
+    QCOMPARE(items.count(), 1);
+    QCOMPARE(items.at(0)->title(), QStringLiteral("Closed"));
+    QCOMPARE(items.at(0)->numTabs(), 2);
+    QVERIFY(dynamic_cast<KonqClosedRemoteWindowItem *>(items.at(0)));
+    QVERIFY(manager.memoryStore()->groupList().isEmpty());
+    QCOMPARE(items.at(0)->configGroup().readEntry("URL", QString()), QStringLiteral("https://www.kde.org"));
+
+    // WHEN reopening it THEN its state is removed
+    KonqClosedWindowItem *item = items.at(0);
+    manager.removeClosedWindowItem(nullptr, item);
+    QCOMPARE(item->configGroup().readEntry("URL", QString()), QStringLiteral("https://www.kde.org"));
+    delete item;
+    manager.saveConfig();
+    QVERIFY(manager.closedWindowItemList().isEmpty());
+    QVERIFY(QDir(dataDir + QLatin1String("/closedwindows")).entryList(QDir::Files).isEmpty());
+}
+
+void KonqClosedWindowsManagerTest::startHelper(QProcess &process, const QString &dataDir, const QString &mode, int count)
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("DBUS_SESSION_BUS_ADDRESS"), m_busAddress);
+    env.insert(QStringLiteral("XDG_DATA_HOME"), dataDir + QLatin1String("/data"));
+    env.insert(QStringLiteral("XDG_CONFIG_HOME"), dataDir + QLatin1String("/config"));
+    env.insert(QStringLiteral("TMPDIR"), dataDir);
+    env.insert(QStringLiteral("QT_QPA_PLATFORM"), QStringLiteral("offscreen"));
+    process.setProcessEnvironment(env);
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(QCoreApplication::applicationDirPath() + QLatin1String("/konqclosedwindowshelper"),
+                  {mode, QString::number(count)});
+}
+
+void KonqClosedWindowsManagerTest::benchmarkCloseAndUndoWindows()
+{
+    const int count = 100;
+    QTemporaryDir dir;
+    QProcess closer, undoer;
+    startHelper(undoer, dir.path(), QStringLiteral("undo"), count);
+    QVERIFY(undoer.waitForReadyRead());
+    QCOMPARE(undoer.readLine().trimmed(), QByteArray("ready"));
+    startHelper(closer, dir.path(), QStringLiteral("close"), count);
+    QVERIFY(closer.waitForReadyRead());
+    QCOMPARE(closer.readLine().trimmed(), QByteArray("ready"));
+
+    QBENCHMARK_ONCE {
+        undoer.write("go\n");
+        closer.write("go\n");
+        QVERIFY(undoer.waitForFinished(30000));
+        QVERIFY(closer.waitForFinished(30000));
+    }
+    QCOMPARE(undoer.exitCode(), 0);
+    QCOMPARE(closer.exitCode(), 0);
+
+    // <windows left> <ms to close them all>
+    const QList<QByteArray> closed = closer.readAll().trimmed().split(' ');
+    QCOMPARE(closed.count(), 2);
+    QCOMPARE(closed.at(0).toInt(), 0);
+    // <windows reopened with their complete state> <ms to reopen them all>
+    const QList<QByteArray> undone = undoer.readAll().trimmed().split(' ');
+    QCOMPARE(undone.count(), 2);
+    QCOMPARE(undone.at(0).toInt(), count);
+    qDebug() << "Closing" << count << "windows took" << closed.at(1).toInt() << "ms, reopening them" << undone.at(1).toInt() << "ms";
+
+    // All the closed windows were reopened, nothing is left on disk
+    QDirIterator it(dir.path() + QLatin1String("/data"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString file = it.next();
+        QVERIFY2(!file.contains(QLatin1String("/closedwindows/")), qPrintable(file));
+    }
+}
+
+#include "konqclosedwindowsmanagertest.moc"
@@ -0,0 +1,152 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+#include <QWidget>
+#include <KSycoca>
+#include <kservice_version.h>
+#include <KParts/ReadOnlyPart>
+#include <konqfactory.h>
+
+class KonqFactoryTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testOffersCached();
+    void testCacheClearedWhenSycocaChanges();
+    void benchmarkCreateViews_data();
+    void benchmarkCreateViews();
+
+private:
+    QStringList m_mimeTypes;
+};
+
+QTEST_MAIN(KonqFactoryTest)
+
+void KonqFactoryTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    // Only the types which some part can show
+    const QStringList candidates = {
+        QStringLiteral("text/html"),
+        QStringLiteral("text/plain"),
+        QStringLiteral("inode/directory"),
+        QStringLiteral("image/png"),
+        QStringLiteral("application/pdf"),
+    };
+    for (const QString &mimeType : candidates) {
+        KService::List partOffers;
+        KonqFactory::getOffers(mimeType, &partOffers);
+        if (!partOffers.isEmpty()) {
+            m_mimeTypes.append(mimeType);
+        }
+    }
+    if (m_mimeTypes.isEmpty()) {
+        QSKIP("No part installed");
+    }
+    qDebug() << "Types with parts:" << m_mimeTypes;
+}
+
+void KonqFactoryTest::testOffersCached()
+{
+    KonqFactory::clearOffersCache();
+    const KonqFactory::OffersCacheStatistics before = KonqFactory::offersCacheStatistics();
+    QCOMPARE(before.serviceTypes, 0);
+    const QString mimeType = m_mimeTypes.first();
+
+    KService::List partOffers, appOffers;
+    KonqFactory::getOffers(mimeType, &partOffers, &appOffers);
+    KonqFactory::OffersCacheStatistics statistics = KonqFactory::offersCacheStatistics();
+    QCOMPARE(statistics.misses, before.misses + 1);
+    QCOMPARE(statistics.hits, before.hits);
+    QCOMPARE(statistics.serviceTypes, 1);
+    QVERIFY(!partOffers.isEmpty());
+
+    KService::List cachedPartOffers, cachedAppOffers;
+    KonqFactory::getOffers(mimeType, &cachedPartOffers, &cachedAppOffers);
+    statistics = KonqFactory::offersCacheStatistics();
+    QCOMPARE(statistics.misses, before.misses + 1);
+    QCOMPARE(statistics.hits, before.hits + 1);
+    QCOMPARE(cachedPartOffers, partOffers);
+    QCOMPARE(cachedAppOffers, appOffers);
+
+    // The view picks the first part, as without the cache
+    KService::Ptr service;
+    KonqFactory konqFactory;
+    const KonqViewFactory viewFactory = konqFactory.createView(mimeType, QString(), &service, nullptr, nullptr, true);
+    QVERIFY(!viewFactory.isNull());
+    QCOMPARE(service->storageId(), partOffers.first()->storageId());
+    QCOMPARE(KonqFactory::offersCacheStatistics().hits, before.hits + 2);
+}
+
+void KonqFactoryTest::testCacheClearedWhenSycocaChanges()
+{
+    KService::List partOffers;
+    KonqFactory::getOffers(m_mimeTypes.first(), &partOffers);
+    const KonqFactory::OffersCacheStatistics before = KonqFactory::offersCacheStatistics();
+    QVERIFY(before.serviceTypes > 0);
+
+    // What kbuildsycoca announces when desktop files or file associations changed
+#if KSERVICE_VERSION >= QT_VERSION_CHECK(5, 80, 0)
+    Q_EMIT KSycoca::self()->databaseChanged();
+#else
+    Q_EMIT KSycoca::self()->databaseChanged(QStringList{QStringLiteral("services")});
+#endif
+    KonqFactory::OffersCacheStatistics statistics = KonqFactory::offersCacheStatistics();
+    QCOMPARE(statistics.serviceTypes, 0);
+    QCOMPARE(statistics.invalidations, before.invalidations + 1);
+
+    KonqFactory::getOffers(m_mimeTypes.first(), &partOffers);
+    statistics = KonqFactory::offersCacheStatistics();
+    QCOMPARE(statistics.misses, before.misses + 1);
+    QCOMPARE(statistics.serviceTypes, 1);
+}
+
+void KonqFactoryTest::benchmarkCreateViews_data()
+{
+    QTest::addColumn<bool>("mixed");
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("same, uncached") << false << false;
+    QTest::newRow("same, cached") << false << true;
+    QTest::newRow("mixed, uncached") << true << false;
+    QTest::newRow("mixed, cached") << true << true;
+}
+
+void KonqFactoryTest::benchmarkCreateViews()
+{
+    QFETCH(bool, mixed);
+    QFETCH(bool, cached);
+    const int viewCount = 500;
+
+    QWidget parentWidget;
+    KonqFactory konqFactory;
+    KonqFactory::clearOffersCache();
+    const KonqFactory::OffersCacheStatistics before = KonqFactory::offersCacheStatistics();
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < viewCount; ++i) {
+            if (!cached) {
+                KonqFactory::clearOffersCache();
+            }
+            const QString &mimeType = mixed ? m_mimeTypes.at(i % m_mimeTypes.count()) : m_mimeTypes.first();
+            KService::Ptr service;
+            KService::List partServiceOffers, appServiceOffers;
+            KonqViewFactory viewFactory = konqFactory.createView(mimeType, QString(), &service, &partServiceOffers, &appServiceOffers, true);
+            QVERIFY(!viewFactory.isNull());
+            delete viewFactory.create(&parentWidget, nullptr);
+        }
+    }
+    const KonqFactory::OffersCacheStatistics statistics = KonqFactory::offersCacheStatistics();
+    qDebug() << "Offers cache hits:" << statistics.hits - before.hits << "misses:" << statistics.misses - before.misses;
+    if (cached) {
+        QCOMPARE(statistics.misses - before.misses, mixed ? m_mimeTypes.count() : 1);
+    }
+}
+
+#include "konqfactorytest.moc"
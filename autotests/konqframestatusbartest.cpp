@@ -0,0 +1,253 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QProgressBar>
+#include <QScreen>
+#include <QSignalSpy>
+#include <QtMath>
+#include <KLocalizedString>
+#include <konqframe.h>
+#include <konqframestatusbar.h>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqstatusbarmessagelabel.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include <konqviewmetrics.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+/**
+ * Counts the paint events received by a widget and its children.
+ */
+class PaintCounter : public QObject
+{
+public:
+    explicit PaintCounter(QWidget *widget)
+        : m_widget(widget), m_count(0)
+    {
+        qApp->installEventFilter(this);
+    }
+
+    int count() const
+    {
+        return m_count;
+    }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint && watched->isWidgetType()
+            && (watched == m_widget || m_widget->isAncestorOf(static_cast<QWidget *>(watched)))) {
+            ++m_count;
+        }
+        return false;
+    }
+
+private:
+    QWidget *m_widget;
+    int m_count;
+};
+
+class KonqFrameStatusBarTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testLastValueShown();
+    void testErrorShownAtOnce();
+    void testUpdatesOncePerFrame();
+    void benchmarkStreamedPage_data();
+    void benchmarkStreamedPage();
+
+private:
+    static KonqFrameStatusBar *statusBar(KonqMainWindow *mainWindow);
+    static int frameInterval(QWidget *widget);
+
+    // Streams the pages a small chunk at a time, as real servers do
+    TestHttpServer m_server{1024};
+};
+
+QTEST_MAIN(KonqFrameStatusBarTest)
+
+void KonqFrameStatusBarTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    QVERIFY(m_server.listen(QHostAddress::LocalHost));
+
+    m_server.addFile(QStringLiteral("/empty.html"), "text/html", "<html><body></body></html>");
+    // Pages of many scripts and images, as news sites are
+    for (int resources : {10, 100, 500}) {
+        QByteArray page = "<html><head><title>" + QByteArray::number(resources) + " resources</title>";
+        for (int i = 0; i < resources; ++i) {
+            const QString script = QStringLiteral("/%1/script%2.js").arg(resources).arg(i);
+            m_server.addFile(script, "application/javascript", "var x" + QByteArray::number(i) + " = '" + QByteArray(8192, 'x') + "';");
+            page += "<script src=\"" + script.toLatin1() + "\"></script>";
+        }
+        page += "</head><body>";
+        for (int i = 0; i < resources; ++i) {
+            const QString image = QStringLiteral("/%1/image%2.svg").arg(resources).arg(i);
+            m_server.addFile(image, "image/svg+xml", "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\"><!--"
+                             + QByteArray(8192, ' ') + "--></svg>");
+            page += "<img src=\"" + image.toLatin1() + "\">";
+        }
+        // And a long article
+        for (int i = 0; i < 2000; ++i) {
+            page += "<p>Paragraph " + QByteArray::number(i) + "</p>";
+        }
+        page += "</body></html>";
+        m_server.addFile(QStringLiteral("/%1.html").arg(resources), "text/html", page);
+    }
+}
+
+KonqFrameStatusBar *KonqFrameStatusBarTest::statusBar(KonqMainWindow *mainWindow)
+{
+    return mainWindow->currentView()->frame()->statusbar();
+}
+
+int KonqFrameStatusBarTest::frameInterval(QWidget *widget)
+{
+    const QScreen *screen = widget->window()->windowHandle() ? widget->window()->windowHandle()->screen() : QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60;
+    return qCeil(1000 / refreshRate);
+}
+
+void KonqFrameStatusBarTest::testLastValueShown()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, m_server.url(QStringLiteral("/empty.html")), QStringLiteral("text/html"));
+    QSignalSpy spyCompleted(mainWindow.currentView(), SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+
+    KonqFrameStatusBar *bar = statusBar(&mainWindow);
+    QProgressBar *progressBar = bar->findChild<QProgressBar *>();
+    KonqStatusBarMessageLabel *label = bar->findChild<KonqStatusBarMessageLabel *>();
+    QVERIFY(progressBar);
+    QVERIFY(label);
+
+    for (int i = 0; i < 1000; ++i) {
+        bar->slotLoadingProgress(i % 99);
+        bar->slotSpeedProgress(i * 1024);
+    }
+    bar->slotDisplayStatusText(QStringLiteral("Done"));
+    // Nothing is shown before the next frame...
+    QVERIFY(label->text() != QLatin1String("Done"));
+    // ...and then only the last values
+    QTRY_COMPARE(label->text(), QStringLiteral("Done"));
+    QVERIFY(progressBar->isVisible());
+    QCOMPARE(progressBar->value(), 999 % 99);
+
+    // The speed replaces the message, and the other way round
+    bar->slotDisplayStatusText(QStringLiteral("Loading"));
+    bar->slotSpeedProgress(0);
+    bar->slotLoadingProgress(100);
+    QTRY_COMPARE(label->text(), i18n("Stalled"));
+    QVERIFY(!progressBar->isVisible());
+}
+
+void KonqFrameStatusBarTest::testErrorShownAtOnce()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, m_server.url(QStringLiteral("/empty.html")), QStringLiteral("text/html"));
+    QSignalSpy spyCompleted(mainWindow.currentView(), SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+
+    KonqFrameStatusBar *bar = statusBar(&mainWindow);
+    KonqStatusBarMessageLabel *label = bar->findChild<KonqStatusBarMessageLabel *>();
+    QVERIFY(label);
+    bar->slotDisplayStatusText(QStringLiteral("Loading"));
+    bar->setMessage(QStringLiteral("Connection refused"), KonqStatusBarMessageLabel::Error);
+    QCOMPARE(label->type(), KonqStatusBarMessageLabel::Error);
+    QCOMPARE(label->text(), QStringLiteral("Connection refused"));
+}
+
+void KonqFrameStatusBarTest::testUpdatesOncePerFrame()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, m_server.url(QStringLiteral("/empty.html")), QStringLiteral("text/html"));
+    QSignalSpy spyCompleted(mainWindow.currentView(), SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+    QTest::qWait(100);
+
+    KonqFrameStatusBar *bar = statusBar(&mainWindow);
+    KonqStatusBarMessageLabel *label = bar->findChild<KonqStatusBarMessageLabel *>();
+    QVERIFY(label);
+    PaintCounter counter(label);
+    QElapsedTimer timer;
+    timer.start();
+    // A fast local copy: progress as often as the event loop allows
+    for (int i = 0; i < 20000; ++i) {
+        bar->slotSpeedProgress(i * 1024);
+        QCoreApplication::processEvents();
+    }
+    QTest::qWait(100);
+    const qint64 elapsed = timer.elapsed();
+
+    qDebug() << "Paint events of the label in" << elapsed << "ms:" << counter.count();
+    // The label may need more than one paint for an update, but far from one per progress
+    QVERIFY(counter.count() > 0);
+    QVERIFY2(counter.count() <= 2 * (elapsed / frameInterval(bar) + 1), qPrintable(QString::number(counter.count())));
+}
+
+void KonqFrameStatusBarTest::benchmarkStreamedPage_data()
+{
+    QTest::addColumn<int>("resources");
+
+    QTest::newRow("10 resources") << 10;
+    QTest::newRow("100 resources") << 100;
+    QTest::newRow("500 resources") << 500;
+}
+
+void KonqFrameStatusBarTest::benchmarkStreamedPage()
+{
+    QFETCH(int, resources);
+
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, m_server.url(QStringLiteral("/empty.html")), QStringLiteral("text/html"));
+    QSignalSpy spyEmpty(mainWindow.currentView(), SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyEmpty.wait(20000));
+    // Two visible frames, both with a status bar
+    KonqView *view = mainWindow.currentView();
+    KonqView *otherView = mainWindow.viewManager()->splitView(view, Qt::Horizontal);
+    QVERIFY(otherView);
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+    QTest::qWait(100);
+
+    PaintCounter counter(view->frame()->statusbar());
+    PaintCounter otherCounter(otherView->frame()->statusbar());
+    const qint64 cpuTimeBefore = KonqViewMetrics::cpuTime();
+    QElapsedTimer timer;
+    timer.start();
+
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    const QUrl url = m_server.url(QStringLiteral("/%1.html").arg(resources));
+    view->openUrl(url, url.toDisplayString());
+    QVERIFY(spyCompleted.wait(60000));
+    // Let the last frame be painted
+    QTest::qWait(100);
+
+    const qint64 elapsed = timer.elapsed();
+    const qint64 cpuTime = KonqViewMetrics::cpuTime() - cpuTimeBefore;
+    const int paintEvents = counter.count() + otherCounter.count();
+    qDebug() << "Loading" << resources << "resources took" << elapsed << "ms," << cpuTime << "ms of CPU time in this process,"
+             << paintEvents << "paint events of the status bars";
+    QTest::setBenchmarkResult(paintEvents, QTest::Events);
+}
+
+#include "konqframestatusbartest.moc"
@@ -0,0 +1,178 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QCoreApplication>
+#include <konqhibernator.h>
+#include <konqmainwindow.h>
+#include <konqtabs.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include "konqtesthelpers.h"
+
+class KonqHibernatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testHibernateAndWakeUp();
+    void testMemoryBudgetCountsRenderers();
+
+private:
+    QUrl writePage(const QString &name);
+    static void openAndWait(KonqView *view, const QUrl &url);
+
+    QTemporaryDir m_tempDir;
+};
+
+QTEST_MAIN(KonqHibernatorTest)
+
+static const int s_tabCount = 50;
+
+void KonqHibernatorTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_tempDir.isValid());
+}
+
+QUrl KonqHibernatorTest::writePage(const QString &name)
+{
+    QFile file(m_tempDir.filePath(name + QStringLiteral(".html")));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("<html><head><title>" + name.toUtf8() + "</title></head><body>");
+        // Some content, so that hibernating makes a difference
+        for (int i = 0; i < 200; ++i) {
+            file.write("<p>" + name.toUtf8() + " paragraph " + QByteArray::number(i) + "</p>");
+        }
+        file.write("</body></html>");
+    }
+    return QUrl::fromLocalFile(file.fileName());
+}
+
+void KonqHibernatorTest::openAndWait(KonqView *view, const QUrl &url)
+{
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    view->openUrl(url, url.toDisplayString());
+    QVERIFY(spyCompleted.wait(10000));
+}
+
+void KonqHibernatorTest::testHibernateAndWakeUp()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    KonqView *currentView = mainWindow.currentView();
+    QVERIFY(currentView);
+    KonqViewManager *viewManager = mainWindow.viewManager();
+
+    // Each tab visits two pages, so that it has some history to preserve
+    QVector<KonqView *> views;
+    QVector<QUrl> firstUrls, secondUrls;
+    for (int i = 0; i < s_tabCount; ++i) {
+        const QUrl first = writePage(QStringLiteral("first%1").arg(i));
+        const QUrl second = writePage(QStringLiteral("second%1").arg(i));
+        KonqView *view = viewManager->addTab(QStringLiteral("text/html"));
+        QVERIFY(view);
+        openAndWait(view, first);
+        openAndWait(view, second);
+        QCOMPARE(view->historyLength(), 2);
+        views.append(view);
+        firstUrls.append(first);
+        secondUrls.append(second);
+    }
+    viewManager->tabContainer()->setCurrentIndex(0);
+    QTRY_COMPARE(mainWindow.currentView(), currentView);
+
+    const qint64 memoryBefore = KonqHibernator::residentMemory();
+    const int hibernated = KonqHibernator::self()->hibernateViews(0);
+    QCOMPARE(hibernated, s_tabCount);
+    QVERIFY(!currentView->isHibernated());
+    for (int i = 0; i < s_tabCount; ++i) {
+        QVERIFY(views.at(i)->isHibernated());
+        // What the tab shows doesn't change
+        QCOMPARE(views.at(i)->url(), secondUrls.at(i));
+        QCOMPARE(views.at(i)->historyLength(), 2);
+    }
+    // Memory of the QtWebEngine renderers isn't included, they are separate processes
+    qDebug() << "Resident memory before:" << memoryBefore / 1024 << "KiB, after:" << KonqHibernator::residentMemory() / 1024 << "KiB";
+    qDebug() << "With the renderers, after:" << KonqHibernator::self()->viewsMemory() / 1024 << "KiB";
+
+    // Hibernated views can't be hibernated again, and the current view never is
+    QCOMPARE(KonqHibernator::self()->hibernateViews(0), 0);
+
+    for (int i = 0; i < s_tabCount; ++i) {
+        KonqView *view = views.at(i);
+        viewManager->tabContainer()->setCurrentIndex(i + 1);
+        QTRY_COMPARE(mainWindow.currentView(), view);
+        QVERIFY(!view->isHibernated());
+        QTRY_COMPARE(view->url(), secondUrls.at(i));
+        QCOMPARE(view->historyLength(), 2);
+        QCOMPARE(view->historyIndex(), 1);
+
+        // The history is still usable
+        view->go(-1);
+        QTRY_COMPARE(view->url(), firstUrls.at(i));
+        QCOMPARE(view->historyIndex(), 0);
+    }
+}
+
+static const qint64 s_rendererMemory = 100 * 1024 * 1024;
+
+// This process is free, renderers all use the same amount of memory
+static qint64 fakeResidentMemory(qint64 pid)
+{
+    return pid == QCoreApplication::applicationPid() ? 0 : s_rendererMemory;
+}
+
+void KonqHibernatorTest::testMemoryBudgetCountsRenderers()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    KonqView *currentView = mainWindow.currentView();
+    QVERIFY(currentView);
+    KonqViewManager *viewManager = mainWindow.viewManager();
+
+    QVector<KonqView *> views;
+    for (int i = 0; i < 4; ++i) {
+        KonqView *view = viewManager->addTab(QStringLiteral("text/html"));
+        QVERIFY(view);
+        openAndWait(view, writePage(QStringLiteral("budget%1").arg(i)));
+        views.append(view);
+    }
+    viewManager->tabContainer()->setCurrentIndex(0);
+    QTRY_COMPARE(mainWindow.currentView(), currentView);
+
+    // The current view is rendered by this process, the first two tabs share
+    // a renderer, the others have their own
+    const qint64 ownPid = QCoreApplication::applicationPid();
+    currentView->part()->setProperty("konqRendererPid", ownPid);
+    views.at(0)->part()->setProperty("konqRendererPid", ownPid + 1);
+    views.at(1)->part()->setProperty("konqRendererPid", ownPid + 1);
+    views.at(2)->part()->setProperty("konqRendererPid", ownPid + 2);
+    views.at(3)->part()->setProperty("konqRendererPid", ownPid + 3);
+
+    KonqHibernator *hibernator = KonqHibernator::self();
+    hibernator->setResidentMemoryFunction(&fakeResidentMemory);
+    QCOMPARE(hibernator->viewsMemory(), 3 * s_rendererMemory);
+
+    // Half of the memory has to go: half of the 5 live views, rounded up
+    QCOMPARE(hibernator->hibernateViews(-1, 3 * s_rendererMemory / 2), 3);
+    QVERIFY(!currentView->isHibernated());
+    QVERIFY(views.at(0)->isHibernated());
+    QVERIFY(views.at(1)->isHibernated());
+    QVERIFY(views.at(2)->isHibernated());
+    QVERIFY(!views.at(3)->isHibernated());
+    // Hibernated views don't have a renderer anymore
+    QCOMPARE(hibernator->viewsMemory(), s_rendererMemory);
+
+    hibernator->setResidentMemoryFunction(nullptr);
+}
+
+#include "konqhibernatortest.moc"
@@ -0,0 +1,176 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <KXMLGUIFactory>
+#include <KParts/ReadOnlyPart>
+#include <konq_kpart_plugin.h>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include "../src/konqsettingsxt.h"
+
+class KonqMainWindowTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testPluginsLoadedWhenShown();
+    void testPluginsOfBackgroundTabLoadedWhenShown();
+    void testPluginsLoadedAfterPageGetCompleted();
+    void benchmarkWindowCreation_data();
+    void benchmarkWindowCreation();
+
+private:
+    void openPage(KonqMainWindow &mainWindow);
+};
+
+QTEST_MAIN(KonqMainWindowTest)
+
+void KonqMainWindowTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    KonqSettings::setPooledBrowserParts(0);
+
+    // All the stock plugins, including those disabled by default
+    KConfigGroup group(KSharedConfig::openConfig(QStringLiteral("webenginepartrc")), "KParts Plugins");
+    const QStringList pluginIds = {
+        QStringLiteral("searchbar"),
+        QStringLiteral("UserAgentChanger"),
+        QStringLiteral("babelfish"),
+        QStringLiteral("konqueror_kget_browser_integration"),
+        QStringLiteral("konqfeedicon"),
+        QStringLiteral("autorefresh"),
+        QStringLiteral("DirFilter"),
+    };
+    for (const QString &pluginId : pluginIds) {
+        group.writeEntry(pluginId + QLatin1String("Enabled"), true);
+    }
+    group.sync();
+}
+
+void KonqMainWindowTest::openPage(KonqMainWindow &mainWindow)
+{
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QVERIFY(view->part());
+}
+
+void KonqMainWindowTest::testPluginsLoadedWhenShown()
+{
+    KonqMainWindow mainWindow;
+    openPage(mainWindow);
+    KonqView *view = mainWindow.currentView();
+    // Nothing is loaded before the window is shown
+    QCOMPARE(view->pluginCount(), 0);
+
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+    QTRY_VERIFY(view->pluginCount() > 0);
+
+    // and the plugins are merged into the GUI of the window
+    const QList<KonqParts::Plugin *> plugins = KonqParts::Plugin::pluginObjects(view->part());
+    for (KonqParts::Plugin *plugin : plugins) {
+        QCOMPARE(plugin->factory(), mainWindow.guiFactory());
+    }
+}
+
+void KonqMainWindowTest::testPluginsOfBackgroundTabLoadedWhenShown()
+{
+    KonqMainWindow mainWindow;
+    openPage(mainWindow);
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+    KonqView *currentView = mainWindow.currentView();
+    QTRY_VERIFY(currentView->pluginCount() > 0);
+
+    KonqView *view = mainWindow.viewManager()->addTab(QStringLiteral("text/html"));
+    QVERIFY(view);
+    QVERIFY(view != mainWindow.currentView());
+    // A background tab doesn't load them, however long it waits
+    QTest::qWait(1500);
+    QCOMPARE(view->pluginCount(), 0);
+
+    // Switching to the tab loads and merges them
+    mainWindow.viewManager()->showTab(view);
+    QCOMPARE(mainWindow.currentView(), view);
+    QTRY_COMPARE(view->pluginCount(), currentView->pluginCount());
+    const QList<KonqParts::Plugin *> plugins = KonqParts::Plugin::pluginObjects(view->part());
+    for (KonqParts::Plugin *plugin : plugins) {
+        QCOMPARE(plugin->factory(), mainWindow.guiFactory());
+    }
+}
+
+void KonqMainWindowTest::testPluginsLoadedAfterPageGetCompleted()
+{
+    KonqMainWindow mainWindow;
+    openPage(mainWindow);
+    KonqView *view = mainWindow.currentView();
+    QSignalSpy spyViewCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyViewCompleted.wait(20000));
+    QCOMPARE(view->pluginCount(), 0);
+
+    // The plugins, e.g. the feed icon, only update when the page completes
+    QSignalSpy spyPartCompleted(view->part(), SIGNAL(completed()));
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+    QTRY_VERIFY(view->pluginCount() > 0);
+    QCOMPARE(spyPartCompleted.count(), 1);
+    // but the view itself doesn't load the page again
+    QCOMPARE(spyViewCompleted.count(), 1);
+    QVERIFY(!view->isLoading());
+}
+
+void KonqMainWindowTest::benchmarkWindowCreation_data()
+{
+    QTest::addColumn<bool>("deferred");
+
+    QTest::newRow("plugins loaded before showing") << false;
+    QTest::newRow("plugins loaded once shown") << true;
+}
+
+void KonqMainWindowTest::benchmarkWindowCreation()
+{
+    QFETCH(bool, deferred);
+    const int windowCount = 10;
+
+    // The first window loads the libraries, which only happens once
+    {
+        KonqMainWindow mainWindow;
+        openPage(mainWindow);
+        mainWindow.currentView()->loadPlugins();
+    }
+
+    qint64 total = 0;
+    for (int i = 0; i < windowCount; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        KonqMainWindow mainWindow;
+        openPage(mainWindow);
+        KonqView *view = mainWindow.currentView();
+        if (!deferred) {
+            // As before, when the part was created with its plugins
+            view->loadPlugins();
+        }
+        mainWindow.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+        total += timer.elapsed();
+        QTRY_VERIFY(view->pluginCount() > 0);
+    }
+    qDebug() << "Average time to show a window:" << total / windowCount << "ms";
+    QTest::setBenchmarkResult(total / qreal(windowCount), QTest::WalltimeMilliseconds);
+}
+
+#include "konqmainwindowtest.moc"
@@ -0,0 +1,312 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <konqfactory.h>
+#include <konqhibernator.h>
+#include <konqmainwindow.h>
+#include <konqmemorypressurehandler.h>
+#include <konqmimetypecache.h>
+#include <konqpartpool.h>
+#include <konqpixmapprovider.h>
+#include <konqsessionmanager.h>
+#include <konqtabs.h>
+#include <konqundomanager.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+class KonqMemoryPressureTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void testLevelFromPressureStall_data();
+    void testLevelFromPressureStall();
+    void testCachesShrink();
+    void testCriticalPressureHibernatesBackgroundViews();
+    void testCgroupEvents();
+    void benchmarkResidentMemory_data();
+    void benchmarkResidentMemory();
+
+private:
+    QUrl writePage(const QString &name);
+    static void openAndWait(KonqView *view, const QUrl &url);
+    static void fillCaches();
+    static bool iconsRenderedAgain();
+    static qint64 totalResidentMemory();
+    void openTabs(KonqMainWindow &mainWindow, int count);
+
+    QTemporaryDir m_tempDir;
+};
+
+QTEST_MAIN(KonqMemoryPressureTest)
+
+static const int s_tabCount = 10;
+
+void KonqMemoryPressureTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    KonqSettings::setPooledBrowserParts(2);
+    QVERIFY(m_tempDir.isValid());
+    // Only the simulated pressure counts
+    KonqMemoryPressureHandler::self()->stopMonitoring();
+}
+
+void KonqMemoryPressureTest::init()
+{
+    KonqMemoryPressureHandler::self()->pressureReported(KonqMemoryPressureHandler::NoPressure);
+}
+
+QUrl KonqMemoryPressureTest::writePage(const QString &name)
+{
+    QFile file(m_tempDir.filePath(name + QStringLiteral(".html")));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("<html><head><title>" + name.toUtf8() + "</title></head><body>");
+        // Some content, so that hibernating makes a difference
+        for (int i = 0; i < 200; ++i) {
+            file.write("<p>" + name.toUtf8() + " paragraph " + QByteArray::number(i) + "</p>");
+        }
+        file.write("</body></html>");
+    }
+    return QUrl::fromLocalFile(file.fileName());
+}
+
+void KonqMemoryPressureTest::openAndWait(KonqView *view, const QUrl &url)
+{
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    view->openUrl(url, url.toDisplayString());
+    QVERIFY(spyCompleted.wait(20000));
+}
+
+void KonqMemoryPressureTest::openTabs(KonqMainWindow &mainWindow, int count)
+{
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    QSignalSpy spyCompleted(mainWindow.currentView(), SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    for (int i = 0; i < count; ++i) {
+        KonqView *view = mainWindow.viewManager()->addTab(QStringLiteral("text/html"));
+        QVERIFY(view);
+        openAndWait(view, writePage(QStringLiteral("page%1").arg(i)));
+    }
+}
+
+void KonqMemoryPressureTest::fillCaches()
+{
+    for (int i = 0; i < 100; ++i) {
+        const QUrl url(QStringLiteral("http://host%1.example.org/index.html").arg(i));
+        KonqMimeTypeCache::self()->record(url, QStringLiteral("text/html"));
+        KonqPixmapProvider::self()->pixmapFor(url.toString(), 16);
+    }
+    KonqFactory::getOffers(QStringLiteral("text/html"));
+    KonqFactory::getOffers(QStringLiteral("text/plain"));
+    KonqPartPool::self()->refill();
+}
+
+// Whether the icons filled by fillCaches() had to be rendered again
+bool KonqMemoryPressureTest::iconsRenderedAgain()
+{
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    const int misses = provider->statistics().cacheMisses;
+    provider->pixmapFor(QStringLiteral("http://host0.example.org/index.html"), 16);
+    return provider->statistics().cacheMisses > misses;
+}
+
+// This process and the renderers of its views
+qint64 KonqMemoryPressureTest::totalResidentMemory()
+{
+    QSet<qint64> pids{QCoreApplication::applicationPid()};
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    if (windows) {
+        for (KonqMainWindow *window : qAsConst(*windows)) {
+            for (KonqView *view : window->viewMap()) {
+                pids.insert(view->metrics().value(QStringLiteral("rendererPid")).toLongLong());
+            }
+        }
+    }
+    qint64 memory = 0;
+    for (qint64 pid : qAsConst(pids)) {
+        memory += KonqHibernator::residentMemory(pid);
+    }
+    return memory;
+}
+
+void KonqMemoryPressureTest::testLevelFromPressureStall_data()
+{
+    QTest::addColumn<QByteArray>("contents");
+    QTest::addColumn<int>("level");
+
+    QTest::newRow("idle") << QByteArray("some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+                                         "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n")
+                          << int(KonqMemoryPressureHandler::NoPressure);
+    QTest::newRow("some stalls") << QByteArray("some avg10=23.51 avg60=8.12 avg300=1.02 total=2841921\n"
+                                               "full avg10=1.20 avg60=0.40 avg300=0.05 total=120391\n")
+                                 << int(KonqMemoryPressureHandler::ModeratePressure);
+    QTest::newRow("full stalls") << QByteArray("some avg10=61.00 avg60=30.00 avg300=9.00 total=9841921\n"
+                                               "full avg10=42.00 avg60=20.00 avg300=6.00 total=7120391\n")
+                                 << int(KonqMemoryPressureHandler::CriticalPressure);
+    QTest::newRow("garbage") << QByteArray("not a PSI file") << int(KonqMemoryPressureHandler::NoPressure);
+}
+
+void KonqMemoryPressureTest::testLevelFromPressureStall()
+{
+    QFETCH(QByteArray, contents);
+    QFETCH(int, level);
+    QCOMPARE(int(KonqMemoryPressureHandler::levelFromPressureStall(contents)), level);
+}
+
+void KonqMemoryPressureTest::testCachesShrink()
+{
+    KonqMemoryPressureHandler *handler = KonqMemoryPressureHandler::self();
+    MyKonqMainWindow mainWindow;
+    openTabs(mainWindow, 3);
+    // Closed tabs, the last one is kept
+    KonqViewManager *viewManager = mainWindow.viewManager();
+    const int closedItems = mainWindow.undoManager()->closedItemsList().count();
+    for (int i = 0; i < 2; ++i) {
+        viewManager->removeTab(viewManager->tabContainer()->tabAt(1));
+    }
+    QCOMPARE(mainWindow.undoManager()->closedItemsList().count(), closedItems + 2);
+    fillCaches();
+    QCOMPARE(KonqPartPool::self()->count(), 2);
+    QVERIFY(KonqMimeTypeCache::self()->statistics().entries > 0);
+    QVERIFY(KonqFactory::offersCacheStatistics().serviceTypes > 0);
+    QVERIFY(KonqPixmapProvider::self()->count() > 0);
+
+    // Moderate pressure releases one thing after the other, the cheapest first
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::ModeratePressure), 1);
+    QCOMPARE(KonqPartPool::self()->count(), 0);
+    QVERIFY(KonqMimeTypeCache::self()->statistics().entries > 0);
+
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::ModeratePressure), 1);
+    QCOMPARE(KonqMimeTypeCache::self()->statistics().entries, 0);
+    QCOMPARE(KonqFactory::offersCacheStatistics().serviceTypes, 0);
+    const int iconCount = KonqPixmapProvider::self()->count();
+    QVERIFY(iconCount > 0);
+
+    // The icons are rendered again, but the favicons of the URLs are kept
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::ModeratePressure), 1);
+    QCOMPARE(KonqPixmapProvider::self()->count(), iconCount);
+    QVERIFY(iconsRenderedAgain());
+
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::ModeratePressure), 1);
+    QCOMPARE(mainWindow.undoManager()->closedItemsList().count(), closedItems + 1);
+
+    // Nothing but views is left, and moderate pressure doesn't touch them
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::ModeratePressure), 0);
+    for (KonqView *view : mainWindow.viewMap()) {
+        QVERIFY(!view->isHibernated());
+    }
+
+    // Once the pressure is over, it all starts again
+    fillCaches();
+    handler->pressureReported(KonqMemoryPressureHandler::NoPressure);
+    QCOMPARE(handler->nextStep(), KonqMemoryPressureHandler::ReleasePartPool);
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::ModeratePressure), 1);
+    QCOMPARE(KonqPartPool::self()->count(), 0);
+}
+
+void KonqMemoryPressureTest::testCriticalPressureHibernatesBackgroundViews()
+{
+    KonqMemoryPressureHandler *handler = KonqMemoryPressureHandler::self();
+    MyKonqMainWindow mainWindow;
+    mainWindow.show();
+    openTabs(mainWindow, s_tabCount);
+    KonqView *currentView = mainWindow.currentView();
+    fillCaches();
+
+    // All the caches at once, and the views not shown for a while: none yet
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::CriticalPressure), 5);
+    QCOMPARE(KonqPartPool::self()->count(), 0);
+    QCOMPARE(KonqMimeTypeCache::self()->statistics().entries, 0);
+    QVERIFY(KonqPixmapProvider::self()->count() > 0);
+    QVERIFY(iconsRenderedAgain());
+    for (KonqView *view : mainWindow.viewMap()) {
+        QVERIFY(!view->isHibernated());
+    }
+
+    // Then the other views
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::CriticalPressure), 1);
+    for (KonqView *view : mainWindow.viewMap()) {
+        QCOMPARE(view->isHibernated(), view != currentView);
+    }
+
+    // Views opened meanwhile go too
+    KonqView *newView = mainWindow.viewManager()->addTab(QStringLiteral("text/html"));
+    openAndWait(newView, writePage(QStringLiteral("late")));
+    QCOMPARE(handler->pressureReported(KonqMemoryPressureHandler::CriticalPressure), 1);
+    QVERIFY(newView->isHibernated());
+    QVERIFY(!currentView->isHibernated());
+}
+
+void KonqMemoryPressureTest::testCgroupEvents()
+{
+    KonqMemoryPressureHandler *handler = KonqMemoryPressureHandler::self();
+    const QString path = m_tempDir.filePath(QStringLiteral("memory.events"));
+    auto writeEvents = [&path](int high, int max) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("low 0\nhigh " + QByteArray::number(high) + "\nmax " + QByteArray::number(max) + "\noom 0\noom_kill 0\n");
+    };
+    writeEvents(0, 0);
+    QVERIFY(handler->monitorCgroupEvents(path));
+    QSignalSpy spyReleased(handler, &KonqMemoryPressureHandler::memoryReleased);
+
+    writeEvents(3, 0);
+    QVERIFY(spyReleased.wait(5000));
+    QCOMPARE(spyReleased.last().at(0).value<KonqMemoryPressureHandler::Level>(), KonqMemoryPressureHandler::ModeratePressure);
+    QCOMPARE(handler->nextStep(), KonqMemoryPressureHandler::ClearLookupCaches);
+
+    writeEvents(3, 1);
+    QVERIFY(spyReleased.wait(5000));
+    QCOMPARE(spyReleased.last().at(0).value<KonqMemoryPressureHandler::Level>(), KonqMemoryPressureHandler::CriticalPressure);
+
+    handler->stopMonitoring();
+}
+
+void KonqMemoryPressureTest::benchmarkResidentMemory_data()
+{
+    QTest::addColumn<bool>("pressure");
+
+    QTest::newRow("no pressure") << false;
+    QTest::newRow("after critical pressure") << true;
+}
+
+void KonqMemoryPressureTest::benchmarkResidentMemory()
+{
+    QFETCH(bool, pressure);
+#ifndef Q_OS_LINUX
+    QSKIP("The resident memory is only known on Linux");
+#endif
+
+    MyKonqMainWindow mainWindow;
+    mainWindow.show();
+    openTabs(mainWindow, s_tabCount);
+    fillCaches();
+    const qint64 before = totalResidentMemory();
+
+    if (pressure) {
+        KonqMemoryPressureHandler *handler = KonqMemoryPressureHandler::self();
+        handler->pressureReported(KonqMemoryPressureHandler::CriticalPressure);
+        handler->pressureReported(KonqMemoryPressureHandler::CriticalPressure);
+        // Renderers take a moment to exit
+        QTest::qWait(2000);
+    }
+    const qint64 after = totalResidentMemory();
+
+    qDebug() << "Resident memory of Konqueror and its renderers before:" << before / 1024 << "KiB, after:" << after / 1024 << "KiB";
+    QTest::setBenchmarkResult(after, QTest::BytesAllocated);
+}
+
+#include "konqmemorypressuretest.moc"
@@ -0,0 +1,274 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QElapsedTimer>
+#include <QMimeDatabase>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <KIO/MimetypeJob>
+#include <konqmimetypecache.h>
+#include <konqsessionmanager.h>
+#include <urlloader.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+class KonqMimeTypeCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void testLocalFileCachedUntilModified();
+    void testRemoteGuess();
+    void testWrongGuessCorrected();
+    void testUrlLoaderGuesses();
+    void testBounded();
+    void benchmarkDecisionLatency_data();
+    void benchmarkDecisionLatency();
+
+private:
+    QString serverMimeType(const QUrl &url);
+
+    QTemporaryDir m_tempDir;
+    TestHttpServer m_server;
+};
+
+QTEST_MAIN(KonqMimeTypeCacheTest)
+
+static const QByteArray s_html("<html><head><title>Hello</title></head><body><p>Hello World</p></body></html>");
+
+void KonqMimeTypeCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    QVERIFY(m_tempDir.isValid());
+    QVERIFY(m_server.listen(QHostAddress::LocalHost));
+    for (int i = 0; i < 100; ++i) {
+        m_server.addFile(QStringLiteral("/docs/%1.txt").arg(i), "text/plain", "Just some text");
+    }
+    // Same pattern as the others, but not the same type
+    m_server.addFile(QStringLiteral("/docs/changelog.txt"), "text/html", s_html);
+}
+
+void KonqMimeTypeCacheTest::init()
+{
+    KonqMimeTypeCache::self()->clear();
+}
+
+// What the KIO::OpenUrlJob of UrlLoader waits for
+QString KonqMimeTypeCacheTest::serverMimeType(const QUrl &url)
+{
+    KIO::MimetypeJob *job = KIO::mimetype(url, KIO::HideProgressInfo);
+    if (!job->exec()) {
+        qWarning() << job->errorString();
+        return QString();
+    }
+    return job->mimetype();
+}
+
+void KonqMimeTypeCacheTest::testLocalFileCachedUntilModified()
+{
+    KonqMimeTypeCache *cache = KonqMimeTypeCache::self();
+    // No extension, so the contents decide
+    const QString path = m_tempDir.filePath(QStringLiteral("page"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(s_html);
+    file.close();
+
+    QCOMPARE(cache->mimeTypeForLocalFile(path), QStringLiteral("text/html"));
+    QCOMPARE(cache->statistics().misses, 1);
+    QCOMPARE(cache->mimeTypeForLocalFile(path), QStringLiteral("text/html"));
+    QCOMPARE(cache->statistics().hits, 1);
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("%PDF-1.4\n");
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+    file.close();
+    QCOMPARE(cache->mimeTypeForLocalFile(path), QStringLiteral("application/pdf"));
+    QCOMPARE(cache->statistics().misses, 2);
+    QCOMPARE(cache->statistics().entries, 1);
+}
+
+void KonqMimeTypeCacheTest::testRemoteGuess()
+{
+    KonqMimeTypeCache *cache = KonqMimeTypeCache::self();
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/1.txt"))), QString());
+    cache->record(m_server.url(QStringLiteral("/docs/1.txt")), serverMimeType(m_server.url(QStringLiteral("/docs/1.txt"))));
+
+    // Same directory, same extension
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/2.txt"))), QStringLiteral("text/plain"));
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/3.TXT"))), QStringLiteral("text/plain"));
+    // Anything else is unknown, including URLs with a query or without an extension
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/3.txt?version=2"))), QString());
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/3"))), QString());
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/3.pdf"))), QString());
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/sub/3.txt"))), QString());
+    QCOMPARE(cache->guess(QUrl(QStringLiteral("http://example.org/docs/3.txt"))), QString());
+
+    // Nothing is learnt from a type which says nothing
+    cache->record(m_server.url(QStringLiteral("/files/1.bin")), QStringLiteral("application/octet-stream"));
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/files/2.bin"))), QString());
+    // nor from URLs whose path says nothing
+    const int entries = cache->statistics().entries;
+    cache->record(m_server.url(QStringLiteral("/download")), QStringLiteral("application/pdf"));
+    cache->record(m_server.url(QStringLiteral("/get.php?file=1.pdf")), QStringLiteral("application/pdf"));
+    QCOMPARE(cache->statistics().entries, entries);
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/other"))), QString());
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/get.php?file=2.pdf"))), QString());
+}
+
+void KonqMimeTypeCacheTest::testWrongGuessCorrected()
+{
+    KonqMimeTypeCache *cache = KonqMimeTypeCache::self();
+    cache->record(m_server.url(QStringLiteral("/docs/1.txt")), QStringLiteral("text/plain"));
+    QSignalSpy spyVerified(cache, &KonqMimeTypeCache::verified);
+
+    // Right guess
+    const QUrl url = m_server.url(QStringLiteral("/docs/2.txt"));
+    cache->verify(url, cache->guess(url));
+    QVERIFY(spyVerified.wait(10000));
+    QCOMPARE(spyVerified.at(0).at(0).toUrl(), url);
+    QCOMPARE(spyVerified.at(0).at(2).toString(), QStringLiteral("text/plain"));
+    QCOMPARE(cache->statistics().corrections, 0);
+
+    // Wrong guess
+    const QUrl wrongUrl = m_server.url(QStringLiteral("/docs/changelog.txt"));
+    QCOMPARE(cache->guess(wrongUrl), QStringLiteral("text/plain"));
+    cache->verify(wrongUrl, cache->guess(wrongUrl));
+    QVERIFY(spyVerified.wait(10000));
+    QCOMPARE(spyVerified.at(1).at(0).toUrl(), wrongUrl);
+    QCOMPARE(spyVerified.at(1).at(1).toString(), QStringLiteral("text/plain"));
+    QCOMPARE(spyVerified.at(1).at(2).toString(), QStringLiteral("text/html"));
+    QCOMPARE(cache->statistics().corrections, 1);
+    // The latest type wins
+    QCOMPARE(cache->guess(m_server.url(QStringLiteral("/docs/3.txt"))), QStringLiteral("text/html"));
+}
+
+// How the guesses are used to open URLs
+void KonqMimeTypeCacheTest::testUrlLoaderGuesses()
+{
+    KonqMimeTypeCache *cache = KonqMimeTypeCache::self();
+    MyKonqMainWindow mainWindow;
+    KonqOpenURLRequest htmlEngineGaveUp;
+    htmlEngineGaveUp.args.metaData().insert(QStringLiteral("DontSendToDefaultHTMLPart"), QString());
+    KonqOpenURLRequest embed;
+    embed.forceAutoEmbed = true;
+    auto startLoader = [&mainWindow](const QUrl &url, const KonqOpenURLRequest &req) {
+        UrlLoader *loader = new UrlLoader(&mainWindow, nullptr, url, QString(), req, false);
+        loader->start();
+        return loader;
+    };
+
+    cache->record(m_server.url(QStringLiteral("/files/1.pdf")), QStringLiteral("application/pdf"));
+    cache->record(m_server.url(QStringLiteral("/files/download")), QStringLiteral("application/pdf"));
+
+    // http URLs still go to the HTML engine, which finds their type itself
+    UrlLoader *loader = startLoader(m_server.url(QStringLiteral("/files/2.pdf")), embed);
+    QCOMPARE(loader->mimeType(), QStringLiteral("text/html"));
+    loader->abort();
+
+    // Once it gave up, the server is asked about URLs with a query or without an extension
+    for (const QString &path : {QStringLiteral("/files/other"), QStringLiteral("/files/2.pdf?version=2")}) {
+        loader = startLoader(m_server.url(path), htmlEngineGaveUp);
+        QVERIFY2(!loader->isReady(), qPrintable(path));
+        QVERIFY2(loader->isAsync(), qPrintable(path));
+        QCOMPARE(loader->mimeType(), QString());
+        loader->abort();
+    }
+
+    // and about the others too, unless the guess can just be embedded: opening
+    // the URL in an application or saving it can't be undone if it's wrong
+    loader = startLoader(m_server.url(QStringLiteral("/files/2.pdf")), htmlEngineGaveUp);
+    QVERIFY(!loader->isReady());
+    QCOMPARE(loader->mimeType(), QString());
+    loader->abort();
+
+    // Other schemes use the guess right away, it's verified once embedded
+    cache->record(QUrl(QStringLiteral("ftp://ftp.example.org/pub/index.html")), QStringLiteral("text/html"));
+    loader = startLoader(QUrl(QStringLiteral("ftp://ftp.example.org/pub/news.html")), embed);
+    QVERIFY(loader->isReady());
+    QCOMPARE(loader->mimeType(), QStringLiteral("text/html"));
+    loader->abort();
+    loader = startLoader(QUrl(QStringLiteral("ftp://ftp.example.org/pub/news")), embed);
+    QVERIFY(!loader->isReady());
+    loader->abort();
+}
+
+void KonqMimeTypeCacheTest::testBounded()
+{
+    KonqMimeTypeCache *cache = KonqMimeTypeCache::self();
+    for (int i = 0; i < 5000; ++i) {
+        cache->record(QUrl(QStringLiteral("http://host%1.example.org/index.html").arg(i)), QStringLiteral("text/html"));
+    }
+    QVERIFY(cache->statistics().entries <= 1000);
+    // The least recently used ones went first
+    QCOMPARE(cache->guess(QUrl(QStringLiteral("http://host4999.example.org/other.html"))), QStringLiteral("text/html"));
+    QCOMPARE(cache->guess(QUrl(QStringLiteral("http://host0.example.org/other.html"))), QString());
+}
+
+void KonqMimeTypeCacheTest::benchmarkDecisionLatency_data()
+{
+    QTest::addColumn<bool>("remote");
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("local, sniffed") << false << false;
+    QTest::newRow("local, cached") << false << true;
+    QTest::newRow("remote, asking the server") << true << false;
+    QTest::newRow("remote, guessed") << true << true;
+}
+
+void KonqMimeTypeCacheTest::benchmarkDecisionLatency()
+{
+    QFETCH(bool, remote);
+    QFETCH(bool, cached);
+    const int urlCount = 100;
+    KonqMimeTypeCache *cache = KonqMimeTypeCache::self();
+
+    QList<QUrl> urls;
+    for (int i = 0; i < urlCount; ++i) {
+        if (remote) {
+            urls.append(m_server.url(QStringLiteral("/docs/%1.txt").arg(i)));
+        } else {
+            // The contents of files without extension have to be read
+            const QString path = m_tempDir.filePath(QStringLiteral("file%1").arg(i));
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(s_html);
+            urls.append(QUrl::fromLocalFile(path));
+        }
+    }
+    if (cached) {
+        // As after visiting the first page of the directory, or the files themselves
+        for (const QUrl &url : qAsConst(urls)) {
+            if (remote) {
+                cache->record(url, serverMimeType(url));
+                break;
+            }
+            cache->mimeTypeForLocalFile(url.toLocalFile());
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QUrl &url : qAsConst(urls)) {
+        QString mimeType;
+        if (!remote) {
+            mimeType = cached ? cache->mimeTypeForLocalFile(url.toLocalFile()) : QMimeDatabase().mimeTypeForFile(url.toLocalFile()).name();
+        } else {
+            mimeType = cached ? cache->guess(url) : serverMimeType(url);
+        }
+        QVERIFY(!mimeType.isEmpty());
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    qDebug() << "Average time to know the type:" << elapsed / urlCount / 1000 << "us";
+    QTest::setBenchmarkResult(elapsed / qreal(urlCount) / 1000000, QTest::WalltimeMilliseconds);
+}
+
+#include "konqmimetypecachetest.moc"
@@ -0,0 +1,187 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <KParts/ReadOnlyPart>
+#include <konqhibernator.h>
+#include <konqmainwindow.h>
+#include <konqpartpool.h>
+#include <konqsessionmanager.h>
+#include <konqtabs.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+class KonqPartPoolTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+    void testNewTabTakesPooledPart();
+    void testReleaseParts();
+    void benchmarkNewTabFirstPaint_data();
+    void benchmarkNewTabFirstPaint();
+
+private:
+    void openFirstPage(KonqMainWindow &mainWindow);
+
+    QTemporaryDir m_tempDir;
+    QUrl m_pageUrl;
+};
+
+QTEST_MAIN(KonqPartPoolTest)
+
+// 10 MiB for this process, 200 MiB for any renderer
+static qint64 fakeResidentMemory(qint64 pid)
+{
+    return (pid == QCoreApplication::applicationPid() ? 10 : 200) * 1024 * 1024;
+}
+
+void KonqPartPoolTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    QVERIFY(m_tempDir.isValid());
+
+    // The title changes once the page is about to be painted for the first time
+    QFile file(m_tempDir.filePath(QStringLiteral("page.html")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<html><head><title>loading</title></head><body>");
+    for (int i = 0; i < 100; ++i) {
+        file.write("<p>Paragraph " + QByteArray::number(i) + "</p>");
+    }
+    file.write("<script>requestAnimationFrame(function() { document.title = 'painted'; });</script>");
+    file.write("</body></html>");
+    file.close();
+    m_pageUrl = QUrl::fromLocalFile(file.fileName());
+}
+
+void KonqPartPoolTest::cleanup()
+{
+    KonqPartPool::self()->releaseParts();
+    KonqSettings::self()->setDefaults();
+    KonqSettings::setAlwaysHavePreloaded(false);
+}
+
+void KonqPartPoolTest::openFirstPage(KonqMainWindow &mainWindow)
+{
+    mainWindow.openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+}
+
+void KonqPartPoolTest::testNewTabTakesPooledPart()
+{
+    KonqSettings::setPooledBrowserParts(2);
+    MyKonqMainWindow mainWindow;
+    openFirstPage(mainWindow);
+    KonqPartPool *pool = KonqPartPool::self();
+    pool->refill();
+    QCOMPARE(pool->count(), 2);
+
+    KonqView *view = mainWindow.viewManager()->addTab(QStringLiteral("text/html"));
+    QVERIFY(view);
+    QCOMPARE(pool->count(), 1);
+    QCOMPARE(view->part()->widget()->parentWidget(), view->frame());
+
+    // The pooled part works like a new one
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    view->openUrl(m_pageUrl, m_pageUrl.toDisplayString());
+    QVERIFY(spyCompleted.wait(20000));
+    QCOMPARE(view->url(), m_pageUrl);
+    QTRY_COMPARE(view->caption(), QStringLiteral("painted"));
+
+    // Refilled when idle
+    QTRY_COMPARE_WITH_TIMEOUT(pool->count(), 2, 20000);
+}
+
+void KonqPartPoolTest::testReleaseParts()
+{
+    KonqSettings::setPooledBrowserParts(3);
+    MyKonqMainWindow mainWindow;
+    openFirstPage(mainWindow);
+    KonqPartPool *pool = KonqPartPool::self();
+    pool->refill();
+    QCOMPARE(pool->count(), 3);
+
+    QCOMPARE(pool->releaseParts(1), 1);
+    QCOMPARE(pool->count(), 2);
+    QCOMPARE(pool->releaseParts(), 2);
+    QCOMPARE(pool->count(), 0);
+
+    // Over the memory budget, the pool isn't refilled
+    KonqSettings::setHibernationMemoryBudget(1); // MiB
+    pool->refill();
+    QCOMPARE(pool->count(), 0);
+    KonqView *view = mainWindow.viewManager()->addTab(QStringLiteral("text/html"));
+    QVERIFY(view);
+    QVERIFY(view->part());
+
+    // The renderers of the views count in the budget too
+    KonqSettings::setHibernationMemoryBudget(100); // MiB
+    view->part()->setProperty("konqRendererPid", QCoreApplication::applicationPid() + 1);
+    KonqHibernator::self()->setResidentMemoryFunction(&fakeResidentMemory);
+    pool->refill();
+    QCOMPARE(pool->count(), 0);
+    KonqHibernator::self()->setResidentMemoryFunction(nullptr);
+}
+
+void KonqPartPoolTest::benchmarkNewTabFirstPaint_data()
+{
+    QTest::addColumn<int>("poolSize");
+
+    QTest::newRow("without pool") << 0;
+    QTest::newRow("with pool") << 1;
+}
+
+void KonqPartPoolTest::benchmarkNewTabFirstPaint()
+{
+    QFETCH(int, poolSize);
+    const int tabCount = 20;
+    KonqSettings::setPooledBrowserParts(poolSize);
+
+    MyKonqMainWindow mainWindow;
+    mainWindow.show();
+    openFirstPage(mainWindow);
+    KonqViewManager *viewManager = mainWindow.viewManager();
+    KonqPartPool *pool = KonqPartPool::self();
+
+    qint64 total = 0;
+    for (int i = 0; i < tabCount; ++i) {
+        // As if the pool had been refilled while the user did something else
+        pool->refill();
+        QCOMPARE(pool->count(), poolSize);
+
+        QElapsedTimer timer;
+        timer.start();
+        KonqView *view = viewManager->addTab(QStringLiteral("text/html"));
+        QVERIFY(view);
+        viewManager->showTab(view);
+        QSignalSpy captionSpy(view->part(), SIGNAL(setWindowCaption(QString)));
+        QUrl url(m_pageUrl);
+        url.setQuery(QStringLiteral("tab=%1").arg(i));
+        view->openUrl(url, url.toDisplayString());
+        bool painted = false;
+        while (!painted) {
+            QVERIFY(captionSpy.wait(20000));
+            painted = captionSpy.last().at(0).toString() == QLatin1String("painted");
+        }
+        total += timer.elapsed();
+    }
+    qDebug() << "Average time to first paint:" << total / tabCount << "ms";
+    QTest::setBenchmarkResult(total / qreal(tabCount), QTest::WalltimeMilliseconds);
+}
+
+#include "konqpartpooltest.moc"
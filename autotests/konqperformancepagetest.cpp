@@ -0,0 +1,161 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QDBusConnection>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <KonquerorAdaptor.h>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include <webenginepage.h>
+#include <webenginepart.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+class KonqPerformancePageTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testListsAllViews();
+
+private:
+    static bool openAndWait(KonqView *view, const QUrl &url);
+    static QVariant evaluate(WebEnginePart *part, const QString &script);
+    static QHash<QString, QVariantList> listedViews(WebEnginePart *part);
+
+    QTemporaryDir m_tempDir;
+    QList<QUrl> m_urls;
+};
+
+QTEST_MAIN(KonqPerformancePageTest)
+
+void KonqPerformancePageTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    QVERIFY(m_tempDir.isValid());
+
+    if (QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("konqueror/about/performance.html")).isEmpty()) {
+        QSKIP("The about pages aren't installed");
+    }
+    // The page asks this process for the statistics
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus");
+    }
+    new KonquerorAdaptor;
+
+    for (int i = 0; i < 4; ++i) {
+        QFile file(m_tempDir.filePath(QStringLiteral("page%1.html").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("<html><head><title>Page " + QByteArray::number(i) + "</title></head><body>");
+        for (int j = 0; j < 100; ++j) {
+            file.write("<p>Paragraph " + QByteArray::number(j) + "</p>");
+        }
+        file.write("</body></html>");
+        m_urls.append(QUrl::fromLocalFile(file.fileName()));
+    }
+}
+
+bool KonqPerformancePageTest::openAndWait(KonqView *view, const QUrl &url)
+{
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    view->openUrl(url, url.toDisplayString());
+    return spyCompleted.wait(20000);
+}
+
+QVariant KonqPerformancePageTest::evaluate(WebEnginePart *part, const QString &script)
+{
+    QVariant result;
+    bool done = false;
+    part->page()->runJavaScript(script, [&result, &done](const QVariant &value) {
+        result = value;
+        done = true;
+    });
+    QTest::qWaitFor([&done]() { return done; }, 10000);
+    return result;
+}
+
+// The rows of the table of views, by URL, with the raw value of each numeric cell
+QHash<QString, QVariantList> KonqPerformancePageTest::listedViews(WebEnginePart *part)
+{
+    const QVariantList rows = evaluate(part, QStringLiteral(
+        "Array.from(document.querySelectorAll('#views tbody tr')).map(function(row) {"
+        "    return [row.dataset.url].concat(Array.from(row.cells).filter(function(cell) { return cell.dataset.value !== undefined; })"
+        "                                                         .map(function(cell) { return Number(cell.dataset.value); }));"
+        "})")).toList();
+    QHash<QString, QVariantList> views;
+    for (const QVariant &row : rows) {
+        QVariantList values = row.toList();
+        if (!values.isEmpty()) {
+            views.insert(values.takeFirst().toString(), values);
+        }
+    }
+    return views;
+}
+
+void KonqPerformancePageTest::testListsAllViews()
+{
+    MyKonqMainWindow mainWindow;
+    KonqViewManager *viewManager = mainWindow.viewManager();
+    mainWindow.openUrl(nullptr, m_urls.first(), QStringLiteral("text/html"));
+    QSignalSpy spyCompleted(mainWindow.currentView(), SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    for (int i = 1; i < m_urls.count() - 1; ++i) {
+        QVERIFY(openAndWait(viewManager->addTab(QStringLiteral("text/html")), m_urls.at(i)));
+    }
+
+    KonqView *performanceView = viewManager->addTab(QStringLiteral("text/html"));
+    viewManager->showTab(performanceView);
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+    QVERIFY(openAndWait(performanceView, QUrl(QStringLiteral("konq:performance"))));
+    WebEnginePart *part = qobject_cast<WebEnginePart *>(performanceView->part());
+    QVERIFY(part);
+
+    // Every view is listed, the performance page included
+    QTRY_COMPARE(listedViews(part).count(), mainWindow.viewCount());
+    QHash<QString, QVariantList> views = listedViews(part);
+    for (int i = 0; i < m_urls.count() - 1; ++i) {
+        const QUrl url = m_urls.at(i);
+        QVERIFY2(views.contains(url.toString()), qPrintable(url.toString()));
+        const QVariantList values = views.value(url.toString());
+        // Process, memory, CPU time, first paint, load time, bytes, blocked requests
+        QCOMPARE(values.count(), 7);
+        QVERIFY(values.at(0).toLongLong() > 0);
+#ifdef Q_OS_LINUX
+        QVERIFY(values.at(1).toLongLong() > 0);
+#endif
+        QVERIFY(values.at(2).toLongLong() >= 0);
+        QVERIFY(values.at(4).toLongLong() >= 0);
+        QVERIFY(values.at(4).toLongLong() <= 20000);
+        QVERIFY(values.at(5).toLongLong() >= QFileInfo(url.toLocalFile()).size());
+        QCOMPARE(values.at(6).toInt(), 0);
+    }
+
+    // The caches and this process are shown too
+    const QVariantList caches = evaluate(part, QStringLiteral(
+        "Array.from(document.querySelectorAll('#caches tbody td')).map(function(cell) { return Number(cell.dataset.value); })")).toList();
+    QCOMPARE(caches.count(), 4);
+    for (const QVariant &size : caches) {
+        QVERIFY(size.toInt() >= 0);
+    }
+    QCOMPARE(evaluate(part, QStringLiteral("document.getElementById('pid').textContent")).toString(),
+             QString::number(QCoreApplication::applicationPid()));
+
+    // A page opened meanwhile shows up without reloading the performance page
+    QSignalSpy spyReloaded(performanceView, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(openAndWait(viewManager->addTab(QStringLiteral("text/html")), m_urls.last()));
+    QTRY_VERIFY(listedViews(part).contains(m_urls.last().toString()));
+    QCOMPARE(spyReloaded.count(), 0);
+}
+
+#include "konqperformancepagetest.moc"
@@ -0,0 +1,183 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KIconLoader>
+
+#include <konqpixmapprovider.h>
+
+class KonqPixmapProviderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+    void testLruEviction();
+    void testUpdateIconForUrl();
+    void testSaveLoad();
+    void benchmarkFaviconUpdates();
+    void testPixmapCache();
+    void benchmarkBookmarkMenu();
+};
+
+QTEST_MAIN(KonqPixmapProviderTest)
+
+static QUrl testUrl(int i)
+{
+    return QUrl(QStringLiteral("http://host%1.example.org/page%2.html").arg(i % 500).arg(i));
+}
+
+void KonqPixmapProviderTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void KonqPixmapProviderTest::cleanup()
+{
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    provider->clear();
+    provider->setMaxCount(10000);
+}
+
+void KonqPixmapProviderTest::testLruEviction()
+{
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    provider->setMaxCount(3);
+    provider->iconNameFor(testUrl(1));
+    provider->iconNameFor(testUrl(2));
+    provider->iconNameFor(testUrl(3));
+    QCOMPARE(provider->count(), 3);
+
+    // Use 1 again, so that 2 is the least recently used one
+    provider->iconNameFor(testUrl(1));
+    provider->updateIconForUrl(testUrl(2), QStringLiteral("custom-icon"));
+    provider->iconNameFor(testUrl(4));
+    QCOMPARE(provider->count(), 3);
+
+    // 2 was evicted, so its custom icon is gone
+    QVERIFY(provider->iconNameFor(testUrl(2)) != QLatin1String("custom-icon"));
+}
+
+void KonqPixmapProviderTest::testUpdateIconForUrl()
+{
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    provider->iconNameFor(testUrl(1));
+    provider->iconNameFor(testUrl(501)); // same host, other page
+    QSignalSpy changedSpy(provider, &KonqPixmapProvider::changed);
+
+    provider->updateIconForUrl(testUrl(1), QStringLiteral("custom-icon"));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(provider->iconNameFor(testUrl(1)), QStringLiteral("custom-icon"));
+    QVERIFY(provider->iconNameFor(testUrl(501)) != QLatin1String("custom-icon"));
+
+    // No change, no signal
+    provider->updateIconForUrl(testUrl(1), QStringLiteral("custom-icon"));
+    QCOMPARE(changedSpy.count(), 1);
+}
+
+void KonqPixmapProviderTest::testSaveLoad()
+{
+    QTemporaryDir dir;
+    KConfig config(dir.path() + QLatin1String("/iconcache"), KConfig::SimpleConfig);
+    KConfigGroup group(&config, "Location Bar");
+    const QString key = QStringLiteral("ComboIconCache");
+
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    QStringList items;
+    for (int i = 0; i < 10; ++i) {
+        provider->iconNameFor(testUrl(i));
+        provider->updateIconForUrl(testUrl(i), QStringLiteral("icon-%1").arg(i % 3));
+        items.append(testUrl(i).url());
+    }
+    provider->iconNameFor(testUrl(10)); // not in items, not saved
+    provider->save(group, key, items);
+    // The url, icon pairs older versions read too
+    QCOMPARE(group.readPathEntry(key, QStringList()).count(), 20);
+
+    provider->clear();
+    QCOMPARE(provider->count(), 0);
+    provider->load(group, key);
+    QCOMPARE(provider->count(), 10);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(provider->iconNameFor(testUrl(i)), QStringLiteral("icon-%1").arg(i % 3));
+    }
+}
+
+void KonqPixmapProviderTest::benchmarkFaviconUpdates()
+{
+    const int count = 50000;
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    provider->setMaxCount(count);
+    for (int i = 0; i < count; ++i) {
+        provider->iconNameFor(testUrl(i));
+    }
+    QCOMPARE(provider->count(), count);
+
+    // One favicon result per page load, each one for a different host
+    int i = 0;
+    QBENCHMARK {
+        provider->updateIconForUrl(testUrl(i), QStringLiteral("icon-%1").arg(i));
+        ++i;
+    }
+}
+
+void KonqPixmapProviderTest::testPixmapCache()
+{
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    const QString url = testUrl(1).url();
+    const QPixmap first = provider->pixmapFor(url, KIconLoader::SizeSmall);
+
+    KonqPixmapProvider::Statistics before = provider->statistics();
+    const QPixmap second = provider->pixmapFor(url, KIconLoader::SizeSmall);
+    QCOMPARE(second.cacheKey(), first.cacheKey());
+    KonqPixmapProvider::Statistics after = provider->statistics();
+    QCOMPARE(after.cacheMisses - before.cacheMisses, 0);
+    QCOMPARE(after.cacheHits - before.cacheHits, 1);
+
+    // Another size is another pixmap, rendered from the cached icon
+    before = after;
+    provider->pixmapFor(url, KIconLoader::SizeMedium);
+    after = provider->statistics();
+    QCOMPARE(after.cacheMisses - before.cacheMisses, 1);
+    QCOMPARE(after.cacheHits - before.cacheHits, 1);
+}
+
+void KonqPixmapProviderTest::benchmarkBookmarkMenu()
+{
+    // What KonqBookmarkMenu::actionForBookmark does for each bookmark, for a
+    // menu of 2000 bookmarks on 50 hosts. The .invalid hosts make the
+    // favicon downloads fail quickly.
+    const int count = 2000;
+    KonqPixmapProvider *provider = KonqPixmapProvider::self();
+    const KonqPixmapProvider::Statistics before = provider->statistics();
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < count; ++i) {
+            const QUrl host(QStringLiteral("http://bookmark%1.invalid").arg(i % 50));
+            const QIcon icon = QIcon::fromTheme(provider->iconNameFor(host));
+            Q_UNUSED(icon);
+            provider->downloadHostIcon(host);
+            // KonqPixmapProvider::changed() makes every action reload its icon
+            provider->iconForUrl(host);
+        }
+    }
+
+    const KonqPixmapProvider::Statistics after = provider->statistics();
+    qDebug() << "icon cache hits:" << after.cacheHits - before.cacheHits
+             << "misses:" << after.cacheMisses - before.cacheMisses
+             << "favicon requests avoided:" << after.redundantRequestsAvoided - before.redundantRequestsAvoided;
+    QCOMPARE(after.redundantRequestsAvoided - before.redundantRequestsAvoided, count - 50);
+    // At most one per host, hosts without favicon share the same icon
+    QVERIFY(after.cacheMisses - before.cacheMisses <= 50);
+}
+
+#include "konqpixmapprovidertest.moc"
@@ -0,0 +1,421 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <KConfig>
+#include <KConfigGroup>
+#include <KToolBar>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqsessionwriter.h>
+#include <konqsettingsxt.h>
+#include <konqtabs.h>
+#include <konqview.h>
+#include <konqviewmanager.h>
+#include "konqtesthelpers.h"
+
+class KonqSessionManagerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testIncrementalAutosave();
+    void testKilledWriterKeepsPreviousSession();
+    void testBinarySessionFormat();
+    void testSubgroups();
+    void benchmarkSessionFormat_data();
+    void benchmarkSaveSession();
+    void benchmarkRestoreSession();
+    void benchmarkAutosave_data();
+    void benchmarkAutosave();
+
+private:
+    static KonqMainWindow *createWindow(int tabs);
+    static KonqSessionSnapshot createSnapshot(int windows, int tabsPerWindow, int historyItems);
+    static QString autosaveFile();
+
+    QList<KonqMainWindow *> m_benchmarkWindows;
+};
+
+QTEST_MAIN(KonqSessionManagerTest)
+
+void KonqSessionManagerTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(KonqSessionManager::self()->autosaveDirectory()).removeRecursively();
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+}
+
+void KonqSessionManagerTest::cleanupTestCase()
+{
+    qDeleteAll(m_benchmarkWindows);
+    KonqSessionManager::self()->disableAutosave();
+}
+
+KonqMainWindow *KonqSessionManagerTest::createWindow(int tabs)
+{
+    KonqMainWindow *window = new MyKonqMainWindow;
+    window->openUrl(nullptr, QUrl(QStringLiteral("data:text/html, <p>Tab 0</p>")), QStringLiteral("text/html"));
+    for (int i = 1; i < tabs; ++i) {
+        KonqView *view = window->viewManager()->addTab(QStringLiteral("text/html"));
+        view->openUrl(QUrl(QStringLiteral("data:text/html, <p>Tab %1</p>").arg(i)), QString::number(i));
+    }
+    return window;
+}
+
+// Entries like the ones KonqView::saveConfig() writes with SaveHistoryItems
+KonqSessionSnapshot KonqSessionManagerTest::createSnapshot(int windows, int tabsPerWindow, int historyItems)
+{
+    KonqSessionSnapshot snapshot(windows);
+    for (int w = 0; w < windows; ++w) {
+        KonqSessionWindowEntries &entries = snapshot[w];
+        QByteArrayList children;
+        for (int t = 0; t < tabsPerWindow; ++t) {
+            const QByteArray view = "ViewT" + QByteArray::number(t);
+            children.append(view);
+            entries.append(qMakePair(view + "_ServiceType", QByteArray("text/html")));
+            entries.append(qMakePair(view + "_ServiceName", QByteArray("webenginepart")));
+            entries.append(qMakePair(view + "_PassiveMode", QByteArray("false")));
+            entries.append(qMakePair(view + "_LinkedView", QByteArray("false")));
+            entries.append(qMakePair(view + "_CurrentHistoryItem", QByteArray::number(historyItems - 1)));
+            entries.append(qMakePair(view + "_NumberOfHistoryItems", QByteArray::number(historyItems)));
+            for (int h = 0; h < historyItems; ++h) {
+                const QByteArray prefix = "HistoryItem" + view + '_' + QByteArray::number(h);
+                const QByteArray url = "https://www.example.org/window" + QByteArray::number(w) + "/tab" + QByteArray::number(t) + "/page" + QByteArray::number(h) + ".html";
+                entries.append(qMakePair(prefix + "Url", url));
+                entries.append(qMakePair(prefix + "LocationBarURL", url));
+                entries.append(qMakePair(prefix + "Title", "Page " + QByteArray::number(h) + " of tab " + QByteArray::number(t)));
+                entries.append(qMakePair(prefix + "StrServiceType", QByteArray("text/html")));
+                entries.append(qMakePair(prefix + "StrServiceName", QByteArray("webenginepart")));
+                if (h == historyItems - 1) {
+                    entries.append(qMakePair(prefix + "Buffer", QByteArray(512, char(h))));
+                    entries.append(qMakePair(prefix + "DoPost", QByteArray("false")));
+                    entries.append(qMakePair(prefix + "PageSecurity", QByteArray("0")));
+                }
+            }
+        }
+        entries.append(qMakePair(QByteArray("RootItem"), QByteArray("Tabs0")));
+        entries.append(qMakePair(QByteArray("Tabs0_Children"), children.join(',')));
+    }
+    return snapshot;
+}
+
+QString KonqSessionManagerTest::autosaveFile()
+{
+    const QDir dir(KonqSessionManager::self()->autosaveDirectory());
+    const QStringList files = dir.entryList(QDir::Files);
+    return files.count() == 1 ? dir.filePath(files.first()) : QString();
+}
+
+void KonqSessionManagerTest::testIncrementalAutosave()
+{
+    KonqSessionManager *sessionMgr = KonqSessionManager::self();
+    sessionMgr->enableAutosave();
+
+    QScopedPointer<KonqMainWindow> firstWindow(createWindow(2));
+    QScopedPointer<KonqMainWindow> secondWindow(createWindow(2));
+
+    sessionMgr->autoSaveSession();
+    sessionMgr->waitForAutosave();
+    const QString filePath = autosaveFile();
+    QVERIFY(!filePath.isEmpty());
+
+    // Nothing changed: nothing is serialized, nothing is written
+    KonqSessionManager::AutosaveStatistics stats = sessionMgr->autosaveStatistics();
+    sessionMgr->autoSaveSession();
+    QCOMPARE(sessionMgr->autosaveStatistics().skippedSaves, stats.skippedSaves + 1);
+    QCOMPARE(sessionMgr->autosaveStatistics().saves, stats.saves);
+
+    // A change in the second window only serializes that window
+    stats = sessionMgr->autosaveStatistics();
+    KonqView *view = secondWindow->currentView();
+    QVERIFY(view);
+    view->setLockedLocation(true);
+    sessionMgr->autoSaveSession();
+    sessionMgr->waitForAutosave();
+    QCOMPARE(sessionMgr->autosaveStatistics().saves, stats.saves + 1);
+    QCOMPARE(sessionMgr->autosaveStatistics().windowsSerialized, stats.windowsSerialized + 1);
+    {
+        QScopedPointer<KConfig> cfg(KonqSessionWriter::openSession(filePath));
+        QCOMPARE(KConfigGroup(cfg.data(), "General").readEntry("Number of Windows", 0), 2);
+        QCOMPARE(KConfigGroup(cfg.data(), "Window0").readEntry("Tabs0_Children"), QString("ViewT0,ViewT1"));
+        QVERIFY(KConfigGroup(cfg.data(), "Window1").readEntry("ViewT0_LockedLocation", false)
+                || KConfigGroup(cfg.data(), "Window1").readEntry("ViewT1_LockedLocation", false));
+    }
+
+    // Toolbar settings are saved in a subgroup of the window, changing them
+    // serializes the window again
+    stats = sessionMgr->autosaveStatistics();
+    KToolBar *toolBar = secondWindow->toolBar(QStringLiteral("mainToolBar"));
+    toolBar->setIconSize(toolBar->iconSize() * 2);
+    const int iconSize = toolBar->iconSize().width();
+    sessionMgr->autoSaveSession();
+    sessionMgr->waitForAutosave();
+    QCOMPARE(sessionMgr->autosaveStatistics().windowsSerialized, stats.windowsSerialized + 1);
+    {
+        QScopedPointer<KConfig> cfg(KonqSessionWriter::openSession(filePath));
+        const KConfigGroup toolBarGroup = KConfigGroup(cfg.data(), "Window1").group("Toolbar mainToolBar");
+        QCOMPARE(toolBarGroup.readEntry("IconSize", 0), iconSize);
+    }
+
+    // Closing a tab doesn't leave its entries behind
+    KonqViewManager *viewManager = firstWindow->viewManager();
+    viewManager->removeTab(viewManager->tabContainer()->tabAt(1));
+    sessionMgr->autoSaveSession();
+    sessionMgr->waitForAutosave();
+    {
+        QScopedPointer<KConfig> cfg(KonqSessionWriter::openSession(filePath));
+        KConfigGroup windowGroup(cfg.data(), "Window0");
+        QCOMPARE(windowGroup.readEntry("Tabs0_Children"), QString("ViewT0"));
+        QVERIFY(!windowGroup.hasKey("HistoryItemViewT1_0Url"));
+    }
+
+    // Closing a window removes its group
+    secondWindow.reset();
+    sessionMgr->autoSaveSession();
+    sessionMgr->waitForAutosave();
+    {
+        QScopedPointer<KConfig> cfg(KonqSessionWriter::openSession(filePath));
+        QCOMPARE(KConfigGroup(cfg.data(), "General").readEntry("Number of Windows", 0), 1);
+        QVERIFY(!cfg->hasGroup("Window1"));
+    }
+
+    firstWindow.reset();
+    sessionMgr->disableAutosave();
+}
+
+// Kills a process saving sessions at random points, and checks that the file
+// always holds one complete session: the initial one or one of the helper's.
+void KonqSessionManagerTest::testKilledWriterKeepsPreviousSession()
+{
+    const int windows = 20;
+    const int entries = 500;
+    QTemporaryDir dir;
+    const QString filePath = dir.filePath(QStringLiteral("session"));
+
+    KonqSessionSnapshot snapshot(windows);
+    for (int i = 0; i < windows; ++i) {
+        for (int j = 0; j < entries; ++j) {
+            snapshot[i].append(qMakePair(QByteArray("Entry") + QByteArray::number(j), QByteArray("0 initial")));
+        }
+    }
+    QVERIFY(KonqSessionWriter::writeSession(filePath, snapshot));
+
+    for (int round = 0; round < 20; ++round) {
+        QProcess helper;
+        helper.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        helper.start(QCoreApplication::applicationDirPath() + QLatin1String("/konqsessionwriterhelper"),
+                     {filePath, QString::number(windows), QString::number(entries)});
+        QVERIFY(helper.waitForReadyRead());
+        QTest::qWait(QRandomGenerator::global()->bounded(200));
+        helper.kill();
+        QVERIFY(helper.waitForFinished());
+
+        QScopedPointer<KConfig> cfg(KonqSessionWriter::openSession(filePath));
+        QCOMPARE(KConfigGroup(cfg.data(), "General").readEntry("Number of Windows", 0), windows);
+        QByteArray generation;
+        for (int i = 0; i < windows; ++i) {
+            const KConfigGroup windowGroup(cfg.data(), "Window" + QString::number(i));
+            QCOMPARE(windowGroup.keyList().count(), entries);
+            for (int j = 0; j < entries; ++j) {
+                const QByteArray value = windowGroup.readEntry(QStringLiteral("Entry%1").arg(j), QByteArray());
+                const QByteArray valueGeneration = value.left(value.indexOf(' '));
+                if (generation.isEmpty()) {
+                    generation = valueGeneration;
+                }
+                QCOMPARE(valueGeneration, generation);
+            }
+        }
+    }
+}
+
+void KonqSessionManagerTest::testBinarySessionFormat()
+{
+    QTemporaryDir dir;
+    const QString binaryPath = dir.filePath(QStringLiteral("binary"));
+    const QString configPath = dir.filePath(QStringLiteral("config"));
+
+    KonqSessionSnapshot snapshot = createSnapshot(2, 3, 4);
+    snapshot[1].append(qMakePair(QByteArray("Binary"), QByteArray("\0\n\xff[]=", 7)));
+    QVERIFY(KonqSessionWriter::writeSession(binaryPath, snapshot));
+    QVERIFY(KonqSessionWriter::isBinarySession(binaryPath));
+
+    KonqSessionSnapshot read;
+    QVERIFY(KonqSessionWriter::readSession(binaryPath, &read));
+    QCOMPARE(read, snapshot);
+
+    // Export to KConfig, and import back
+    {
+        KConfig config(configPath, KConfig::SimpleConfig);
+        KonqSessionWriter::snapshotToConfig(snapshot, &config);
+    }
+    QVERIFY(!KonqSessionWriter::isBinarySession(configPath));
+    QScopedPointer<KConfig> config(KonqSessionWriter::openSession(configPath));
+    QCOMPARE(KonqSessionWriter::snapshotFromConfig(*config).count(), 2);
+    QCOMPARE(KConfigGroup(config.data(), "Window1").readEntry("Binary", QByteArray()), QByteArray("\0\n\xff[]=", 7));
+
+    // Both kinds of files give the same session
+    QScopedPointer<KConfig> binaryConfig(KonqSessionWriter::openSession(binaryPath));
+    const KConfigGroup group(binaryConfig.data(), "Window1");
+    QCOMPARE(group.readEntry("Tabs0_Children"), QString("ViewT0,ViewT1,ViewT2"));
+    QCOMPARE(group.readEntry("HistoryItemViewT2_3Title"), QString("Page 3 of tab 2"));
+    QCOMPARE(group.keyList(), KConfigGroup(config.data(), "Window1").keyList());
+
+    // A truncated file gives an empty session, rather than garbage
+    QFile file(binaryPath);
+    QVERIFY(file.resize(file.size() / 2));
+    QVERIFY(!KonqSessionWriter::readSession(binaryPath, &read));
+    QScopedPointer<KConfig> truncatedConfig(KonqSessionWriter::openSession(binaryPath));
+    QCOMPARE(KConfigGroup(truncatedConfig.data(), "General").readEntry("Number of Windows", 0), 0);
+}
+
+// Subgroups, like the toolbar settings written by saveMainWindowSettings(),
+// survive a round trip through a snapshot and the binary format
+void KonqSessionManagerTest::testSubgroups()
+{
+    QTemporaryDir dir;
+    const QString binaryPath = dir.filePath(QStringLiteral("binary"));
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup(&config, "General").writeEntry("Number of Windows", 1);
+    KConfigGroup windowGroup(&config, "Window0");
+    windowGroup.writeEntry("RootItem", "Tabs0");
+    KConfigGroup toolBarGroup = windowGroup.group("Toolbar mainToolBar");
+    toolBarGroup.writeEntry("IconSize", 32);
+    toolBarGroup.writeEntry("ToolButtonStyle", "IconOnly");
+    windowGroup.group("Toolbar locationToolBar").group("Nested").writeEntry("Hidden", true);
+
+    const KonqSessionSnapshot snapshot = KonqSessionWriter::snapshotFromConfig(config);
+    QCOMPARE(snapshot.count(), 1);
+    QCOMPARE(snapshot.first().count(), 4);
+    QVERIFY(KonqSessionWriter::writeSession(binaryPath, snapshot));
+
+    QScopedPointer<KConfig> restored(KonqSessionWriter::openSession(binaryPath));
+    const KConfigGroup restoredWindow(restored.data(), "Window0");
+    QCOMPARE(restoredWindow.keyList(), QStringList{QStringLiteral("RootItem")});
+    QCOMPARE(restoredWindow.readEntry("RootItem"), QString("Tabs0"));
+    QCOMPARE(restoredWindow.groupList().count(), 2);
+    const KConfigGroup restoredToolBar = restoredWindow.group("Toolbar mainToolBar");
+    QCOMPARE(restoredToolBar.readEntry("IconSize", 0), 32);
+    QCOMPARE(restoredToolBar.readEntry("ToolButtonStyle"), QString("IconOnly"));
+    QVERIFY(restoredWindow.group("Toolbar locationToolBar").group("Nested").readEntry("Hidden", false));
+    QCOMPARE(KonqSessionWriter::snapshotFromConfig(*restored), snapshot);
+}
+
+void KonqSessionManagerTest::benchmarkSessionFormat_data()
+{
+    QTest::addColumn<bool>("binary");
+
+    QTest::newRow("kconfig") << false;
+    QTest::newRow("binary") << true;
+}
+
+// A session with 1000 tabs: 10 windows of 100 tabs, with 10 history items each
+void KonqSessionManagerTest::benchmarkSaveSession()
+{
+    QFETCH(bool, binary);
+    const KonqSessionSnapshot snapshot = createSnapshot(10, 100, 10);
+    QTemporaryDir dir;
+    const QString filePath = dir.filePath(QStringLiteral("session"));
+
+    QBENCHMARK {
+        if (binary) {
+            KonqSessionWriter::writeSession(filePath, snapshot);
+        } else {
+            QFile::remove(filePath);
+            KConfig config(filePath, KConfig::SimpleConfig);
+            KonqSessionWriter::snapshotToConfig(snapshot, &config);
+            config.sync();
+        }
+    }
+    qDebug() << "file size:" << QFileInfo(filePath).size();
+}
+
+void KonqSessionManagerTest::benchmarkRestoreSession()
+{
+    QFETCH(bool, binary);
+    const KonqSessionSnapshot snapshot = createSnapshot(10, 100, 10);
+    QTemporaryDir dir;
+    const QString filePath = dir.filePath(QStringLiteral("session"));
+    if (binary) {
+        QVERIFY(KonqSessionWriter::writeSession(filePath, snapshot));
+    } else {
+        KConfig config(filePath, KConfig::SimpleConfig);
+        KonqSessionWriter::snapshotToConfig(snapshot, &config);
+    }
+
+    // What restoreSession() does before creating the windows
+    QBENCHMARK {
+        QScopedPointer<KConfig> config(KonqSessionWriter::openSession(filePath));
+        QCOMPARE(KConfigGroup(config.data(), "Window9").readEntry("RootItem"), QString("Tabs0"));
+    }
+}
+
+void KonqSessionManagerTest::benchmarkAutosave_data()
+{
+    QTest::addColumn<QString>("mode");
+
+    QTest::newRow("idle") << "idle";
+    QTest::newRow("lightBrowsing") << "lightBrowsing";
+    QTest::newRow("lightBrowsingWritten") << "lightBrowsingWritten";
+    QTest::newRow("fullSave") << "fullSave";
+}
+
+// 20 windows with 50 tabs each. "idle" autosaves without any change,
+// "lightBrowsing" autosaves after a navigation in one of the windows: this is
+// the time spent in the GUI thread, "lightBrowsingWritten" also waits for the
+// file to be written. "fullSave" serializes and writes every window in the GUI
+// thread, like autosaving used to do.
+void KonqSessionManagerTest::benchmarkAutosave()
+{
+    QFETCH(QString, mode);
+
+    if (m_benchmarkWindows.isEmpty()) {
+        for (int i = 0; i < 20; ++i) {
+            m_benchmarkWindows.append(createWindow(50));
+        }
+    }
+
+    KonqSessionManager *sessionMgr = KonqSessionManager::self();
+    sessionMgr->enableAutosave();
+    sessionMgr->autoSaveSession();
+
+    if (mode == QLatin1String("fullSave")) {
+        QTemporaryDir dir;
+        const QString filePath = dir.filePath(QStringLiteral("session"));
+        QBENCHMARK {
+            sessionMgr->saveCurrentSessionToFile(filePath);
+        }
+    } else {
+        const bool browsing = mode.startsWith(QLatin1String("lightBrowsing"));
+        const bool wait = mode == QLatin1String("lightBrowsingWritten");
+        int window = 0;
+        QBENCHMARK {
+            if (browsing) {
+                // What a new history entry in one of the tabs does
+                sessionMgr->markWindowDirty(m_benchmarkWindows.at(window));
+                window = (window + 1) % m_benchmarkWindows.count();
+            }
+            sessionMgr->autoSaveSession();
+            if (wait) {
+                sessionMgr->waitForAutosave();
+            }
+        }
+        sessionMgr->waitForAutosave();
+    }
+
+    sessionMgr->disableAutosave();
+}
+
+#include "konqsessionmanagertest.moc"
@@ -0,0 +1,41 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Helper process for konqsessionmanagertest: keeps saving sessions to the
+// given file, with the generation number in every entry, until it is killed.
+
+#include <konqsessionwriter.h>
+
+#include <QCoreApplication>
+
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc != 4) {
+        std::cerr << "usage: konqsessionwriterhelper <file> <windows> <entries per window>" << std::endl;
+        return 1;
+    }
+    const QString filePath = QString::fromLocal8Bit(argv[1]);
+    const int windows = QByteArray(argv[2]).toInt();
+    const int entries = QByteArray(argv[3]).toInt();
+    const QByteArray padding(200, 'x');
+
+    std::cout << "ready" << std::endl;
+    for (int generation = 1;; ++generation) {
+        KonqSessionSnapshot snapshot(windows);
+        for (int i = 0; i < windows; ++i) {
+            for (int j = 0; j < entries; ++j) {
+                snapshot[i].append(qMakePair(QByteArray("Entry") + QByteArray::number(j),
+                                             QByteArray::number(generation) + ' ' + padding));
+            }
+        }
+        KonqSessionWriter writer;
+        writer.write(filePath, snapshot);
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqstartuptrace.h>
+#include <konqview.h>
+#include "../src/konqsettingsxt.h"
+
+/**
+ * Traces the creation of the first window of the process and its first
+ * page, and checks that each phase listed in data/startupbudgets.json (or in
+ * the file named by the KONQUEROR_STARTUP_BUDGETS environment variable) was
+ * traced. A phase over its budget, in milliseconds, only gives a warning:
+ * how long it takes depends too much on the machine to fail the test.
+ */
+class KonqStartupTraceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testTraceDisabled();
+    void testStartupPhases();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+QTEST_MAIN(KonqStartupTraceTest)
+
+void KonqStartupTraceTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    KonqSettings::setPooledBrowserParts(0); // nothing created in the background
+    QVERIFY(m_tempDir.isValid());
+}
+
+void KonqStartupTraceTest::testTraceDisabled()
+{
+    KonqStartupTrace *trace = KonqStartupTrace::self();
+    trace->setFileName(QString());
+    QVERIFY(!trace->isEnabled());
+    {
+        KonqStartupSpan span("Nothing");
+    }
+    trace->navigationStarted();
+    trace->loadFinished();
+    QVERIFY(!trace->write());
+}
+
+void KonqStartupTraceTest::testStartupPhases()
+{
+    QString budgetsFile = qEnvironmentVariable("KONQUEROR_STARTUP_BUDGETS");
+    if (budgetsFile.isEmpty()) {
+        budgetsFile = QFINDTESTDATA("data/startupbudgets.json");
+    }
+    QFile budgets(budgetsFile);
+    QVERIFY2(budgets.open(QIODevice::ReadOnly), qPrintable(budgetsFile));
+    const QJsonObject budgetObject = QJsonDocument::fromJson(budgets.readAll()).object();
+    QVERIFY(!budgetObject.isEmpty());
+
+    const QString traceFile = m_tempDir.filePath(QStringLiteral("startup.json"));
+    KonqStartupTrace::self()->setFileName(traceFile);
+
+    // The first window of the process also loads the bookmarks and the history
+    KonqMainWindow mainWindow;
+    mainWindow.show();
+    const QUrl url = QUrl::fromLocalFile(QFINDTESTDATA("../webenginepart/autotests/data/hello.html"));
+    mainWindow.openUrl(nullptr, url, QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+
+    // Written when the first load finished
+    QTRY_VERIFY(QFile::exists(traceFile));
+    QFile file(traceFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("traceEvents")).toArray();
+    QVERIFY(!events.isEmpty());
+
+    QHash<QString, qint64> longest; // in microseconds
+    for (const QJsonValue &value : events) {
+        const QJsonObject event = value.toObject();
+        QCOMPARE(event.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+        QVERIFY(event.value(QStringLiteral("ts")).toDouble() >= 0);
+        const QString name = event.value(QStringLiteral("name")).toString();
+        const qint64 duration = qint64(event.value(QStringLiteral("dur")).toDouble());
+        QVERIFY(duration >= 0);
+        longest[name] = qMax(longest.value(name), duration);
+    }
+    qDebug() << "Startup phases (us):" << longest;
+
+    for (auto it = budgetObject.constBegin(); it != budgetObject.constEnd(); ++it) {
+        const QString phase = it.key();
+        QVERIFY2(longest.contains(phase), qPrintable(QStringLiteral("Phase \"%1\" wasn't traced").arg(phase)));
+        const qint64 budget = qint64(it.value().toDouble()) * 1000;
+        if (longest.value(phase) > budget) {
+            qWarning() << "Phase" << phase << "took" << longest.value(phase) / 1000 << "ms, over its budget of" << budget / 1000 << "ms";
+        }
+    }
+
+    KonqStartupTrace::self()->setFileName(QString());
+}
+
+#include "konqstartuptracetest.moc"
@@ -0,0 +1,101 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQTESTHELPERS_H
+#define KONQTESTHELPERS_H
+
+#include <QHash>
+#include <QPair>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <konqmainwindow.h>
+
+class MyKonqMainWindow : public KonqMainWindow
+{
+public:
+    MyKonqMainWindow() : KonqMainWindow() {
+        setPluginLoadingMode(KParts::PartBase::DoNotLoadPlugins); // make the test faster
+    }
+};
+
+/**
+ * Stands in for a web server: answers every request with the type and
+ * contents registered for its path. With a chunk size, the contents are
+ * written a chunk at a time, so that the page keeps reporting progress for
+ * a while; otherwise they are written at once.
+ */
+class TestHttpServer : public QTcpServer
+{
+public:
+    explicit TestHttpServer(int chunkSize = 0)
+        : m_chunkSize(chunkSize)
+    {
+        connect(this, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = nextPendingConnection()) {
+                handleConnection(socket);
+            }
+        });
+    }
+
+    void addFile(const QString &path, const QByteArray &mimeType, const QByteArray &data)
+    {
+        m_files.insert(path, qMakePair(mimeType, data));
+    }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(serverPort()).arg(path));
+    }
+
+private:
+    void handleConnection(QTcpSocket *socket)
+    {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            m_requests[socket] += socket->readAll();
+            const QByteArray request = m_requests.value(socket);
+            if (!request.contains("\r\n\r\n")) {
+                return;
+            }
+            m_requests.remove(socket);
+            const QString path = QString::fromLatin1(request.split(' ').value(1));
+            if (!m_files.contains(path)) {
+                socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+                socket->disconnectFromHost();
+                return;
+            }
+            const QPair<QByteArray, QByteArray> file = m_files.value(path);
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: " + file.first + "\r\nContent-Length: "
+                + QByteArray::number(file.second.size()) + "\r\nConnection: close\r\n\r\n");
+            writeChunk(socket, file.second, 0);
+        });
+    }
+
+    void writeChunk(QTcpSocket *socket, const QByteArray &data, int offset)
+    {
+        if (m_chunkSize <= 0) {
+            socket->write(data);
+            socket->disconnectFromHost();
+            return;
+        }
+        socket->write(data.mid(offset, m_chunkSize));
+        if (offset + m_chunkSize >= data.size()) {
+            socket->disconnectFromHost();
+            return;
+        }
+        QTimer::singleShot(0, socket, [this, socket, data, offset]() {
+            writeChunk(socket, data, offset + m_chunkSize);
+        });
+    }
+
+    const int m_chunkSize;
+    QHash<QString, QPair<QByteArray, QByteArray>> m_files;
+    QHash<QTcpSocket *, QByteArray> m_requests;
+};
+
+#endif // KONQTESTHELPERS_H
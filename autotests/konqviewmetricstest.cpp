@@ -0,0 +1,161 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <qtest_gui.h>
+#include <QDateTime>
+#include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDBusArgument>
+#include <QDBusReply>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <konqmainwindow.h>
+#include <konqsessionmanager.h>
+#include <konqview.h>
+#include "../src/konqsettingsxt.h"
+#include "konqtesthelpers.h"
+
+class KonqViewMetricsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testLocalPage();
+    void testMainWindowMetrics();
+
+private:
+    QUrl writePage();
+    static QVariantMap viewMetrics(KonqView *view);
+
+    QTemporaryDir m_tempDir;
+};
+
+QTEST_MAIN(KonqViewMetricsTest)
+
+void KonqViewMetricsTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    KonqSessionManager::self()->disableAutosave();
+    KonqSettings::setAlwaysHavePreloaded(false);
+    QVERIFY(m_tempDir.isValid());
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus");
+    }
+
+    // Read by webenginepart, which blocks the images matching the filter
+    KConfigGroup group(KSharedConfig::openConfig(), "Filter Settings");
+    group.writeEntry("Enabled", true);
+    group.writeEntry("Filter-1", "*/ads/*");
+    group.sync();
+}
+
+QUrl KonqViewMetricsTest::writePage()
+{
+    QDir dir(m_tempDir.path());
+    dir.mkdir(QStringLiteral("ads"));
+    QImage image(64, 64, QImage::Format_RGB32);
+    image.fill(Qt::blue);
+    image.save(dir.filePath(QStringLiteral("logo.png")));
+    image.save(dir.filePath(QStringLiteral("ads/banner1.png")));
+    image.save(dir.filePath(QStringLiteral("ads/banner2.png")));
+
+    QFile file(dir.filePath(QStringLiteral("page.html")));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("<html><head><title>Metrics</title></head><body>"
+                   "<img src=\"logo.png\"><img src=\"ads/banner1.png\"><img src=\"ads/banner2.png\">");
+        for (int i = 0; i < 100; ++i) {
+            file.write("<p>Paragraph " + QByteArray::number(i) + "</p>");
+        }
+        file.write("</body></html>");
+    }
+    return QUrl::fromLocalFile(file.fileName());
+}
+
+// Asks this process over D-Bus, as a monitoring tool would
+QVariantMap KonqViewMetricsTest::viewMetrics(KonqView *view)
+{
+    QDBusInterface iface(QDBusConnection::sessionBus().baseService(), view->dbusObjectPath(), QStringLiteral("org.kde.Konqueror.View"));
+    const QDBusReply<QVariantMap> reply = iface.call(QStringLiteral("metrics"));
+    if (!reply.isValid()) {
+        qWarning() << reply.error();
+    }
+    return reply.value();
+}
+
+void KonqViewMetricsTest::testLocalPage()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+
+    const QUrl url = writePage();
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    mainWindow.openUrl(nullptr, url, QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    const qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - before;
+
+    QVariantMap metrics = viewMetrics(view);
+    QCOMPARE(metrics.value(QStringLiteral("url")).toString(), url.toString());
+    QCOMPARE(metrics.value(QStringLiteral("loading")).toBool(), false);
+    QCOMPARE(metrics.value(QStringLiteral("aborted")).toBool(), false);
+    const qint64 navigationStart = metrics.value(QStringLiteral("navigationStart")).toLongLong();
+    QVERIFY(navigationStart >= before);
+    QVERIFY(navigationStart <= before + elapsed);
+    const qint64 loadFinished = metrics.value(QStringLiteral("loadFinished")).toLongLong();
+    QVERIFY(loadFinished >= 0);
+    QVERIFY(loadFinished <= elapsed);
+    QVERIFY(metrics.value(QStringLiteral("schemeHandlerTime")).toLongLong() >= 0);
+    QVERIFY(metrics.value(QStringLiteral("rendererPid")).toLongLong() > 0);
+#ifdef Q_OS_LINUX
+    QVERIFY(metrics.value(QStringLiteral("rendererMemory")).toLongLong() > 0);
+#endif
+
+    if (view->part()->property("isWebEnginePart").toBool()) {
+        QCOMPARE(metrics.value(QStringLiteral("blockedRequests")).toInt(), 2);
+        // The page itself at least
+        QVERIFY(metrics.value(QStringLiteral("bytes")).toLongLong() >= QFileInfo(url.toLocalFile()).size());
+        // The window is shown, so the page gets painted
+        QTRY_VERIFY(viewMetrics(view).value(QStringLiteral("firstPaint")).toLongLong() >= 0);
+        QVERIFY(viewMetrics(view).value(QStringLiteral("firstPaint")).toLongLong() <= elapsed + 1000);
+    }
+
+    // A new navigation starts from scratch
+    QSignalSpy spyCompleted2(view, SIGNAL(viewCompleted(KonqView*)));
+    view->openUrl(QUrl(QStringLiteral("data:text/html, <p>Hello World</p>")), QString());
+    QVERIFY(spyCompleted2.wait(20000));
+    metrics = viewMetrics(view);
+    QVERIFY(metrics.value(QStringLiteral("navigationStart")).toLongLong() >= navigationStart);
+    QCOMPARE(metrics.value(QStringLiteral("blockedRequests")).toInt(), 0);
+}
+
+void KonqViewMetricsTest::testMainWindowMetrics()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, writePage(), QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+
+    QDBusInterface iface(QDBusConnection::sessionBus().baseService(), mainWindow.dbusName(), QStringLiteral("org.kde.Konqueror.MainWindow"));
+    const QDBusReply<QVariantMap> reply = iface.call(QStringLiteral("viewMetrics"));
+    QVERIFY2(reply.isValid(), qPrintable(reply.error().message()));
+    const QVariantMap metrics = reply.value();
+    QCOMPARE(metrics.count(), mainWindow.viewCount());
+    QVERIFY(metrics.contains(view->dbusObjectPath()));
+    const QVariantMap currentViewMetrics = qdbus_cast<QVariantMap>(metrics.value(view->dbusObjectPath()));
+    QCOMPARE(currentViewMetrics.value(QStringLiteral("url")).toString(), view->url().toString());
+    QVERIFY(currentViewMetrics.value(QStringLiteral("loadFinished")).toLongLong() >= 0);
+}
+
+#include "konqviewmetricstest.moc"
@@ -21,6 +21,7 @@
 #include <konqview.h>
 #include <konqtabs.h>
 #include <konqframevisitor.h>
+#include <konqhibernator.h>
 #include <konqsessionmanager.h>
 #include <kconfiggroup.h>
 #include <kio/job.h>
@@ -40,6 +41,7 @@
 #include <QStandardPaths>
 #include <KSharedConfig>
 #include <QSignalSpy>
+#include "konqtesthelpers.h"
 
 QTEST_MAIN(ViewMgrTest)
 
@@ -206,14 +208,6 @@ void ViewMgrTest::initTestCase()
     }
 }
 
-class MyKonqMainWindow : public KonqMainWindow
-{
-public:
-    MyKonqMainWindow() : KonqMainWindow() {
-        setPluginLoadingMode(KParts::PartBase::DoNotLoadPlugins); // make the test faster
-    }
-};
-
 void ViewMgrTest::testCreateFirstView()
 {
     MyKonqMainWindow mainWindow;
@@ -904,6 +898,99 @@ void ViewMgrTest::testBreakOffTab()
     delete mainWindow2;
 }
 
+static QUrl historyPageUrl(int number)
+{
+    return QUrl(QStringLiteral("data:text/html, <p>Page %1</p>").arg(number));
+}
+
+static void openAndWait(KonqView *view, const QUrl &url)
+{
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    view->openUrl(url, url.toDisplayString());
+    QVERIFY(spyCompleted.wait(20000));
+}
+
+void ViewMgrTest::testDuplicatedHistoryIsIndependent()
+{
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, historyPageUrl(0), QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    openAndWait(view, historyPageUrl(1));
+    openAndWait(view, historyPageUrl(2));
+    QCOMPARE(view->historyLength(), 3);
+
+    KonqViewManager *viewManager = mainWindow.viewManager();
+    viewManager->duplicateTab(0);
+    QCOMPARE(DebugFrameVisitor::inspect(&mainWindow), QString("MT[FF]."));   // mainWindow, tab widget, two tabs
+    KonqView *view2 = viewManager->tabContainer()->tabAt(1)->activeChildView();
+    QVERIFY(view2);
+    QVERIFY(view2 != view);
+    QTRY_COMPARE(view2->url(), historyPageUrl(2));
+    QCOMPARE(view2->historyLength(), 3);
+    QCOMPARE(view2->historyIndex(), 2);
+    // The previous entries are shared, not copied
+    QCOMPARE(view2->historyAt(0), view->historyAt(0));
+    QCOMPARE(view2->historyAt(1), view->historyAt(1));
+
+    // Diverge: go back in the new tab and open another page from there
+    view2->go(-1);
+    QTRY_COMPARE(view2->url(), historyPageUrl(1));
+    openAndWait(view2, historyPageUrl(3));
+    QCOMPARE(view2->historyLength(), 3);
+    QCOMPARE(view2->historyIndex(), 2);
+    QCOMPARE(view2->historyAt(2)->url, historyPageUrl(3));
+
+    // The original tab doesn't see any of that
+    QCOMPARE(view->historyLength(), 3);
+    QCOMPARE(view->historyIndex(), 2);
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(view->historyAt(i)->url, historyPageUrl(i));
+    }
+    QCOMPARE(view2->historyAt(0), view->historyAt(0));
+    view->go(-1);
+    QTRY_COMPARE(view->url(), historyPageUrl(1));
+    QCOMPARE(view2->url(), historyPageUrl(3));
+    QCOMPARE(view2->historyAt(1)->url, historyPageUrl(1));
+}
+
+void ViewMgrTest::benchmarkDuplicateTab()
+{
+    const int historyLength = 100;
+    const int maximumHistoryEntries = KonqSettings::maximumHistoryEntriesPerView();
+    KonqSettings::setMaximumHistoryEntriesPerView(historyLength);
+
+    MyKonqMainWindow mainWindow;
+    mainWindow.openUrl(nullptr, historyPageUrl(0), QStringLiteral("text/html"));
+    KonqView *view = mainWindow.currentView();
+    QVERIFY(view);
+    QSignalSpy spyCompleted(view, SIGNAL(viewCompleted(KonqView*)));
+    QVERIFY(spyCompleted.wait(20000));
+    for (int i = 1; i < historyLength; ++i) {
+        openAndWait(view, historyPageUrl(i));
+    }
+    QCOMPARE(view->historyLength(), historyLength);
+
+    KonqViewManager *viewManager = mainWindow.viewManager();
+    const qint64 memoryBefore = KonqHibernator::residentMemory();
+    int duplicates = 0;
+    QBENCHMARK {
+        viewManager->duplicateTab(0);
+        ++duplicates;
+    }
+    qDebug() << "Resident memory before:" << memoryBefore / 1024 << "KiB, after:" << KonqHibernator::residentMemory() / 1024 << "KiB";
+    KonqSettings::setMaximumHistoryEntriesPerView(maximumHistoryEntries);
+
+    QCOMPARE(viewManager->tabContainer()->count(), duplicates + 1);
+    for (int i = 1; i <= duplicates; ++i) {
+        KonqView *duplicate = viewManager->tabContainer()->tabAt(i)->activeChildView();
+        QCOMPARE(duplicate->historyLength(), historyLength);
+        QCOMPARE(duplicate->historyAt(0), view->historyAt(0));
+    }
+}
+
 void ViewMgrTest::moveTabLeft()
 {
     MyKonqMainWindow mainWindow;
@@ -42,6 +42,8 @@ private Q_SLOTS:
     void testBrowserArgumentsNewTab();
 
     void testBreakOffTab();
+    void testDuplicatedHistoryIsIndependent();
+    void benchmarkDuplicateTab();
     void moveTabLeft();
 
     static void sendAllPendingResizeEvents(QWidget *);
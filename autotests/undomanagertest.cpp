@@ -6,10 +6,15 @@
 
 #include <konqcloseditem.h>
 #include <qtest_gui.h>
+#include <QDir>
+#include <QRandomGenerator>
 #include <QSignalSpy>
 #include <konqundomanager.h>
 #include <konqsessionmanager.h>
+#include <konqsessionwriter.h>
+#include <konqsettingsxt.h>
 #include <konqclosedwindowsmanager.h>
+#include <konqhibernator.h>
 
 class UndoManagerTest : public QObject
 {
@@ -19,8 +24,15 @@ private Q_SLOTS:
     void initTestCase();
     void testAddClosedTabItem();
     void testUndoLastClosedTab();
+    void testClosedTabsSpilledToDisk();
+    void testClosedTabsForgottenOverBudget();
+    void benchmarkCloseTabs_data();
+    void benchmarkCloseTabs();
 
 private:
+    KonqClosedTabItem *createClosedTab(KonqUndoManager &manager, int index);
+    static qint64 closedTabsMemoryUsage(KonqUndoManager &manager, int *spilled = nullptr);
+
     KonqClosedWindowsManager m_cwManager;
 };
 
@@ -81,4 +93,141 @@ void UndoManagerTest::testUndoLastClosedTab()
 
 }
 
+// A tab with some history, whose buffers don't compress well
+KonqClosedTabItem *UndoManagerTest::createClosedTab(KonqUndoManager &manager, int index)
+{
+    const QString url = QStringLiteral("https://www.example.org/page%1.html").arg(index);
+    KonqClosedTabItem *item = new KonqClosedTabItem(url, m_cwManager.memoryStore(),
+                                                    QStringLiteral("Page %1").arg(index), 0, manager.newCommandSerialNumber());
+    KConfigGroup &group = item->configGroup();
+    group.writeEntry("RootItem", "View0");
+    QRandomGenerator generator(index);
+    for (int i = 0; i < 10; ++i) {
+        const QString prefix = QStringLiteral("View0_HistoryItem%1_").arg(i);
+        group.writeEntry(prefix + QLatin1String("Url"), url + QLatin1Char('#') + QString::number(i));
+        group.writeEntry(prefix + QLatin1String("Title"), QStringLiteral("Page %1, item %2").arg(index).arg(i));
+        QByteArray buffer(1024, Qt::Uninitialized);
+        generator.fillRange(reinterpret_cast<quint32 *>(buffer.data()), buffer.size() / sizeof(quint32));
+        group.writeEntry(prefix + QLatin1String("Buffer"), buffer);
+    }
+    // Like the toolbar settings of a closed window
+    group.group("Toolbar mainToolBar").writeEntry("IconSize", 16 + index);
+    return item;
+}
+
+qint64 UndoManagerTest::closedTabsMemoryUsage(KonqUndoManager &manager, int *spilled)
+{
+    qint64 memoryUsage = 0;
+    for (KonqClosedItem *closedItem : manager.closedItemsList()) {
+        KonqClosedTabItem *closedTabItem = dynamic_cast<KonqClosedTabItem *>(closedItem);
+        if (!closedTabItem) {
+            continue;
+        }
+        memoryUsage += closedTabItem->memoryUsage();
+        if (spilled && closedTabItem->isSpilled()) {
+            ++*spilled;
+        }
+    }
+    return memoryUsage;
+}
+
+void UndoManagerTest::testClosedTabsSpilledToDisk()
+{
+    KonqSettings::setMaxNumClosedItems(50);
+    KonqSettings::setClosedTabsMemoryBudget(64);
+    KonqSettings::setSpillClosedTabsToDisk(true);
+    QDir(KonqClosedTabItem::spillDirectory()).removeRecursively();
+
+    KonqUndoManager manager(&m_cwManager, nullptr);
+    QList<KonqSessionWindowEntries> expected;
+    for (int i = 0; i < 20; ++i) {
+        KonqClosedTabItem *item = createClosedTab(manager, i);
+        expected.prepend(KonqSessionWriter::windowEntries(item->configGroup()));
+        manager.addClosedTabItem(item);
+    }
+
+    // All the tabs can still be reopened, but only the most recent ones are in memory
+    QCOMPARE(manager.closedItemsList().count(), 20);
+    int spilled = 0;
+    QVERIFY(closedTabsMemoryUsage(manager, &spilled) <= 64 * 1024);
+    QVERIFY(spilled > 0);
+    QVERIFY(!static_cast<KonqClosedTabItem *>(manager.closedItemsList().first())->isSpilled());
+    QVERIFY(static_cast<KonqClosedTabItem *>(manager.closedItemsList().last())->isSpilled());
+    QCOMPARE(QDir(KonqClosedTabItem::spillDirectory()).entryList(QDir::Files).count(), spilled);
+
+    // Reopening them gives back exactly what was saved
+    QList<KonqSessionWindowEntries> restored;
+    connect(&manager, &KonqUndoManager::openClosedTab, this, [&restored](const KonqClosedTabItem &item) {
+        restored.append(KonqSessionWriter::windowEntries(item.configGroup()));
+    });
+    while (!manager.closedItemsList().isEmpty()) {
+        manager.undo();
+    }
+    QCOMPARE(restored.count(), expected.count());
+    for (int i = 0; i < expected.count(); ++i) {
+        QCOMPARE(restored.at(i), expected.at(i));
+    }
+    QVERIFY(QDir(KonqClosedTabItem::spillDirectory()).entryList(QDir::Files).isEmpty());
+}
+
+void UndoManagerTest::testClosedTabsForgottenOverBudget()
+{
+    KonqSettings::setMaxNumClosedItems(50);
+    KonqSettings::setClosedTabsMemoryBudget(64);
+    KonqSettings::setSpillClosedTabsToDisk(false);
+
+    KonqUndoManager manager(&m_cwManager, nullptr);
+    KonqClosedTabItem *last = nullptr;
+    for (int i = 0; i < 20; ++i) {
+        last = createClosedTab(manager, i);
+        manager.addClosedTabItem(last);
+    }
+
+    // The oldest tabs were forgotten, the most recent one is still there
+    QVERIFY(manager.closedItemsList().count() < 20);
+    QVERIFY(!manager.closedItemsList().isEmpty());
+    QCOMPARE(manager.closedItemsList().first(), last);
+    int spilled = 0;
+    QVERIFY(closedTabsMemoryUsage(manager, &spilled) <= 64 * 1024);
+    QCOMPARE(spilled, 0);
+    manager.clearClosedItemsList(true);
+}
+
+void UndoManagerTest::benchmarkCloseTabs_data()
+{
+    QTest::addColumn<int>("budget");
+    QTest::addColumn<bool>("spill");
+
+    QTest::newRow("unbounded") << 0 << false;
+    QTest::newRow("budget") << 1024 << false;
+    QTest::newRow("spill") << 1024 << true;
+}
+
+void UndoManagerTest::benchmarkCloseTabs()
+{
+    QFETCH(int, budget);
+    QFETCH(bool, spill);
+    const int tabs = 500;
+    KonqSettings::setMaxNumClosedItems(tabs);
+    KonqSettings::setClosedTabsMemoryBudget(budget);
+    KonqSettings::setSpillClosedTabsToDisk(spill);
+
+    int kept = 0;
+    qint64 memoryUsage = 0;
+    qint64 residentMemory = 0;
+    QBENCHMARK {
+        const qint64 residentMemoryBefore = KonqHibernator::residentMemory();
+        KonqUndoManager manager(&m_cwManager, nullptr);
+        for (int i = 0; i < tabs; ++i) {
+            manager.addClosedTabItem(createClosedTab(manager, i));
+        }
+        kept = manager.closedItemsList().count();
+        memoryUsage = closedTabsMemoryUsage(manager);
+        residentMemory = KonqHibernator::residentMemory() - residentMemoryBefore;
+    }
+    qDebug() << "Closed tabs kept:" << kept << "using" << memoryUsage / 1024 << "KiB, resident memory grew by" << residentMemory / 1024 << "KiB";
+
+    KonqSettings::self()->setDefaults();
+}
+
 #include "undomanagertest.moc"
@@ -39,6 +39,8 @@
 #include <QCommandLineOption>
 #include <QTimer>
 
+#include <algorithm>
+
 #ifdef WIN32
 #include <process.h>
 #endif
@@ -93,6 +95,12 @@ extern "C" Q_DECL_EXPORT int kdemain(int argc, char **argv)
                   "            # Same as above but opens a new tab with 'url' in an existing Konqueror\n"
                   "            #   window on the current active desktop if possible.\n\n").toLocal8Bit());
 
+        puts(i18n("  kfmclient openURLs 'url' ['url' ...]\n"
+                  "  kfmclient newTabs 'url' ['url' ...]\n"
+                  "            # Same as above for several URLs at once: the first one is shown,\n"
+                  "            #   the others are opened in tabs which are only loaded\n"
+                  "            #   when activated.\n\n").toLocal8Bit());
+
         return 0;
     }
 
@@ -190,12 +198,14 @@ ClientApp::BrowserApplicationParsingResult ClientApp::parseBrowserApplicationStr
     return res;
 }
 
-bool ClientApp::launchExternalBrowser(const ClientApp::BrowserApplicationParsingResult& parseResult, const QUrl& url, bool tempFile)
+bool ClientApp::launchExternalBrowser(const ClientApp::BrowserApplicationParsingResult& parseResult, const QList<QUrl> &urls, bool tempFile)
 {
     KJob *job = nullptr;
     if (parseResult.isCommand) {
         QStringList args(parseResult.args);
-        args << url.url();
+        for (const QUrl &url : urls) {
+            args << url.url();
+        }
         KStartupInfo::appStarted();
         job =  new KIO::CommandLauncherJob(parseResult.commandOrService, args);
     } else {
@@ -205,7 +215,7 @@ bool ClientApp::launchExternalBrowser(const ClientApp::BrowserApplicationParsing
             return false;
         }
         auto launcherJob = new KIO::ApplicationLauncherJob(service);
-        launcherJob->setUrls({url});
+        launcherJob->setUrls(urls);
         if (tempFile) {
             launcherJob->setRunFlags(KIO::ApplicationLauncherJob::DeleteTemporaryFiles);
         }
@@ -219,40 +229,64 @@ bool ClientApp::launchExternalBrowser(const ClientApp::BrowserApplicationParsing
 
 bool ClientApp::createNewWindow(const QUrl &url, bool newTab, bool tempFile, const QString &mimetype)
 {
-    qCDebug(KFMCLIENT_LOG) << url << "mimetype=" << mimetype;
+    return createNewWindow(QList<QUrl>{url}, newTab, tempFile, mimetype);
+}
 
-    bool launched = false;
+bool ClientApp::createNewWindow(const QList<QUrl> &urls, bool newTab, bool tempFile, const QString &mimetype)
+{
+    qCDebug(KFMCLIENT_LOG) << urls << "mimetype=" << mimetype;
 
-    if (url.scheme().startsWith(QLatin1String("http"))) {
+    auto isWebUrl = [](const QUrl &url) {
+        return url.scheme().startsWith(QLatin1String("http"));
+    };
+    BrowserApplicationParsingResult parseRes;
+    if (std::any_of(urls.constBegin(), urls.constEnd(), isWebUrl)) {
         KConfig config(QStringLiteral("kfmclientrc"));
         KConfigGroup generalGroup(&config, "General");
         const QString browserApp = generalGroup.readEntry("BrowserApplication");
         if (!browserApp.isEmpty()) {
             //Parse the BrowserApplication string and act accordingly
-            BrowserApplicationParsingResult parseRes = parseBrowserApplicationString(browserApp);
+            parseRes = parseBrowserApplicationString(browserApp);
             qCDebug(KFMCLIENT_LOG) << "Using external browser" << (parseRes.isCommand ? "command" : "service") << browserApp;
-            if (parseRes.isValid) {
-                launched = launchExternalBrowser(parseRes, url, tempFile);
-            } else {
+            if (!parseRes.isValid) {
                 qCWarning(KFMCLIENT_LOG) << parseRes.error;
             }
         }
     }
 
-    if (!launched) {
-        needDBus();
-        // Launch Konqueror, or reuse an existing instance if possible.
-        KonqClientRequest req;
-        req.setUrl(url);
-        req.setNewTab(newTab);
-        req.setTempFile(tempFile);
-        req.setMimeType(mimetype);
-        launched = req.openUrl();
+    QList<QUrl> konqUrls;
+    QList<QUrl> webUrls;
+    for (const QUrl &url : urls) {
+        if (parseRes.isValid && isWebUrl(url)) {
+            webUrls.append(url);
+        } else {
+            konqUrls.append(url);
+        }
     }
 
+    bool launched = true;
+    if (!konqUrls.isEmpty()) {
+        launched = openInKonqueror(konqUrls, newTab, tempFile, mimetype);
+    }
+    // Last, since it runs the event loop until the browser is started
+    if (!webUrls.isEmpty() && !launchExternalBrowser(parseRes, webUrls, tempFile)) {
+        launched = openInKonqueror(webUrls, newTab, tempFile, mimetype) && launched;
+    }
     return launched;
 }
 
+bool ClientApp::openInKonqueror(const QList<QUrl> &urls, bool newTab, bool tempFile, const QString &mimetype)
+{
+    needDBus();
+    // Launch Konqueror, or reuse an existing instance if possible.
+    KonqClientRequest req;
+    req.setUrls(urls);
+    req.setNewTab(newTab);
+    req.setTempFile(tempFile);
+    req.setMimeType(mimetype);
+    return req.openUrl();
+}
+
 bool ClientApp::openProfile(const QString &profileName, const QUrl &url, const QString &mimetype)
 {
     Q_UNUSED(profileName); // the concept disappeared
@@ -301,6 +335,19 @@ bool ClientApp::doIt(const QCommandLineParser &parser)
         if (argc == 3) {
             return createNewWindow(filteredUrl(args.at(1)), command == QLatin1String("newTab"), tempFile, args.at(2));
         }
+    } else if (command == QLatin1String("openURLs") || command == QLatin1String("newTabs")) {
+        checkArgumentCount(argc, 2, 0);
+        QList<QUrl> urls;
+        for (int i = 1; i < argc; ++i) {
+            const QUrl url = filteredUrl(args.at(i));
+            if (!url.isEmpty()) {
+                urls.append(url);
+            }
+        }
+        if (urls.isEmpty()) {
+            return false;
+        }
+        return createNewWindow(urls, command == QLatin1String("newTabs"), parser.isSet(QStringLiteral("tempfile")));
     } else if (command == QLatin1String("openProfile")) { // deprecated command, kept for compat
         checkArgumentCount(argc, 2, 3);
         QUrl url;
@@ -7,6 +7,7 @@
 #ifndef KFMCLIENT_H
 #define KFMCLIENT_H
 
+#include <QList>
 #include <QObject>
 class KJob;
 class QUrl;
@@ -25,6 +26,9 @@ public:
     /** Make konqueror open a window for @p url */
     bool createNewWindow(const QUrl &url, bool newTab, bool tempFile, const QString &mimetype = QString());
 
+    /** Make konqueror open a window, or tabs, for all of @p urls at once */
+    bool createNewWindow(const QList<QUrl> &urls, bool newTab, bool tempFile, const QString &mimetype = QString());
+
     /** Make konqueror open a window for @p profile, @p url and @p mimetype, deprecated */
     bool openProfile(const QString &profile, const QUrl &url, const QString &mimetype = QString());
 
@@ -49,7 +53,9 @@ private:
 
     void delayedQuit();
 
-    bool launchExternalBrowser(const BrowserApplicationParsingResult& parseResult, const QUrl &url, bool tempFile);
+    bool openInKonqueror(const QList<QUrl> &urls, bool newTab, bool tempFile, const QString &mimetype);
+
+    bool launchExternalBrowser(const BrowserApplicationParsingResult& parseResult, const QList<QUrl> &urls, bool tempFile);
 
     //Parses the content of the BrowserApplication option
     static BrowserApplicationParsingResult parseBrowserApplicationString(const QString &str);
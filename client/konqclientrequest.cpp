@@ -31,8 +31,10 @@ class KonqClientRequestPrivate
 {
 public:
     void sendASNChange();
+    bool openUrlSeparately(const QUrl &url);
+    bool startKonqueror();
 
-    QUrl url;
+    QList<QUrl> urls;
     bool newTab = false;
     bool tempFile = false;
     QString mimeType;
@@ -52,7 +54,12 @@ KonqClientRequest::~KonqClientRequest()
 
 void KonqClientRequest::setUrl(const QUrl& url)
 {
-    d->url = url;
+    d->urls = {url};
+}
+
+void KonqClientRequest::setUrls(const QList<QUrl> &urls)
+{
+    d->urls = urls;
 }
 
 void KonqClientRequest::setNewTab(bool newTab)
@@ -85,16 +92,43 @@ void KonqClientRequestPrivate::sendASNChange()
 }
 
 bool KonqClientRequest::openUrl()
+{
+    if (d->urls.isEmpty()) {
+        return false;
+    }
+    QDBusConnection dbus = QDBusConnection::sessionBus();
+    org::kde::Konqueror::Main konq(QStringLiteral("org.kde.konqueror"), QStringLiteral("/KonqMain"), dbus);
+
+    // Konqueror knows whether to use a tab and which window, no need to ask it first
+    QDBusReply<QDBusObjectPath> reply = konq.openUrls(QUrl::toStringList(d->urls), d->mimeType, d->startup_id_str, d->newTab, d->tempFile);
+    if (reply.isValid()) {
+        d->sendASNChange();
+        return true;
+    }
+    if (reply.error().type() != QDBusError::UnknownMethod) {
+        return d->startKonqueror();
+    }
+
+    // A Konqueror older than this kfmclient is running
+    bool ok = true;
+    for (const QUrl &url : qAsConst(d->urls)) {
+        ok = d->openUrlSeparately(url) && ok;
+    }
+    return ok;
+}
+
+bool KonqClientRequestPrivate::openUrlSeparately(const QUrl &url)
 {
     QDBusConnection dbus = QDBusConnection::sessionBus();
     const QString appId = QStringLiteral("org.kde.konqueror");
     org::kde::Konqueror::Main konq(appId, QStringLiteral("/KonqMain"), dbus);
 
-    if (!d->newTab) {
+    bool useTab = newTab;
+    if (!useTab) {
         KConfig cfg(QStringLiteral("konquerorrc"));
-        d->newTab = cfg.group("FMSettings").readEntry("KonquerorTabforExternalURL", false);
+        useTab = cfg.group("FMSettings").readEntry("KonquerorTabforExternalURL", false);
     }
-    if (d->newTab) {
+    if (useTab) {
         QDBusObjectPath foundObj;
         QDBusReply<QDBusObjectPath> windowReply = konq.windowForTab();
         if (windowReply.isValid()) {
@@ -102,45 +136,51 @@ bool KonqClientRequest::openUrl()
             // "/" is the indicator for "no object found", since we can't use an empty path
             if (path.path() != QLatin1String("/")) {
                 org::kde::Konqueror::MainWindow konqWindow(appId, path.path(), dbus);
-                QDBusReply<void> newTabReply = konqWindow.newTabASNWithMimeType(d->url.toString(), d->mimeType, d->startup_id_str, d->tempFile);
+                QDBusReply<void> newTabReply = konqWindow.newTabASNWithMimeType(url.toString(), mimeType, startup_id_str, tempFile);
                 if (newTabReply.isValid()) {
-                    d->sendASNChange();
+                    sendASNChange();
                     return true;
                 }
             }
         }
     }
 
-    QDBusReply<QDBusObjectPath> reply = konq.createNewWindow(d->url.toString(), d->mimeType, d->startup_id_str, d->tempFile);
+    QDBusReply<QDBusObjectPath> reply = konq.createNewWindow(url.toString(), mimeType, startup_id_str, tempFile);
     if (reply.isValid()) {
-        d->sendASNChange();
+        sendASNChange();
         return true;
-    } else {
-        // pass kfmclient's startup id to konqueror using kshell
-        KStartupInfoId id;
-        id.initId(d->startup_id_str);
-        id.setupStartupEnv();
-        QStringList args;
-        args << QStringLiteral("konqueror");
-        if (!d->mimeType.isEmpty()) {
-            args << QStringLiteral("--mimetype") << d->mimeType;
-        }
-        if (d->tempFile) {
-            args << QStringLiteral("-tempfile");
-        }
-        args << d->url.toEncoded();
-        qint64 pid;
+    }
+    return false;
+}
+
+bool KonqClientRequestPrivate::startKonqueror()
+{
+    // pass kfmclient's startup id to konqueror using kshell
+    KStartupInfoId id;
+    id.initId(startup_id_str);
+    id.setupStartupEnv();
+    QStringList args;
+    args << QStringLiteral("konqueror");
+    if (!mimeType.isEmpty()) {
+        args << QStringLiteral("--mimetype") << mimeType;
+    }
+    if (tempFile) {
+        args << QStringLiteral("-tempfile");
+    }
+    for (const QUrl &url : qAsConst(urls)) {
+        args << url.toEncoded();
+    }
+    qint64 pid;
 #ifdef Q_OS_WIN
-        const bool ok = QProcess::startDetached(QStringLiteral("kwrapper5"), args, QString(), &pid);
+    const bool ok = QProcess::startDetached(QStringLiteral("kwrapper5"), args, QString(), &pid);
 #else
-        const bool ok = QProcess::startDetached(QStringLiteral("kshell5"), args, QString(), &pid);
+    const bool ok = QProcess::startDetached(QStringLiteral("kshell5"), args, QString(), &pid);
 #endif
-        KStartupInfo::resetStartupEnv();
-        if (ok) {
-            qCDebug(KFMCLIENT_LOG) << "Konqueror started, pid=" << pid;
-        } else {
-            qCWarning(KFMCLIENT_LOG) << "Error starting konqueror";
-        }
-        return ok;
+    KStartupInfo::resetStartupEnv();
+    if (ok) {
+        qCDebug(KFMCLIENT_LOG) << "Konqueror started, pid=" << pid;
+    } else {
+        qCWarning(KFMCLIENT_LOG) << "Error starting konqueror";
     }
+    return ok;
 }
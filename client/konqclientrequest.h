@@ -7,6 +7,7 @@
 #ifndef KONQ_CLIENT_REQUEST_H
 #define KONQ_CLIENT_REQUEST_H
 
+#include <QList>
 #include <QScopedPointer>
 
 class KonqClientRequestPrivate;
@@ -17,6 +18,8 @@ class QUrl;
  * in order to create a new window or tab for a URL.
  *
  * Usage: each instance of KonqClientRequest is a separate request.
+ * All the URLs of a request are handed to a running Konqueror in a single
+ * call, which only loads the first one right away.
  */
 class KonqClientRequest
 {
@@ -34,6 +37,11 @@ public:
      * Sets the URL to open (mandatory)
      */
     void setUrl(const QUrl& url);
+    /**
+     * Sets the URLs to open, instead of a single one with setUrl().
+     * The first one is shown, the others are opened in tabs behind it.
+     */
+    void setUrls(const QList<QUrl> &urls);
     /**
      * Sets whether to open the URL in a new tab (optional, defaults to false)
      */
@@ -8,31 +8,10 @@
 #include <QDataStream>
 
 KonqHistoryEntry::KonqHistoryEntry()
-    : numberOfTimesVisited(1), d(nullptr)
+    : numberOfTimesVisited(1)
 {
 }
 
-KonqHistoryEntry::~KonqHistoryEntry()
-{
-}
-
-KonqHistoryEntry::KonqHistoryEntry(const KonqHistoryEntry &other)
-{
-    operator=(other);
-}
-
-KonqHistoryEntry &KonqHistoryEntry::operator=(const KonqHistoryEntry &other)
-{
-    url = other.url;
-    typedUrl = other.typedUrl;
-    title = other.title;
-    numberOfTimesVisited = other.numberOfTimesVisited;
-    firstVisited = other.firstVisited;
-    lastVisited = other.lastVisited;
-    d = nullptr;
-    return *this;
-}
-
 bool KonqHistoryEntry::operator==(const KonqHistoryEntry &entry) const
 {
     return url == entry.url &&
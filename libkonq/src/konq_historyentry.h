@@ -12,14 +12,17 @@
 #include <QUrl>
 #include "libkonq_export.h"
 
+/**
+ * One entry of the history.
+ *
+ * This is a plain value class: copies share the (implicitly shared) url,
+ * strings and dates. KonqHistoryProvider doesn't keep its entries in this
+ * form, but builds them when they are asked for.
+ */
 class LIBKONQ_EXPORT KonqHistoryEntry
 {
 public:
     KonqHistoryEntry();
-    KonqHistoryEntry(const KonqHistoryEntry &other);
-    ~KonqHistoryEntry();
-
-    KonqHistoryEntry &operator=(const KonqHistoryEntry &entry);
 
     QUrl url;
     QString typedUrl;
@@ -34,10 +37,6 @@ public:
     enum Flags { NoFlags = 0, MarshalUrlAsStrings = 1 };
     void load(QDataStream &s, Flags flags);
     void save(QDataStream &s, Flags flags) const;
-
-private:
-    class Private;
-    Private *d;
 };
 
 #ifdef MAKE_KONQ_LIB
@@ -67,5 +66,7 @@ public:
     void removeEntry(const QUrl &url);
 };
 
+Q_DECLARE_METATYPE(KonqHistoryList)
+
 #endif /* KONQ_HISTORYENTRY_H */
 
@@ -6,32 +6,85 @@
 
 #include "konq_historyloader_p.h"
 #include "konq_historyentry.h"
+#include "konq_historystore_p.h"
 
 #include <QDataStream>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QVector>
+#include <QtEndian>
 
 #include <zlib.h> // for crc32
 
 #include "libkonq_debug.h"
 
+// V4: version, crc, QByteArray with all the entries (QUrl marshalling)
+static const quint32 s_legacyHistoryVersion = 4;
+// V5: version, count, then for each entry: size, crc, lastVisited, entry
+static const quint32 s_headerSize = 2 * sizeof(quint32);
+static const quint32 s_recordHeaderSize = 2 * sizeof(quint32) + sizeof(qint64);
+static const QDataStream::Version s_streamVersion = QDataStream::Qt_5_12;
+
 class KonqHistoryLoaderPrivate
 {
 public:
+    KonqHistoryLoaderPrivate()
+        : m_begin(nullptr), m_nextRecord(0)
+    {
+    }
+
+    bool loadLegacyHistory(QFile &file);
+    bool loadMappedHistory(int maxCount, int maxAgeDays);
+    void unmap();
+
+    struct Record {
+        const uchar *data;
+        quint32 size;
+        quint32 crc;
+        qint64 lastVisited;
+    };
+
     KonqHistoryList m_history;
+
+    // The current format: the mapped file and the records still to decode
+    QFile m_file;
+    QByteArray m_contents; // if the file can't be mapped
+    const uchar *m_begin;
+    QVector<Record> m_records;
+    int m_nextRecord;
 };
 
 KonqHistoryLoader::KonqHistoryLoader(QObject *parent)
     : QObject(parent), d(new KonqHistoryLoaderPrivate)
 {
-    loadHistory();
 }
 
 KonqHistoryLoader::~KonqHistoryLoader()
 {
+    d->unmap();
     delete d;
 }
 
+void KonqHistoryLoaderPrivate::unmap()
+{
+    if (m_begin && m_contents.isEmpty()) {
+        m_file.unmap(const_cast<uchar *>(m_begin));
+    }
+    m_begin = nullptr;
+    m_contents.clear();
+    m_file.close();
+    m_records.clear();
+    m_nextRecord = 0;
+}
+
+static QString historyFileName()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/konqueror/konq_history");
+}
+
 /**
  * Ensures that the items are sorted by the lastVisited date
  * (oldest goes first)
@@ -41,12 +94,20 @@ static bool lastVisitedOrder(const KonqHistoryEntry &lhs, const KonqHistoryEntry
     return lhs.lastVisited < rhs.lastVisited;
 }
 
-bool KonqHistoryLoader::loadHistory()
+// Entries without a date never expire, see KonqHistoryProviderPrivate::adjustSize()
+static qint64 lastVisitedKey(const QDateTime &lastVisited)
+{
+    return lastVisited.isValid() ? lastVisited.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+}
+
+bool KonqHistoryLoader::loadHistory(int maxCount, int maxAgeDays)
 {
     d->m_history.clear();
+    d->unmap();
 
-    const QString filename = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/konqueror/konq_history");
-    QFile file(filename);
+    const QString filename = historyFileName();
+    QFile &file = d->m_file;
+    file.setFileName(filename);
     if (!file.open(QIODevice::ReadOnly)) {
         if (file.exists()) {
             qCWarning(LIBKONQ_LOG) << "Can't open" << filename;
@@ -54,6 +115,142 @@ bool KonqHistoryLoader::loadHistory()
         return false;
     }
 
+    if (file.atEnd()) {
+        return true;
+    }
+
+    quint32 version = 0;
+    if (file.peek(reinterpret_cast<char *>(&version), sizeof(version)) != sizeof(version)) {
+        qCWarning(LIBKONQ_LOG) << "The history file is truncated, aborting loading";
+        return false;
+    }
+    version = qFromBigEndian(version);
+
+    if (version == quint32(historyVersion())) {
+        return d->loadMappedHistory(maxCount, maxAgeDays);
+    }
+    const bool ok = d->loadLegacyHistory(file);
+    file.close();
+    return ok;
+}
+
+static bool recordOrder(const KonqHistoryLoaderPrivate::Record &lhs, const KonqHistoryLoaderPrivate::Record &rhs)
+{
+    return lhs.lastVisited < rhs.lastVisited;
+}
+
+bool KonqHistoryLoaderPrivate::loadMappedHistory(int maxCount, int maxAgeDays)
+{
+    const qint64 size = m_file.size();
+    if (size < s_headerSize) {
+        qCWarning(LIBKONQ_LOG) << "The history file is truncated, aborting loading";
+        return false;
+    }
+
+#ifdef Q_OS_UNIX
+    // Map the file instead of reading it: only the records we actually
+    // decode are paged in. Saving replaces the file rather than writing
+    // into it, and the mapping keeps the replaced file alive, so it stays
+    // valid until everything is decoded.
+    m_begin = m_file.map(0, size);
+#endif
+    if (!m_begin) {
+        // Elsewhere, a mapped or open file can't be replaced by a save:
+        // read it all and close it right away
+        m_contents = m_file.readAll();
+        m_file.close();
+        if (m_contents.size() != size) {
+            qCWarning(LIBKONQ_LOG) << "Can't read the history file, aborting loading";
+            m_contents.clear();
+            return false;
+        }
+        m_begin = reinterpret_cast<const uchar *>(m_contents.constData());
+    }
+    const uchar *end = m_begin + size;
+
+    // Find the records, without decoding anything
+    const quint32 count = qFromBigEndian<quint32>(m_begin + sizeof(quint32));
+    m_records.reserve(int(qMin<qint64>(count, size / s_recordHeaderSize)));
+    bool sorted = true;
+    const uchar *pos = m_begin + s_headerSize;
+    while (end - pos >= s_recordHeaderSize) {
+        Record record;
+        record.size = qFromBigEndian<quint32>(pos);
+        record.crc = qFromBigEndian<quint32>(pos + sizeof(quint32));
+        record.lastVisited = qFromBigEndian<qint64>(pos + 2 * sizeof(quint32));
+        record.data = pos + s_recordHeaderSize;
+        if (record.size > quint64(end - record.data)) {
+            qCWarning(LIBKONQ_LOG) << "The history file is truncated";
+            break;
+        }
+        if (sorted && !m_records.isEmpty() && recordOrder(record, m_records.last())) {
+            sorted = false;
+        }
+        m_records.append(record);
+        pos = record.data + record.size;
+    }
+
+    // Entries updated since they were added are out of order. Sort the
+    // headers, not the entries, before deciding which ones expire.
+    if (!sorted) {
+        std::stable_sort(m_records.begin(), m_records.end(), recordOrder);
+    }
+
+    // The ones which would be expired right away are now at the front and
+    // never need to be decoded.
+    m_nextRecord = qMax(0, m_records.count() - maxCount);
+    if (maxAgeDays > 0) {
+        const qint64 expirationDate = QDateTime(QDate::currentDate().addDays(-maxAgeDays)).toMSecsSinceEpoch();
+        while (m_nextRecord < m_records.count() && m_records.at(m_nextRecord).lastVisited < expirationDate) {
+            ++m_nextRecord;
+        }
+    }
+    if (m_nextRecord == m_records.count()) {
+        unmap();
+    }
+
+    //qCDebug(LIBKONQ_LOG) << "indexed:" << m_records.count() - m_nextRecord << "entries.";
+    return true;
+}
+
+int KonqHistoryLoader::pendingCount() const
+{
+    return d->m_records.count() - d->m_nextRecord;
+}
+
+KonqHistoryList KonqHistoryLoader::decodeEntries(int count)
+{
+    KonqHistoryList entries;
+    const int last = d->m_nextRecord + qMin(count, pendingCount());
+    entries.reserve(last - d->m_nextRecord);
+    for (; d->m_nextRecord < last; ++d->m_nextRecord) {
+        const KonqHistoryLoaderPrivate::Record &record = d->m_records.at(d->m_nextRecord);
+        if (crc32(0, record.data, record.size) != record.crc) {
+            qCWarning(LIBKONQ_LOG) << "Skipping corrupted history entry" << d->m_nextRecord;
+            continue;
+        }
+
+        // No copy of the record data, the entry copies what it needs
+        const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(record.data), record.size);
+        QDataStream stream(data);
+        stream.setVersion(s_streamVersion);
+        KonqHistoryEntry entry;
+        entry.load(stream, KonqHistoryEntry::NoFlags);
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(LIBKONQ_LOG) << "Skipping invalid history entry" << d->m_nextRecord;
+            continue;
+        }
+        entries.append(entry);
+    }
+
+    if (pendingCount() == 0) {
+        d->unmap();
+    }
+    return entries;
+}
+
+bool KonqHistoryLoaderPrivate::loadLegacyHistory(QFile &file)
+{
     QDataStream fileStream(&file);
     QByteArray data; // only used for version == 2
     // we construct the stream object now but fill in the data later.
@@ -101,7 +298,7 @@ bool KonqHistoryLoader::loadHistory()
         }
 #endif
 
-        if (historyVersion() != int(version) || (crcChecked && !crcOk)) {
+        if (version != s_legacyHistoryVersion || (crcChecked && !crcOk)) {
             qCWarning(LIBKONQ_LOG) << "The history version doesn't match, aborting loading";
             file.close();
             return false;
@@ -111,12 +308,12 @@ bool KonqHistoryLoader::loadHistory()
             KonqHistoryEntry entry;
             entry.load(*stream, flags);
             // qCDebug(LIBKONQ_LOG) << "loaded entry:" << entry.url << ", Title:" << entry.title;
-            d->m_history.append(entry);
+            m_history.append(entry);
         }
 
         //qCDebug(LIBKONQ_LOG) << "loaded:" << m_history.count() << "entries.";
 
-        std::sort(d->m_history.begin(), d->m_history.end(), lastVisitedOrder);
+        std::sort(m_history.begin(), m_history.end(), lastVisitedOrder);
     }
 
     // Theoretically, we should emit update() here, but as we only ever
@@ -130,7 +327,36 @@ const KonqHistoryList &KonqHistoryLoader::entries() const
     return d->m_history;
 }
 
+bool KonqHistoryLoader::saveHistory(const KonqHistoryStore &history)
+{
+    const QString filename = historyFileName();
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(LIBKONQ_LOG) << "Can't open" << file.fileName() << "for saving history";
+        return false;
+    }
+
+    QDataStream fileStream(&file);
+    fileStream << quint32(historyVersion()) << quint32(history.count());
+
+    // Written straight from the store, without building the entries
+    QByteArray data;
+    for (int i = 0; i < history.count(); ++i) {
+        data.clear();
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(s_streamVersion);
+        history.save(i, stream);
+
+        const quint32 crc = crc32(0, reinterpret_cast<const unsigned char *>(data.constData()), data.size());
+        fileStream << quint32(data.size()) << crc << lastVisitedKey(history.lastVisited(i));
+        fileStream.writeRawData(data.constData(), data.size());
+    }
+
+    return file.commit();
+}
+
 int KonqHistoryLoader::historyVersion()
 {
-    return 4;
+    return 5;
 }
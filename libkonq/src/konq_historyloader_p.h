@@ -10,12 +10,22 @@
 #include "libkonq_export.h"
 #include <QObject>
 
+#include <limits>
+
 class KonqHistoryList;
 class KonqHistoryLoaderPrivate;
+class KonqHistoryStore;
 
 /**
  * @internal
- * This class loads the Konqueror history file.
+ * This class loads and saves the Konqueror history file.
+ *
+ * The current (V5) format is a header followed by one record per entry,
+ * mostly sorted by lastVisited (oldest first). Each record has its own size,
+ * checksum and lastVisited date in front of the serialized entry, so the
+ * file can be memory-mapped, and loading it only reads these headers.
+ * The entries are decoded on demand by decodeEntries(), and those which
+ * would expire right away never are.
  * @since 4.3
  */
 class KonqHistoryLoader : public QObject
@@ -28,15 +38,40 @@ public:
 
     /**
      * Load the history. No need to call this more than once...
+     *
+     * Only the newest @p maxCount entries which are not older than
+     * @p maxAgeDays days (0 means no limit) are kept. Files in the current
+     * format stay mapped, and their entries are only decoded by
+     * decodeEntries().
      */
-    bool loadHistory();
+    bool loadHistory(int maxCount = std::numeric_limits<int>::max(), int maxAgeDays = 0);
 
     /**
-     * @returns the list of all history entries, sorted by date
-     * (oldest entries first)
+     * @returns the entries decoded while loading, sorted by date
+     * (oldest entries first). Only files in older formats are decoded
+     * while loading.
      */
     const KonqHistoryList &entries() const;
 
+    /**
+     * @returns the number of entries still to be decoded by decodeEntries()
+     */
+    int pendingCount() const;
+
+    /**
+     * Decodes the next @p count entries, oldest first, and returns them.
+     * Corrupted entries are skipped. The file is unmapped once all of them
+     * are decoded.
+     */
+    KonqHistoryList decodeEntries(int count = std::numeric_limits<int>::max());
+
+    /**
+     * Saves @p history in the current file format. It should be sorted by
+     * date (oldest entries first), entries updated in place are sorted
+     * again when loading.
+     */
+    static bool saveHistory(const KonqHistoryStore &history);
+
     static int historyVersion();
 
 private:
@@ -10,17 +10,17 @@
 #include <kconfiggroup.h>
 #include <ksharedconfig.h>
 #include "konq_historyloader_p.h"
+#include "konq_historystore_p.h"
 #include <KSharedConfig>
 
 #include <QDBusConnection>
+#include <QDBusConnectionInterface>
 #include <QDBusContext>
 #include <QDBusMessage>
 #include <QDataStream>
-#include <QDir>
-#include <QSaveFile>
-#include <QStandardPaths>
-
-#include <zlib.h> // for crc32
+#include <QHash>
+#include <QSet>
+#include <QTimer>
 
 #include "libkonq_debug.h"
 
@@ -37,11 +37,50 @@ public:
      */
     void adjustSize();
 
+    /**
+     * Removes the @p count first (oldest) entries in one go and emits
+     * a single entriesRemoved() signal for all of them.
+     */
+    void removeExpiredEntries(int count);
+
     /**
      * Saves the entire history.
      */
     bool saveHistory();
 
+    /**
+     * Decodes the entries which the loader didn't decode yet. Everything
+     * reading or changing the history calls this first.
+     */
+    void ensureLoaded();
+
+    /**
+     * Appends @p entries, freshly decoded, to the history.
+     */
+    void appendLoaded(const KonqHistoryList &entries);
+
+    /**
+     * Removes the entry at @p index and emits entryRemoved() for it.
+     */
+    void removeEntry(int index);
+
+    /**
+     * Queues @p entry for the next notifyHistoryEntries broadcast.
+     * Several visits of the same url are merged into one entry.
+     */
+    void queueBroadcast(const KonqHistoryEntry &entry);
+
+    /**
+     * Adds (or updates) the entry @p e received via D-Bus to the history.
+     */
+    void addBroadcastEntry(const KonqHistoryEntry &e, bool isSender);
+
+    /**
+     * Adds the queued entries to the history and saves it, for when the
+     * broadcast would come back too late, at shutdown.
+     */
+    void saveOutgoing();
+
 Q_SIGNALS: // DBUS methods/signals,  they have to match org.kde.Konqueror.HistoryManager.xml
     friend class KonqHistoryProvider;
     /**
@@ -55,6 +94,14 @@ Q_SIGNALS: // DBUS methods/signals,  they have to match org.kde.Konqueror.Histor
      */
     void notifyHistoryEntry(const QByteArray &historyEntry);
 
+    /**
+     * Like notifyHistoryEntry, but for all the entries added during the
+     * last broadcast interval at once.
+     *
+     * @param historyEntries the entries, one after the other
+     */
+    void notifyHistoryEntries(const QByteArray &historyEntries);
+
     /**
      * Called when the configuration of the maximum count changed.
      * Called via DBUS by some config-module
@@ -84,8 +131,18 @@ Q_SIGNALS: // DBUS methods/signals,  they have to match org.kde.Konqueror.Histor
      */
     void notifyRemoveList(const QStringList &urls);
 
+public Q_SLOTS:
+    /**
+     * Broadcasts all the queued entries.
+     */
+    void flushBroadcast();
+
+private Q_SLOTS:
+    void slotDecodeEntries();
+
 private Q_SLOTS: // connected to DBUS signals
     void slotNotifyHistoryEntry(const QByteArray &historyEntry);
+    void slotNotifyHistoryEntries(const QByteArray &historyEntries);
     void slotNotifyMaxCount(int count);
     void slotNotifyMaxAge(int days);
     void slotNotifyClear();
@@ -100,14 +157,32 @@ public:
         return KSharedConfig::openConfig(QStringLiteral("konquerorrc"));
     }
 
-    KonqHistoryList m_history;
+    KonqHistoryStore m_history;
+    // The entries not decoded yet, decoded while idle or when needed
+    KonqHistoryLoader *m_loader;
+    QTimer m_decodeTimer;
     int m_maxCount;   // maximum of history entries
     int m_maxAgeDays; // maximum age of a history entry
+
+    KonqHistoryList m_outgoing; // entries waiting for the next broadcast
+    QHash<QUrl, int> m_outgoingIndex; // url -> position in m_outgoing
+    QTimer m_broadcastTimer;
+    bool m_inBatch; // true while handling notifyHistoryEntries
+    bool m_saveAfterBatch;
+    // Instances which only know notifyHistoryEntry, i.e. older versions
+    QSet<QString> m_legacyPeers;
+
     KonqHistoryProvider *q;
 };
 
+// Visits within this interval are sent to the other instances in one message
+static const int s_broadcastInterval = 100;
+// Beyond this size a broadcast is split into several messages, to stay well
+// below the D-Bus message size limit
+static const int s_maxBroadcastSize = 1024 * 1024;
+
 KonqHistoryProviderPrivate::KonqHistoryProviderPrivate(KonqHistoryProvider *qq)
-    : QObject(), QDBusContext(), q(qq)
+    : QObject(), QDBusContext(), m_loader(nullptr), m_inBatch(false), m_saveAfterBatch(false), q(qq)
 {
     // defaults
     KConfigGroup cs(konqConfig(), "HistorySettings");
@@ -122,10 +197,19 @@ KonqHistoryProviderPrivate::KonqHistoryProviderPrivate(KonqHistoryProvider *qq)
     dbus.registerObject(dbusPath, this, QDBusConnection::ExportAllSignals);
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyClear"), this, SLOT(slotNotifyClear()));
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyHistoryEntry"), this, SLOT(slotNotifyHistoryEntry(QByteArray)));
+    dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyHistoryEntries"), this, SLOT(slotNotifyHistoryEntries(QByteArray)));
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyMaxAge"), this, SLOT(slotNotifyMaxAge(int)));
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyMaxCount"), this, SLOT(slotNotifyMaxCount(int)));
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyRemove"), this, SLOT(slotNotifyRemove(QString)));
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyRemoveList"), this, SLOT(slotNotifyRemoveList(QStringList)));
+
+    m_broadcastTimer.setSingleShot(true);
+    m_broadcastTimer.setInterval(s_broadcastInterval);
+    connect(&m_broadcastTimer, &QTimer::timeout, this, &KonqHistoryProviderPrivate::flushBroadcast);
+
+    // Decodes the history a chunk at a time, without blocking the event loop
+    m_decodeTimer.setInterval(0);
+    connect(&m_decodeTimer, &QTimer::timeout, this, &KonqHistoryProviderPrivate::slotDecodeEntries);
 }
 
 ////
@@ -137,61 +221,153 @@ KonqHistoryProvider::KonqHistoryProvider(QObject *parent)
 
 KonqHistoryProvider::~KonqHistoryProvider()
 {
+    // We won't be listening anymore when our own broadcast comes back
+    d->saveOutgoing();
+    d->flushBroadcast();
+    delete d->m_loader;
     delete d;
 }
 
-const KonqHistoryList &KonqHistoryProvider::entries() const
+KonqHistoryList KonqHistoryProvider::entries() const
 {
-    return d->m_history;
+    d->ensureLoaded();
+    return d->m_history.entries();
+}
+
+KonqHistoryList KonqHistoryProvider::lastEntries(int count) const
+{
+    d->ensureLoaded();
+    KonqHistoryList entries;
+    for (int i = qMax(0, d->m_history.count() - count); i < d->m_history.count(); ++i) {
+        entries.append(d->m_history.at(i));
+    }
+    return entries;
+}
+
+KonqHistoryEntry KonqHistoryProvider::findEntry(const QUrl &url) const
+{
+    d->ensureLoaded();
+    const int index = d->m_history.indexOf(url);
+    return index < 0 ? KonqHistoryEntry() : d->m_history.at(index);
+}
+
+int KonqHistoryProvider::entryCount() const
+{
+    return d->m_history.count() + (d->m_loader ? d->m_loader->pendingCount() : 0);
 }
 
 bool KonqHistoryProvider::loadHistory()
 {
-    KonqHistoryLoader loader;
-    if (!loader.loadHistory()) {
+    delete d->m_loader;
+    d->m_loader = nullptr;
+    d->m_decodeTimer.stop();
+    d->m_history.clear();
+
+    KonqHistoryLoader *loader = new KonqHistoryLoader;
+    if (!loader->loadHistory(d->m_maxCount, d->m_maxAgeDays)) {
+        delete loader;
         return false;
     }
 
-    d->m_history = loader.entries();
-
-    d->adjustSize();
+    d->appendLoaded(loader->entries());
+    if (loader->pendingCount() > 0) {
+        // Decoding is left for later, it isn't needed to show the first window
+        d->m_loader = loader;
+        d->m_decodeTimer.start();
+    } else {
+        delete loader;
+        d->adjustSize();
+    }
+    return true;
+}
 
-    QListIterator<KonqHistoryEntry> it(d->m_history);
-    while (it.hasNext()) {
-        const KonqHistoryEntry &entry = it.next();
+void KonqHistoryProviderPrivate::slotDecodeEntries()
+{
+    // Small enough not to delay user input noticeably
+    static const int chunkSize = 2000;
+    if (!m_loader) {
+        m_decodeTimer.stop();
+        return;
+    }
+    appendLoaded(m_loader->decodeEntries(chunkSize));
+    if (m_loader->pendingCount() == 0) {
+        m_decodeTimer.stop();
+        delete m_loader;
+        m_loader = nullptr;
+        adjustSize();
+    }
+}
 
-        // Fill the entries into KParts::HistoryProvider.
-        const QString urlString = entry.url.url();
-        KParts::HistoryProvider::insert(urlString);
-        // DF: also insert the "pretty" version if different
-        // This helps getting 'visited' links on websites which don't use fully-escaped urls.
-        const QString prettyUrlString = entry.url.toDisplayString();
-        if (urlString != prettyUrlString) {
-            KParts::HistoryProvider::insert(prettyUrlString);
-        }
+void KonqHistoryProviderPrivate::ensureLoaded()
+{
+    if (m_loader) {
+        m_decodeTimer.stop();
+        KonqHistoryLoader *loader = m_loader;
+        m_loader = nullptr;
+        appendLoaded(loader->decodeEntries());
+        delete loader;
+        adjustSize();
     }
+}
 
-    return true;
+void KonqHistoryProviderPrivate::appendLoaded(const KonqHistoryList &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+    // The store also indexes the urls, instead of the string dict of
+    // KParts::HistoryProvider which kept one or two extra copies of every url
+    m_history.reserve(m_history.count() + entries.count());
+    for (const KonqHistoryEntry &entry : entries) {
+        m_history.append(entry);
+    }
+    emit q->entriesLoaded(entries);
 }
 
 void KonqHistoryProviderPrivate::adjustSize()
 {
+    ensureLoaded();
     if (m_history.isEmpty()) {
         return;
     }
 
-    KonqHistoryEntry entry = m_history.first();
-    const QDateTime expirationDate(QDate::currentDate().addDays(-m_maxAgeDays));
+    // The list is sorted by lastVisited (oldest first), so the entries to
+    // expire always form a contiguous range at the front of the list.
+    // Determine that range first instead of removing one entry at a time.
+    // Entries visited again since loading stay in place, and at worst keep
+    // older ones until the next start sorts them.
+    int expired = qMax(0, m_history.count() - m_maxCount);
+    if (m_maxAgeDays > 0) {
+        const QDateTime expirationDate(QDate::currentDate().addDays(-m_maxAgeDays));
+        while (expired < m_history.count()) {
+            const QDateTime lastVisited = m_history.lastVisited(expired);
+            if (!lastVisited.isValid() || lastVisited >= expirationDate) {
+                break;
+            }
+            ++expired;
+        }
+    }
 
-    while (m_history.count() > qint32(m_maxCount) ||
-            (m_maxAgeDays > 0 && entry.lastVisited.isValid() && entry.lastVisited < expirationDate)) { // i.e. entry is expired
-        q->removeEntry(m_history.begin());
+    if (expired == 0) {
+        return;
+    }
+    if (expired == 1) {
+        removeEntry(0);
+        return;
+    }
+    removeExpiredEntries(expired);
+}
 
-        if (m_history.isEmpty()) {
-            break;
-        }
-        entry = m_history.first();
+void KonqHistoryProviderPrivate::removeExpiredEntries(int count)
+{
+    KonqHistoryList removed;
+    removed.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        removed.append(m_history.at(i));
     }
+
+    m_history.removeFirst(count);
+    emit q->entriesRemoved(removed);
 }
 
 static QString dbusService()
@@ -201,24 +377,98 @@ static QString dbusService()
 
 void KonqHistoryProvider::emitAddToHistory(const KonqHistoryEntry &entry)
 {
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    entry.save(stream, KonqHistoryEntry::MarshalUrlAsStrings);
-    stream << dbusService();
-    // Protection against very long urls (like data:)
-    if (data.size() > 4096) {
+    d->queueBroadcast(entry);
+}
+
+void KonqHistoryProviderPrivate::queueBroadcast(const KonqHistoryEntry &entry)
+{
+    const QHash<QUrl, int>::const_iterator it = m_outgoingIndex.constFind(entry.url);
+    if (it == m_outgoingIndex.constEnd()) {
+        m_outgoingIndex.insert(entry.url, m_outgoing.count());
+        m_outgoing.append(entry);
+    } else {
+        // Merge the same way the receivers would apply both entries
+        KonqHistoryEntry &queued = m_outgoing[it.value()];
+        if (!entry.typedUrl.isEmpty()) {
+            queued.typedUrl = entry.typedUrl;
+        }
+        if (!entry.title.isEmpty()) {
+            queued.title = entry.title;
+        }
+        queued.numberOfTimesVisited += entry.numberOfTimesVisited;
+        queued.lastVisited = entry.lastVisited;
+    }
+
+    if (!m_broadcastTimer.isActive()) {
+        m_broadcastTimer.start();
+    }
+}
+
+void KonqHistoryProviderPrivate::flushBroadcast()
+{
+    m_broadcastTimer.stop();
+    if (m_outgoing.isEmpty()) {
         return;
     }
-    emit d->notifyHistoryEntry(data);
+
+    // Same format as notifyHistoryEntry, see slotNotifyHistoryEntry
+    QByteArray data;
+    for (const KonqHistoryEntry &entry : qAsConst(m_outgoing)) {
+        QByteArray entryData;
+        QDataStream stream(&entryData, QIODevice::WriteOnly);
+        entry.save(stream, KonqHistoryEntry::MarshalUrlAsStrings);
+        if (!data.isEmpty() && data.size() + entryData.size() > s_maxBroadcastSize) {
+            emit notifyHistoryEntries(data);
+            data.clear();
+        }
+        data += entryData;
+    }
+    if (!data.isEmpty()) {
+        emit notifyHistoryEntries(data);
+    }
+
+    // Older instances only listen to notifyHistoryEntry. They are noticed
+    // when they broadcast a visit themselves. Forget those which quit, and
+    // keep sending them one entry per message as long as there are any.
+    QDBusConnectionInterface *bus = QDBusConnection::sessionBus().interface();
+    for (QSet<QString>::iterator it = m_legacyPeers.begin(); it != m_legacyPeers.end();) {
+        if (bus && bus->isServiceRegistered(*it)) {
+            ++it;
+        } else {
+            it = m_legacyPeers.erase(it);
+        }
+    }
+    if (!m_legacyPeers.isEmpty()) {
+        for (const KonqHistoryEntry &entry : qAsConst(m_outgoing)) {
+            QByteArray entryData;
+            QDataStream stream(&entryData, QIODevice::WriteOnly);
+            entry.save(stream, KonqHistoryEntry::MarshalUrlAsStrings);
+            stream << dbusService();
+            // Tells the instances which got notifyHistoryEntries to skip it
+            stream << true;
+            // Protection against very long urls (like data:)
+            if (entryData.size() <= 4096) {
+                emit notifyHistoryEntry(entryData);
+            }
+        }
+    }
+
+    m_outgoing.clear();
+    m_outgoingIndex.clear();
 }
 
+// The other notifications must not overtake queued entries, otherwise e.g.
+// removing a pending entry would be applied before adding it.
+
 void KonqHistoryProvider::emitRemoveFromHistory(const QUrl &url)
 {
+    d->flushBroadcast();
     emit d->notifyRemove(url.url());
 }
 
 void KonqHistoryProvider::emitRemoveListFromHistory(const QList<QUrl> &urls)
 {
+    d->flushBroadcast();
     QStringList result;
     foreach (const QUrl &url, urls) {
         result << url.url();
@@ -228,16 +478,19 @@ void KonqHistoryProvider::emitRemoveListFromHistory(const QList<QUrl> &urls)
 
 void KonqHistoryProvider::emitClear()
 {
+    d->flushBroadcast();
     emit d->notifyClear();
 }
 
 void KonqHistoryProvider::emitSetMaxCount(int count)
 {
+    d->flushBroadcast();
     emit d->notifyMaxCount(count);
 }
 
 void KonqHistoryProvider::emitSetMaxAge(int days)
 {
+    d->flushBroadcast();
     emit d->notifyMaxAge(days);
 }
 
@@ -261,19 +514,80 @@ void KonqHistoryProviderPrivate::slotNotifyHistoryEntry(const QByteArray &data)
     e.load(stream, KonqHistoryEntry::MarshalUrlAsStrings);
     //qCDebug(LIBKONQ_LOG) << "Got new entry from Broadcast:" << e.url;
 
-    KonqHistoryList::iterator existingEntry = q->findEntry(e.url);
-    QString urlString = e.url.url();
-    const bool newEntry = existingEntry == m_history.end();
+    // Followed by the service of the sender, and by true if it was also
+    // part of a notifyHistoryEntries broadcast
+    QString service;
+    bool alsoBatched = false;
+    stream >> service;
+    if (!stream.atEnd()) {
+        stream >> alsoBatched;
+    }
+    if (alsoBatched) {
+        return;
+    }
+    const bool isSender = isSenderOfSignal(message());
+    if (!isSender) {
+        m_legacyPeers.insert(message().service());
+    }
+
+    addBroadcastEntry(e, isSender);
+}
+
+void KonqHistoryProviderPrivate::slotNotifyHistoryEntries(const QByteArray &data)
+{
+    QDataStream stream(data);
+    const bool isSender = isSenderOfSignal(message());
+
+    // Save only once for the whole batch, not for every entry
+    m_inBatch = true;
+    while (!stream.atEnd()) {
+        KonqHistoryEntry e;
+        e.load(stream, KonqHistoryEntry::MarshalUrlAsStrings);
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(LIBKONQ_LOG) << "Invalid history broadcast from" << message().service();
+            break;
+        }
+        addBroadcastEntry(e, isSender);
+    }
+    m_inBatch = false;
+
+    if (m_saveAfterBatch) {
+        m_saveAfterBatch = false;
+        saveHistory();
+    }
+}
+
+void KonqHistoryProviderPrivate::saveOutgoing()
+{
+    if (m_outgoing.isEmpty()) {
+        return;
+    }
+    // Nobody is interested in the signals anymore
+    const bool blocked = q->blockSignals(true);
+    m_inBatch = true;
+    for (const KonqHistoryEntry &entry : qAsConst(m_outgoing)) {
+        addBroadcastEntry(entry, true);
+    }
+    m_inBatch = false;
+    m_saveAfterBatch = false;
+    q->blockSignals(blocked);
+    saveHistory();
+}
+
+void KonqHistoryProviderPrivate::addBroadcastEntry(const KonqHistoryEntry &e, bool isSender)
+{
+    ensureLoaded();
+    const int existingEntry = m_history.indexOf(e.url);
+    const bool newEntry = existingEntry < 0;
 
     KonqHistoryEntry entry;
 
     if (!newEntry) {
-        entry = *existingEntry;
+        entry = m_history.at(existingEntry);
     } else { // create a new history entry
         entry.url = e.url;
         entry.firstVisited = e.firstVisited;
         entry.numberOfTimesVisited = 0; // will get set to 1 below
-        q->KParts::HistoryProvider::insert(urlString);
     }
 
     if (!e.typedUrl.isEmpty()) {
@@ -288,12 +602,14 @@ void KonqHistoryProviderPrivate::slotNotifyHistoryEntry(const QByteArray &data)
     if (newEntry) {
         m_history.append(entry);
     } else {
-        *existingEntry = entry;
+        // Updated in place: moving it to the end would shift all the others.
+        // The loader sorts the file again if needed.
+        m_history.replace(existingEntry, entry);
     }
 
     adjustSize();
 
-    q->finishAddingEntry(entry, isSenderOfSignal(message()));
+    q->finishAddingEntry(entry, isSender);
 
     emit q->entryAdded(entry);
 }
@@ -330,6 +646,9 @@ void KonqHistoryProviderPrivate::slotNotifyMaxAge(int days)
 
 void KonqHistoryProviderPrivate::slotNotifyClear()
 {
+    delete m_loader;
+    m_loader = nullptr;
+    m_decodeTimer.stop();
     m_history.clear();
 
     if (isSenderOfSignal(message())) {
@@ -343,9 +662,10 @@ void KonqHistoryProviderPrivate::slotNotifyRemove(const QString &urlStr)
 {
     QUrl url(urlStr);
 
-    KonqHistoryList::iterator existingEntry = q->findEntry(url);
-    if (existingEntry != m_history.end()) {
-        q->removeEntry(existingEntry);
+    ensureLoaded();
+    const int existingEntry = m_history.indexOf(url);
+    if (existingEntry >= 0) {
+        removeEntry(existingEntry);
         if (isSenderOfSignal(message())) {
             saveHistory();
         }
@@ -355,12 +675,13 @@ void KonqHistoryProviderPrivate::slotNotifyRemove(const QString &urlStr)
 void KonqHistoryProviderPrivate::slotNotifyRemoveList(const QStringList &urls)
 {
     bool doSave = false;
+    ensureLoaded();
     QStringList::const_iterator it = urls.begin();
     for (; it != urls.end(); ++it) {
         QUrl url(*it);
-        KonqHistoryList::iterator existingEntry = m_history.findEntry(url);
-        if (existingEntry != m_history.end()) {
-            q->removeEntry(existingEntry);
+        const int existingEntry = m_history.indexOf(url);
+        if (existingEntry >= 0) {
+            removeEntry(existingEntry);
             doSave = true;
         }
     }
@@ -370,15 +691,11 @@ void KonqHistoryProviderPrivate::slotNotifyRemoveList(const QStringList &urls)
     }
 }
 
-void KonqHistoryProvider::removeEntry(KonqHistoryList::iterator existingEntry)
+void KonqHistoryProviderPrivate::removeEntry(int index)
 {
-    const KonqHistoryEntry entry = *existingEntry; // make copy, due to erase call below
-    const QString urlString = entry.url.url();
-
-    KParts::HistoryProvider::remove(urlString);
-
-    d->m_history.erase(existingEntry);
-    emit entryRemoved(entry);
+    const KonqHistoryEntry entry = m_history.at(index);
+    m_history.removeAt(index);
+    emit q->entryRemoved(entry);
 }
 
 int KonqHistoryProvider::maxCount() const
@@ -393,50 +710,16 @@ int KonqHistoryProvider::maxAge() const
 
 bool KonqHistoryProviderPrivate::saveHistory()
 {
-    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/konqueror");
-    QDir().mkpath(dir);
-    const QString filename = dir + QLatin1String("/konq_history");
-    QSaveFile file(filename);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qCWarning(LIBKONQ_LOG) << "Can't open" << file.fileName() << "for saving history";
-        return false;
-    }
-
-    QDataStream fileStream(&file);
-    fileStream << KonqHistoryLoader::historyVersion();
-
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    QListIterator<KonqHistoryEntry> it(m_history);
-    while (it.hasNext()) {
-        //We use QUrl for marshalling URLs in entries in the V4
-        //file format
-        it.next().save(stream, KonqHistoryEntry::NoFlags);
-    }
-
-    quint32 crc = crc32(0, reinterpret_cast<unsigned char *>(data.data()), data.size());
-    fileStream << crc << data;
-
-    return file.commit();
-}
-
-KonqHistoryList::iterator KonqHistoryProvider::findEntry(const QUrl &url)
-{
-    // small optimization (dict lookup) for items _not_ in our history
-    if (!KParts::HistoryProvider::contains(url.url())) {
-        return d->m_history.end();
-    }
-    return d->m_history.findEntry(url);
+    ensureLoaded();
+    return KonqHistoryLoader::saveHistory(m_history);
 }
 
-KonqHistoryList::const_iterator KonqHistoryProvider::constFindEntry(const QUrl &url) const
+bool KonqHistoryProvider::contains(const QString &item) const
 {
-    // small optimization (dict lookup) for items _not_ in our history
-    if (!KParts::HistoryProvider::contains(url.url())) {
-        return d->m_history.constEnd();
-    }
-    return d->m_history.constFindEntry(url);
+    // This is called for every link of a page: don't decode the rest of the
+    // history for it, that happens soon enough while idle.
+    // Parsing normalizes the url, the links of a page may be encoded differently.
+    return d->m_history.indexOf(QUrl(item)) >= 0;
 }
 
 void KonqHistoryProvider::finishAddingEntry(const KonqHistoryEntry &entry, bool isSender)
@@ -444,7 +727,11 @@ void KonqHistoryProvider::finishAddingEntry(const KonqHistoryEntry &entry, bool
     Q_UNUSED(entry); // this arg is used by konq's reimplementation
     if (isSender) {
         // we are the sender of the broadcast, so we save
-        d->saveHistory();
+        if (d->m_inBatch) {
+            d->m_saveAfterBatch = true;
+        } else {
+            d->saveHistory();
+        }
     }
 }
 
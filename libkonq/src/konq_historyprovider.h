@@ -44,9 +44,33 @@ public:
 
     /**
      * @returns the list of all history entries, sorted by date
-     * (oldest entries first)
+     * (oldest entries first). Entries visited again since the history was
+     * loaded keep their place.
+     *
+     * The history is decoded on demand after loadHistory(), so the first
+     * call may have to finish decoding it.
+     *
+     * The provider keeps the entries in a compact form and builds the list
+     * on each call: use entryCount(), lastEntries() or findEntry() where
+     * they are enough.
+     */
+    KonqHistoryList entries() const;
+
+    /**
+     * @returns the last @p count entries of entries(), the newest last
+     */
+    KonqHistoryList lastEntries(int count) const;
+
+    /**
+     * @returns the entry for @p url, or an entry with an empty url if
+     * @p url is not in the history
+     */
+    KonqHistoryEntry findEntry(const QUrl &url) const;
+
+    /**
+     * @returns the number of history entries, without decoding them
      */
-    const KonqHistoryList &entries() const;
+    int entryCount() const;
 
     /**
      * @returns the current maximum number of history entries.
@@ -106,6 +130,14 @@ public:
      */
     bool loadHistory();
 
+    /**
+     * Reimplemented to look up @p item in the history entries directly,
+     * instead of in a separate list of url strings.
+     * While the history is still being decoded after loadHistory(), the
+     * entries not decoded yet aren't found.
+     */
+    bool contains(const QString &item) const override;
+
 Q_SIGNALS:
     /**
      * Emitted after a new entry was added
@@ -119,19 +151,22 @@ Q_SIGNALS:
      */
     void entryRemoved(const KonqHistoryEntry &entry);
 
-protected: // only to be used by konqueror's KonqHistoryManager
-
-    virtual void finishAddingEntry(const KonqHistoryEntry &entry, bool isSender);
-    virtual void removeEntry(KonqHistoryList::iterator it);
+    /**
+     * Emitted after several entries were removed from the history at once,
+     * e.g. because they expired after lowering the maximum count or age.
+     * entryRemoved() is not emitted for each of those entries.
+     */
+    void entriesRemoved(const KonqHistoryList &entries);
 
     /**
-     * a little optimization for KonqHistoryList::findEntry(),
-     * checking the dict of KParts::HistoryProvider before traversing the list.
-     * Can't be used everywhere, because it always returns end() for "pending"
-     * entries, as those are not added to the dict, currently.
+     * Emitted with the entries decoded from the history file, a chunk at a
+     * time after loadHistory(). entryAdded() is not emitted for them.
      */
-    KonqHistoryList::iterator findEntry(const QUrl &url);
-    KonqHistoryList::const_iterator constFindEntry(const QUrl &url) const;
+    void entriesLoaded(const KonqHistoryList &entries);
+
+protected: // only to be used by konqueror's KonqHistoryManager
+
+    virtual void finishAddingEntry(const KonqHistoryEntry &entry, bool isSender);
 
     /**
      * Notifies all running instances about a new HistoryEntry via D-Bus.
@@ -0,0 +1,211 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: LGPL-2.0-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "konq_historystore_p.h"
+
+#include <QDataStream>
+
+#include <limits>
+
+static const qint64 s_invalidDate = std::numeric_limits<qint64>::min();
+
+static qint64 toMSecs(const QDateTime &dateTime)
+{
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : s_invalidDate;
+}
+
+static QDateTime fromMSecs(qint64 msecs)
+{
+    return msecs == s_invalidDate ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs);
+}
+
+// The length of the scheme and authority at the start of an encoded url,
+// e.g. "https://kde.org" in "https://kde.org/index.html".
+// Any split would do, as long as urls from the same site share their origin.
+static int originLength(const QByteArray &encoded)
+{
+    const int colon = encoded.indexOf(':');
+    if (colon < 0) {
+        return 0;
+    }
+    if (qstrncmp(encoded.constData() + colon + 1, "//", 2) != 0) {
+        return colon + 1;
+    }
+    int end = colon + 3;
+    while (end < encoded.size()) {
+        const char c = encoded.at(end);
+        if (c == '/' || c == '?' || c == '#') {
+            break;
+        }
+        ++end;
+    }
+    return end;
+}
+
+static KonqHistoryUrlKey keyOf(const KonqHistoryRecord &record)
+{
+    KonqHistoryUrlKey key;
+    key.origin = record.origin;
+    key.path = record.path;
+    return key;
+}
+
+KonqHistoryStore::KonqHistoryStore()
+    : m_firstIndex(0), m_indexValid(true)
+{
+}
+
+void KonqHistoryStore::reserve(int size)
+{
+    m_records.reserve(size);
+    m_index.reserve(size);
+}
+
+void KonqHistoryStore::clear()
+{
+    m_records.clear();
+    m_origins.clear();
+    m_originIds.clear();
+    m_index.clear();
+    m_firstIndex = 0;
+    m_indexValid = true;
+}
+
+KonqHistoryEntry KonqHistoryStore::at(int index) const
+{
+    const KonqHistoryRecord &record = m_records.at(index);
+    KonqHistoryEntry entry;
+    entry.url = QUrl::fromEncoded(m_origins.at(record.origin) + record.path);
+    entry.typedUrl = record.typedUrl;
+    entry.title = record.title;
+    entry.numberOfTimesVisited = record.numberOfTimesVisited;
+    entry.firstVisited = fromMSecs(record.firstVisited);
+    entry.lastVisited = fromMSecs(record.lastVisited);
+    return entry;
+}
+
+QDateTime KonqHistoryStore::lastVisited(int index) const
+{
+    return fromMSecs(m_records.at(index).lastVisited);
+}
+
+KonqHistoryList KonqHistoryStore::entries() const
+{
+    KonqHistoryList list;
+    list.reserve(m_records.count());
+    for (int i = 0; i < m_records.count(); ++i) {
+        list.append(at(i));
+    }
+    return list;
+}
+
+bool KonqHistoryStore::findKey(const QUrl &url, KonqHistoryUrlKey *key) const
+{
+    const QByteArray encoded = url.toEncoded();
+    const int length = originLength(encoded);
+    // No url of the history starts with an origin we don't know
+    const QHash<QByteArray, quint32>::const_iterator it = m_originIds.constFind(QByteArray::fromRawData(encoded.constData(), length));
+    if (it == m_originIds.constEnd()) {
+        return false;
+    }
+    key->origin = it.value();
+    key->path = encoded.mid(length);
+    return true;
+}
+
+int KonqHistoryStore::indexOf(const QUrl &url) const
+{
+    KonqHistoryUrlKey key;
+    if (!findKey(url, &key)) {
+        return -1;
+    }
+    if (!m_indexValid) {
+        rebuildIndex();
+    }
+    const QHash<KonqHistoryUrlKey, qint64>::const_iterator it = m_index.constFind(key);
+    return it == m_index.constEnd() ? -1 : int(it.value() - m_firstIndex);
+}
+
+void KonqHistoryStore::rebuildIndex() const
+{
+    m_index.clear();
+    m_index.reserve(m_records.count());
+    m_firstIndex = 0;
+    for (int i = 0; i < m_records.count(); ++i) {
+        m_index.insert(keyOf(m_records.at(i)), i);
+    }
+    m_indexValid = true;
+}
+
+void KonqHistoryStore::append(const KonqHistoryEntry &entry)
+{
+    const QByteArray encoded = entry.url.toEncoded();
+    const int length = originLength(encoded);
+    const QByteArray origin = encoded.left(length);
+
+    KonqHistoryRecord record;
+    QHash<QByteArray, quint32>::const_iterator it = m_originIds.constFind(origin);
+    if (it == m_originIds.constEnd()) {
+        it = m_originIds.insert(origin, quint32(m_origins.count()));
+        m_origins.append(origin);
+    }
+    record.origin = it.value();
+    record.path = encoded.mid(length);
+    record.typedUrl = entry.typedUrl;
+    record.title = entry.title;
+    record.numberOfTimesVisited = entry.numberOfTimesVisited;
+    record.firstVisited = toMSecs(entry.firstVisited);
+    record.lastVisited = toMSecs(entry.lastVisited);
+
+    if (m_indexValid) {
+        m_index.insert(keyOf(record), m_firstIndex + m_records.count());
+    }
+    m_records.append(record);
+}
+
+void KonqHistoryStore::replace(int index, const KonqHistoryEntry &entry)
+{
+    KonqHistoryRecord &record = m_records[index];
+    record.typedUrl = entry.typedUrl;
+    record.title = entry.title;
+    record.numberOfTimesVisited = entry.numberOfTimesVisited;
+    record.firstVisited = toMSecs(entry.firstVisited);
+    record.lastVisited = toMSecs(entry.lastVisited);
+}
+
+void KonqHistoryStore::removeAt(int index)
+{
+    m_index.remove(keyOf(m_records.at(index)));
+    if (index == 0) {
+        // The positions of the others are still right, relative to the first one
+        ++m_firstIndex;
+    } else if (index < m_records.count() - 1) {
+        // Rare enough to renumber the others only when needed
+        m_indexValid = false;
+    }
+    m_records.remove(index);
+}
+
+void KonqHistoryStore::removeFirst(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        m_index.remove(keyOf(m_records.at(i)));
+    }
+    m_records.remove(0, count);
+    m_firstIndex += count;
+}
+
+void KonqHistoryStore::save(int index, QDataStream &stream) const
+{
+    const KonqHistoryRecord &record = m_records.at(index);
+    // What operator<<(QDataStream &, const QUrl &) writes
+    stream << QByteArray(m_origins.at(record.origin) + record.path);
+    stream << record.typedUrl;
+    stream << record.title;
+    stream << record.numberOfTimesVisited;
+    stream << fromMSecs(record.firstVisited);
+    stream << fromMSecs(record.lastVisited);
+}
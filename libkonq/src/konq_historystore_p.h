@@ -0,0 +1,143 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: LGPL-2.0-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef KONQ_HISTORYSTORE_P_H
+#define KONQ_HISTORYSTORE_P_H
+
+#include "konq_historyentry.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+class QDataStream;
+
+/**
+ * @internal
+ * One entry of KonqHistoryStore
+ */
+struct KonqHistoryRecord {
+    QByteArray path;      // the encoded url, after its origin
+    QString typedUrl;
+    QString title;
+    qint64 firstVisited;  // msecs since the epoch
+    qint64 lastVisited;
+    quint32 origin;       // position in the origins of the store
+    quint32 numberOfTimesVisited;
+};
+Q_DECLARE_TYPEINFO(KonqHistoryRecord, Q_MOVABLE_TYPE);
+
+/**
+ * @internal
+ * Identifies the url of a KonqHistoryRecord. The path shares its data with
+ * the one of the record.
+ */
+struct KonqHistoryUrlKey {
+    quint32 origin;
+    QByteArray path;
+
+    bool operator==(const KonqHistoryUrlKey &other) const
+    {
+        return origin == other.origin && path == other.path;
+    }
+};
+
+inline uint qHash(const KonqHistoryUrlKey &key, uint seed = 0)
+{
+    return qHash(key.path, seed) ^ key.origin;
+}
+
+/**
+ * @internal
+ * The history entries of KonqHistoryProvider, in a compact form.
+ *
+ * Each url is kept encoded, split into its origin (the scheme and the
+ * authority), stored once for all the urls sharing it, and the bytes after
+ * it. The dates are kept as numbers. Compared to a KonqHistoryList, this
+ * saves the QUrl of every entry, its separately allocated components and
+ * the list node holding the entry.
+ *
+ * The entries are ordered like a KonqHistoryList, oldest first, and are
+ * built as KonqHistoryEntry objects when asked for.
+ */
+class KonqHistoryStore
+{
+public:
+    KonqHistoryStore();
+
+    int count() const
+    {
+        return m_records.count();
+    }
+
+    bool isEmpty() const
+    {
+        return m_records.isEmpty();
+    }
+
+    void reserve(int size);
+    void clear();
+
+    /**
+     * @returns the entry at @p index
+     */
+    KonqHistoryEntry at(int index) const;
+
+    /**
+     * @returns the last visit of the entry at @p index, without building
+     * the entry
+     */
+    QDateTime lastVisited(int index) const;
+
+    /**
+     * @returns all the entries, oldest first
+     */
+    KonqHistoryList entries() const;
+
+    /**
+     * @returns the position of the entry for @p url, or -1
+     */
+    int indexOf(const QUrl &url) const;
+
+    /**
+     * Appends @p entry, whose url must not be in the store yet.
+     */
+    void append(const KonqHistoryEntry &entry);
+
+    /**
+     * Updates the entry at @p index with the data of @p entry, which has the
+     * same url.
+     */
+    void replace(int index, const KonqHistoryEntry &entry);
+
+    void removeAt(int index);
+
+    /**
+     * Removes the @p count first (oldest) entries in one go.
+     */
+    void removeFirst(int count);
+
+    /**
+     * Writes the entry at @p index to @p stream, the same way as
+     * KonqHistoryEntry::save() with KonqHistoryEntry::NoFlags.
+     */
+    void save(int index, QDataStream &stream) const;
+
+private:
+    bool findKey(const QUrl &url, KonqHistoryUrlKey *key) const;
+    void rebuildIndex() const;
+
+    QVector<KonqHistoryRecord> m_records;
+    QVector<QByteArray> m_origins;
+    QHash<QByteArray, quint32> m_originIds;
+    // url -> m_firstIndex + position of its record, so that removing the
+    // oldest entries doesn't require updating the others
+    mutable QHash<KonqHistoryUrlKey, qint64> m_index;
+    mutable qint64 m_firstIndex;
+    mutable bool m_indexValid;
+};
+
+#endif /* KONQ_HISTORYSTORE_P_H */
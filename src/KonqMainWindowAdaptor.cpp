@@ -106,6 +106,16 @@ QDBusObjectPath KonqMainWindowAdaptor::part(int partNumber)
     return QDBusObjectPath((*it)->partObjectPath());
 }
 
+QVariantMap KonqMainWindowAdaptor::viewMetrics()
+{
+    QVariantMap metrics;
+    const KonqMainWindow::MapViews viewMap = m_pMainWindow->viewMap();
+    for (KonqView *view : viewMap) {
+        metrics.insert(view->dbusObjectPath(), view->metrics());
+    }
+    return metrics;
+}
+
 void KonqMainWindowAdaptor::splitViewHorizontally()
 {
     m_pMainWindow->slotSplitViewHorizontal();
@@ -15,6 +15,7 @@
 #include <QDBusAbstractAdaptor>
 #include <QDBusObjectPath>
 #include <QDBusConnection>
+#include <QVariantMap>
 
 class KonqMainWindow;
 
@@ -71,6 +72,12 @@ public slots:
 
     QDBusObjectPath part(int partNumber);
 
+    /**
+     * @return the metrics of all the views of this window, by object path
+     * of the view (see org.kde.Konqueror.View.metrics)
+     */
+    QVariantMap viewMetrics();
+
 private:
 
     KonqMainWindow *m_pMainWindow;
@@ -9,7 +9,7 @@
 #include "konqview.h"
 
 KonqViewAdaptor::KonqViewAdaptor(KonqView *view)
-    : m_pView(view)
+    : QDBusAbstractAdaptor(view), m_pView(view)
 {
 }
 
@@ -104,3 +104,8 @@ void KonqViewAdaptor::reload()
     return m_pView->mainWindow()->slotReload(m_pView);
 }
 
+
+QVariantMap KonqViewAdaptor::metrics()
+{
+    return m_pView->metrics();
+}
@@ -9,6 +9,8 @@
 #define __KonqViewAdaptor_h__
 
 #include <QStringList>
+#include <QVariantMap>
+#include <QDBusAbstractAdaptor>
 #include <QDBusObjectPath>
 
 class KonqView;
@@ -16,7 +18,7 @@ class KonqView;
 /**
  * DBus interface for a konqueror view
  */
-class KonqViewAdaptor : public QObject
+class KonqViewAdaptor : public QDBusAbstractAdaptor
 {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.kde.Konqueror.View")
@@ -111,6 +113,16 @@ public slots:
     bool canGoBack()const;
     bool canGoForward()const;
 
+    /**
+     * @return how the loading of the current URL went: navigationStart (in
+     * milliseconds since the epoch), firstPaint and loadFinished (in
+     * milliseconds since the navigation start, -1 if not yet), loading,
+     * aborted, bytes, blockedRequests, schemeHandlerTime (in milliseconds),
+     * rendererPid, rendererMemory (in bytes) and cpuTime (used by the
+     * renderer since the navigation start, in milliseconds)
+     */
+    QVariantMap metrics();
+
 private:
 
     KonqView *m_pView;
@@ -12,13 +12,19 @@
 #include "konqmainwindowfactory.h"
 #include "konqviewmanager.h"
 #include "konqview.h"
+#include "konqhibernator.h"
+#include "konqhistorymanager.h"
+#include "konqmimetypecache.h"
+#include "konqpixmapprovider.h"
 #include "konqsettingsxt.h"
 #include "konqsettings.h"
 
 #include "konqdebug.h"
 #include <kwindowsystem.h>
+#include <kwindowsystem_version.h>
 #include <KStartupInfo>
 
+#include <QCoreApplication>
 #include <QFile>
 #if KONQ_HAVE_X11
 #include <QX11Info>
@@ -79,6 +85,50 @@ QDBusObjectPath KonquerorAdaptor::createNewWindow(const QString &url, const QStr
     return QDBusObjectPath(res->dbusName());
 }
 
+QDBusObjectPath KonquerorAdaptor::openUrls(const QStringList &urls, const QString &mimetype, const QByteArray &startup_id, bool newTab, bool tempFile)
+{
+    QList<QUrl> finalURLs;
+    for (const QString &url : urls) {
+        const QUrl finalURL = KonqMisc::konqFilteredURL(nullptr, url);
+        if (!finalURL.isEmpty()) {
+            finalURLs.append(finalURL);
+        }
+    }
+    if (finalURLs.isEmpty()) {
+        return QDBusObjectPath("/");
+    }
+    KonqOpenURLRequest req;
+    req.args.setMimeType(mimetype);
+    req.tempFile = tempFile;
+
+    KonqMainWindow *res = nullptr;
+    if (newTab || KonqSettings::konquerorTabforExternalURL()) {
+        res = findWindowForTab();
+    }
+    const QUrl firstURL = finalURLs.takeFirst();
+    if (res) {
+#if KWINDOWSYSTEM_VERSION >= QT_VERSION_CHECK(5,62,0)
+        res->setAttribute(Qt::WA_NativeWindow, true);
+        KStartupInfo::setNewStartupId(res->windowHandle(), startup_id);
+#else
+        KStartupInfo::setNewStartupId(res, startup_id);
+#endif
+        KonqOpenURLRequest firstReq(req);
+        firstReq.browserArgs.setNewTab(true);
+        firstReq.newTabInFront = true;
+        res->openUrl(nullptr, firstURL, mimetype, firstReq);
+    } else {
+        setStartupId(startup_id);
+        res = KonqMainWindowFactory::createNewWindow(firstURL, req);
+        if (!res) {
+            return QDBusObjectPath("/");
+        }
+        res->show();
+    }
+    res->openHibernatedTabs(finalURLs, req);
+    return QDBusObjectPath(res->dbusName());
+}
+
 QDBusObjectPath KonquerorAdaptor::createNewWindowWithSelection(const QString &url, const QStringList &filesToSelect, const QByteArray &startup_id)
 {
     setStartupId(startup_id);
@@ -120,18 +170,65 @@ QStringList KonquerorAdaptor::urls() const
     return lst;
 }
 
-QDBusObjectPath KonquerorAdaptor::windowForTab()
+QVariantMap KonquerorAdaptor::performanceStatistics() const
+{
+    QVariantList views;
+    QList<KonqMainWindow *> *mainWindows = KonqMainWindow::mainWindowList();
+    if (mainWindows) {
+        for (KonqMainWindow *window : *mainWindows) {
+            if (window->isPreloaded()) {
+                continue;
+            }
+            for (KonqView *view : window->viewMap()) {
+                QVariantMap metrics = view->metrics();
+                metrics.insert(QStringLiteral("window"), window->dbusName());
+                metrics.insert(QStringLiteral("view"), view->dbusObjectPath());
+                metrics.insert(QStringLiteral("title"), view->caption());
+                metrics.insert(QStringLiteral("partType"), view->service()->desktopEntryName());
+                metrics.insert(QStringLiteral("hibernated"), view->isHibernated());
+                views.append(metrics);
+            }
+        }
+    }
+
+    QVariantMap caches;
+    caches.insert(QStringLiteral("history"), KonqHistoryManager::kself()->entryCount());
+    caches.insert(QStringLiteral("favicons"), KonqPixmapProvider::self()->count());
+    caches.insert(QStringLiteral("mimeTypes"), KonqMimeTypeCache::self()->statistics().entries);
+
+    QVariantMap process;
+    process.insert(QStringLiteral("pid"), QCoreApplication::applicationPid());
+    process.insert(QStringLiteral("memory"), KonqHibernator::residentMemory());
+    process.insert(QStringLiteral("cpuTime"), KonqViewMetrics::cpuTime());
+
+    QVariantMap statistics;
+    statistics.insert(QStringLiteral("views"), views);
+    statistics.insert(QStringLiteral("caches"), caches);
+    statistics.insert(QStringLiteral("process"), process);
+    return statistics;
+}
+
+KonqMainWindow *KonquerorAdaptor::findWindowForTab()
 {
     QList<KonqMainWindow *> *mainWindows = KonqMainWindow::mainWindowList();
     if (mainWindows) {
         foreach (KonqMainWindow *window, *mainWindows) {
             KWindowInfo winfo(window->winId(), NET::WMDesktop);
             if (winfo.isOnCurrentDesktop()) {  // we want a tab in an already shown window
-                Q_ASSERT(!window->dbusName().isEmpty());
-                return QDBusObjectPath(window->dbusName());
+                return window;
             }
         }
     }
+    return nullptr;
+}
+
+QDBusObjectPath KonquerorAdaptor::windowForTab()
+{
+    KonqMainWindow *window = findWindowForTab();
+    if (window) {
+        Q_ASSERT(!window->dbusName().isEmpty());
+        return QDBusObjectPath(window->dbusName());
+    }
     // We can't use QDBusObjectPath(), dbus type 'o' must be a valid object path.
     // So we use "/" as an indicator for not found.
     return QDBusObjectPath("/");
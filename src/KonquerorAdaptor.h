@@ -8,16 +8,21 @@
 #ifndef KONQUERORADAPTOR_H
 #define KONQUERORADAPTOR_H
 
+#include "konqprivate_export.h"
+
 #include <QStringList>
+#include <QVariantMap>
 #include <QDBusObjectPath>
 #include <QDBusMessage>
 
 #define KONQ_MAIN_PATH "/KonqMain"
 
+class KonqMainWindow;
+
 /**
  * DBus interface of a konqueror process
  */
-class KonquerorAdaptor : public QObject
+class KONQ_TESTS_EXPORT KonquerorAdaptor : public QObject
 {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.kde.Konqueror.Main")
@@ -47,6 +52,21 @@ public slots:
      */
     QDBusObjectPath createNewWindow(const QString &url, const QString &mimetype, const QByteArray &startup_id, bool tempFile);
 
+    /**
+     * Opens all of @p urls with a single call, for kfmclient: in new tabs of a
+     * window on the current desktop if @p newTab is true or if Konqueror is
+     * configured to open external URLs in tabs, or else in a new window.
+     * Only the first URL is loaded right away, the others when their tab
+     * is activated.
+     * @param urls the urls to open, filtered like in @ref createNewWindow
+     * @param mimetype pass the mimetype of the urls, if known and the same for all
+     * @param startup_id sets the application startup notification (ASN) property on the window, if not empty.
+     * @param newTab whether to use a tab even if Konqueror isn't configured to
+     * @param tempFile whether to delete the files after use, usually this is false
+     * @return the DBUS object path of the window
+     */
+    QDBusObjectPath openUrls(const QStringList &urls, const QString &mimetype, const QByteArray &startup_id, bool newTab, bool tempFile);
+
     /**
      * Opens a new window like @ref createNewWindow, then selects the given @p filesToSelect
      * @param filesToSelect the files to select in the newly opened file-manager window
@@ -71,6 +91,16 @@ public slots:
      */
     QDBusObjectPath windowForTab();
 
+    /**
+     * @return what konq:performance shows: "views", a list with the metrics
+     * of each view (see org.kde.Konqueror.View.metrics) together with its
+     * view and window object paths, title, partType and hibernated state;
+     * "caches", the number of entries of the history, favicon and MIME type
+     * caches; and "process", the pid, resident memory and CPU time of this
+     * process
+     */
+    QVariantMap performanceStatistics() const;
+
 Q_SIGNALS:
     /**
      * Emitted by kcontrol when the global configuration changes
@@ -88,6 +118,9 @@ Q_SIGNALS:
      * Used internally by Konqueror to notify all instances when the combobox should be cleared.
      */
     void comboCleared(const QDBusMessage &msg);
+
+private:
+    static KonqMainWindow *findWindowForTab();
 };
 
 #endif
@@ -25,7 +25,7 @@ template class QList<KonqHistoryEntry *>;
 /////////////////
 
 //static - used by back/forward popups in KonqMainWindow
-void KonqActions::fillHistoryPopup(const QList<HistoryEntry *> &history, int historyIndex,
+void KonqActions::fillHistoryPopup(const QList<HistoryEntry::Ptr> &history, int historyIndex,
                                    QMenu *popup,
                                    bool onlyBack,
                                    bool onlyForward)
@@ -49,8 +49,7 @@ void KonqActions::fillHistoryPopup(const QList<HistoryEntry *> &history, int his
         QString text = history[ index ]->title;
         text = fm.elidedText(text, Qt::ElideMiddle, fm.maxWidth() * 30);
         text.replace('&', QLatin1String("&&"));
-        const QString iconName = KonqPixmapProvider::self()->iconNameFor(history[index]->url);
-        QAction *action = new QAction(QIcon::fromTheme(iconName), text, popup);
+        QAction *action = new QAction(KonqPixmapProvider::self()->iconForUrl(history[index]->url), text, popup);
         action->setData(index - historyIndex);
         //qCDebug(KONQUEROR_LOG) << text << index - historyIndex;
         popup->addAction(action);
@@ -96,7 +95,7 @@ void KonqMostOftenURLSAction::init()
     s_maxEntries = KonqSettings::numberofmostvisitedURLs();
 
     KonqHistoryManager *mgr = KonqHistoryManager::kself();
-    setEnabled(!mgr->entries().isEmpty() && s_maxEntries > 0);
+    setEnabled(mgr->entryCount() > 0 && s_maxEntries > 0);
 }
 
 Q_GLOBAL_STATIC(KonqHistoryList, s_mostEntries)
@@ -118,6 +117,8 @@ void KonqMostOftenURLSAction::parseHistory() // only ever called once
             SLOT(slotEntryAdded(KonqHistoryEntry)));
     connect(mgr, SIGNAL(entryRemoved(KonqHistoryEntry)),
             SLOT(slotEntryRemoved(KonqHistoryEntry)));
+    connect(mgr, SIGNAL(entriesRemoved(KonqHistoryList)),
+            SLOT(slotEntriesRemoved(KonqHistoryList)));
     connect(mgr, SIGNAL(cleared()), SLOT(slotHistoryCleared()));
 
     const KonqHistoryList mgrEntries = mgr->entries();
@@ -165,6 +166,14 @@ void KonqMostOftenURLSAction::slotEntryRemoved(const KonqHistoryEntry &entry)
     setEnabled(!s_mostEntries->isEmpty());
 }
 
+void KonqMostOftenURLSAction::slotEntriesRemoved(const KonqHistoryList &entries)
+{
+    for (const KonqHistoryEntry &entry : entries) {
+        s_mostEntries->removeEntry(entry.url);
+    }
+    setEnabled(!s_mostEntries->isEmpty());
+}
+
 void KonqMostOftenURLSAction::slotHistoryCleared()
 {
     s_mostEntries->clear();
@@ -179,7 +188,7 @@ static void createHistoryAction(const KonqHistoryEntry &entry, QMenu *menu)
                          entry.typedUrl) :
                          entry.title;
     QAction *action = new QAction(
-        QIcon::fromTheme(KonqPixmapProvider::self()->iconNameFor(entry.url)),
+        KonqPixmapProvider::self()->iconForUrl(entry.url),
         text, menu);
     action->setData(entry.url);
     menu->addAction(action);
@@ -217,7 +226,7 @@ KonqHistoryAction::KonqHistoryAction(const QString &text, QObject *parent)
 #endif
     connect(menu(), SIGNAL(aboutToShow()), SLOT(slotFillMenu()));
     connect(menu(), SIGNAL(triggered(QAction*)), SLOT(slotActivated(QAction*)));
-    setEnabled(!KonqHistoryManager::kself()->entries().isEmpty());
+    setEnabled(KonqHistoryManager::kself()->entryCount() > 0);
 }
 
 KonqHistoryAction::~KonqHistoryAction()
@@ -232,10 +241,9 @@ void KonqHistoryAction::slotFillMenu()
     s_maxEntries = KonqSettings::numberofmostvisitedURLs();
 
     KonqHistoryManager *mgr = KonqHistoryManager::kself();
-    const KonqHistoryList mgrEntries = mgr->entries();
-    int idx = mgrEntries.count() - 1;
-    // mgrEntries is "oldest first", so take the last s_maxEntries entries.
-    for (int n = 0; idx >= 0 && n < s_maxEntries; --idx, ++n) {
+    const KonqHistoryList mgrEntries = mgr->lastEntries(s_maxEntries);
+    // mgrEntries is "oldest first", so start from the last one.
+    for (int idx = mgrEntries.count() - 1; idx >= 0; --idx) {
         createHistoryAction(mgrEntries.at(idx), menu());
     }
 }
@@ -11,13 +11,13 @@
 #include <konqhistorymanager.h>
 #include <kactionmenu.h>
 #include <QList>
+#include "konqview.h"
 
-struct HistoryEntry;
 class QMenu;
 
 namespace KonqActions
 {
-void fillHistoryPopup(const QList<HistoryEntry *> &history, int historyIndex,
+void fillHistoryPopup(const QList<HistoryEntry::Ptr> &history, int historyIndex,
                       QMenu *popup,
                       bool onlyBack,
                       bool onlyForward);
@@ -73,6 +73,7 @@ private Q_SLOTS:
     void slotHistoryCleared();
     void slotEntryAdded(const KonqHistoryEntry &entry);
     void slotEntryRemoved(const KonqHistoryEntry &entry);
+    void slotEntriesRemoved(const KonqHistoryList &entries);
 
     void slotFillMenu();
     void slotActivated(QAction *action);
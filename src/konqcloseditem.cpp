@@ -7,6 +7,7 @@
 
 #include "konqcloseditem.h"
 #include "konqclosedwindowsmanager.h"
+#include "konqsessionwriter.h"
 #include <QFont>
 #include <QFontMetrics>
 #include <QPainter>
@@ -18,7 +19,11 @@
 #include <konqpixmapprovider.h>
 #include <kcolorscheme.h>
 
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
 #include <QFontDatabase>
+#include <QUuid>
 
 class KonqIcon
 {
@@ -54,9 +59,99 @@ KonqClosedTabItem::KonqClosedTabItem(const QString &url, KConfig *config, const
 KonqClosedTabItem::~KonqClosedTabItem()
 {
     m_configGroup.deleteGroup();
+    if (!m_spillFile.isEmpty()) {
+        QFile::remove(m_spillFile);
+    }
     qCDebug(KONQUEROR_LOG) << "deleted group" << m_configGroup.name();
 }
 
+KConfigGroup &KonqClosedTabItem::configGroup()
+{
+    unpack();
+    return m_configGroup;
+}
+
+const KConfigGroup &KonqClosedTabItem::configGroup() const
+{
+    const_cast<KonqClosedTabItem *>(this)->unpack();
+    return m_configGroup;
+}
+
+void KonqClosedTabItem::pack()
+{
+    if (m_packed) {
+        return;
+    }
+
+    const KonqSessionWindowEntries entries = KonqSessionWriter::windowEntries(m_configGroup);
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream << entries;
+    m_unpackedSize = state.size();
+    m_packedState = qCompress(state);
+    m_configGroup.deleteGroup();
+    m_packed = true;
+}
+
+void KonqClosedTabItem::unpack()
+{
+    if (!m_packed) {
+        return;
+    }
+
+    QByteArray packedState = m_packedState;
+    if (!m_spillFile.isEmpty()) {
+        QFile file(m_spillFile);
+        if (file.open(QIODevice::ReadOnly)) {
+            packedState = file.readAll();
+        }
+        file.remove();
+        m_spillFile.clear();
+    }
+
+    KonqSessionWindowEntries entries;
+    QDataStream stream(qUncompress(packedState));
+    stream >> entries;
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(KONQUEROR_LOG) << "Couldn't restore the state of closed tab" << m_url;
+    }
+    KonqSessionWriter::writeEntries(entries, m_configGroup);
+    m_packedState.clear();
+    m_packed = false;
+}
+
+bool KonqClosedTabItem::spill()
+{
+    if (!m_packed || !m_spillFile.isEmpty()) {
+        return false;
+    }
+
+    const QString dir = spillDirectory();
+    QDir().mkpath(dir);
+    QFile file(dir + QUuid::createUuid().toString(QUuid::WithoutBraces));
+    if (!file.open(QIODevice::WriteOnly) || file.write(m_packedState) != m_packedState.size()) {
+        qCWarning(KONQUEROR_LOG) << "Couldn't write closed tab to" << file.fileName();
+        file.remove();
+        return false;
+    }
+    m_spillFile = file.fileName();
+    m_packedState.clear();
+    return true;
+}
+
+int KonqClosedTabItem::memoryUsage() const
+{
+    if (m_packed) {
+        return m_packedState.size();
+    }
+    return m_unpackedSize;
+}
+
+QString KonqClosedTabItem::spillDirectory()
+{
+    return QDir::tempPath() + QLatin1String("/closeditems/tabs/");
+}
+
 QPixmap KonqClosedTabItem::icon() const
 {
     return KonqPixmapProvider::self()->pixmapFor(m_url, KIconLoader::SizeSmall);
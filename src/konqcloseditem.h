@@ -10,6 +10,7 @@
 
 #include "konqprivate_export.h"
 #include <kconfiggroup.h>
+#include <QByteArray>
 #include <QString>
 
 class KConfig;
@@ -46,13 +47,47 @@ protected:
 /**
  * This class stores all the needed information about a closed tab
  * in order to be able to reopen it if requested
+ *
+ * Once the state of the tab has been written to configGroup(), pack()
+ * compresses it and removes it from the config; spill() then moves it to a
+ * file. configGroup() puts it back in the config when it's needed.
  */
 class KONQ_TESTS_EXPORT KonqClosedTabItem : public KonqClosedItem
 {
 public:
     KonqClosedTabItem(const QString &url, KConfig *config, const QString &title, int index, quint64 serialNumber);
     ~KonqClosedTabItem() override;
+    KConfigGroup &configGroup() override;
+    const KConfigGroup &configGroup() const override;
     QPixmap icon() const override;
+
+    /**
+     * Compresses the state of the tab and removes it from the config.
+     */
+    void pack();
+
+    /**
+     * Moves the compressed state of the tab to a file.
+     * @return false if the state isn't packed or couldn't be written
+     */
+    bool spill();
+
+    bool isSpilled() const
+    {
+        return !m_spillFile.isEmpty();
+    }
+
+    /**
+     * Returns the memory used by the packed state, in bytes, or an estimate
+     * of the memory used by the unpacked state.
+     */
+    int memoryUsage() const;
+
+    /**
+     * The directory where the states of the tabs are spilled.
+     */
+    static QString spillDirectory();
+
     QString url() const
     {
         return m_url;
@@ -64,8 +99,14 @@ public:
     }
 
 protected:
+    void unpack();
+
     QString m_url;
     int m_pos;
+    bool m_packed = false;
+    int m_unpackedSize = 0;
+    QByteArray m_packedState;
+    QString m_spillFile;
 };
 
 /**
@@ -9,11 +9,13 @@
 #include "konqsettingsxt.h"
 #include "konqmisc.h"
 #include "konqcloseditem.h"
+#include "konqdebug.h"
 #include "konqclosedwindowsmanageradaptor.h"
 #include "konqclosedwindowsmanager_interface.h"
 #include <kio/fileundomanager.h>
 #include <QDirIterator>
 #include <QMetaType>
+#include <QUuid>
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusReply>
@@ -34,6 +36,19 @@ public:
 
 static KonqClosedWindowsManagerPrivate *myKonqClosedWindowsManagerPrivate = nullptr;
 
+// The group holding the state of the window in its state file
+static const char s_windowStateGroup[] = "Closed_Window";
+
+static QString closedItemsDirectory()
+{
+    return QDir::tempPath() + QLatin1Char('/') + QLatin1String("closeditems/");
+}
+
+static QString windowStateDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QLatin1String("/closedwindows/");
+}
+
 KonqClosedWindowsManager::KonqClosedWindowsManager()
 {
     new KonqClosedWindowsManagerAdaptor(this);
@@ -46,22 +61,28 @@ KonqClosedWindowsManager::KonqClosedWindowsManager()
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyClosedWindowItem"), this, SLOT(slotNotifyClosedWindowItem(QString,int,QString,QString,QDBusMessage)));
     dbus.connect(QString(), dbusPath, dbusInterface, QStringLiteral("notifyRemove"), this, SLOT(slotNotifyRemove(QString,QString,QDBusMessage)));
 
-    QString filename = "closeditems/" + KonqMisc::encodeFilename(dbus.baseService());
-    QString file = QDir::tempPath() + QLatin1Char('/') +  filename;
-    QFile::remove(file);
+    // Every process creates a file named after its service in closeditems/,
+    // see numberOfKonquerorProcesses()
+    const QString dir = closedItemsDirectory();
+    QDir().mkpath(dir);
+    QFile file(dir + KonqMisc::encodeFilename(dbus.baseService()));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KONQUEROR_LOG) << "Couldn't create" << file.fileName();
+    }
 
     KConfigGroup configGroup(KSharedConfig::openConfig(), "Undo");
     m_numUndoClosedItems = configGroup.readEntry("Number of Closed Windows", 0);
 
     m_konqClosedItemsConfig = nullptr;
     m_blockClosedItems = false;
-    m_konqClosedItemsStore = new KConfig(file, KConfig::SimpleConfig);
+    m_konqClosedItemsStore = new KConfig(QString(), KConfig::SimpleConfig); // in memory
 }
 
 KonqClosedWindowsManager::~KonqClosedWindowsManager()
 {
     // Do some file cleaning
     removeClosedItemsConfigFiles();
+    QFile::remove(closedItemsDirectory() + KonqMisc::encodeFilename(QDBusConnection::sessionBus().baseService()));
 
     qDeleteAll(m_closedWindowItemList); // must be done before deleting the kconfigs
     delete m_konqClosedItemsConfig;
@@ -100,6 +121,8 @@ void KonqClosedWindowsManager::addClosedWindowItem(KonqUndoManager
         emitNotifyRemove(last);
 
         m_closedWindowItemList.removeLast();
+        m_closedWindowIndex.remove(windowKey(last));
+        removeWindowState(last);
         delete last;
     }
 
@@ -117,8 +140,14 @@ void KonqClosedWindowsManager::addClosedWindowItem(KonqUndoManager
 
     if (propagate) {
         // if it needs to be propagated means that it's a local window and thus
-        // we need to call to saveConfig() to keep updated the kconfig file, so
-        // that new konqueror instances can read it correctly updated.
+        // we need to write its state and call to saveConfig() to keep updated
+        // the kconfig file, so that new konqueror instances can read it
+        // correctly updated.
+        writeWindowState(closedWindowItem);
+    }
+    m_closedWindowIndex.insert(windowKey(closedWindowItem), closedWindowItem);
+
+    if (propagate) {
         saveConfig();
 
         // Once saved, tell to other konqi processes
@@ -135,12 +164,18 @@ void KonqClosedWindowsManager::removeClosedWindowItem(KonqUndoManager
     // If the item was found, remove it from the list
     if (it != m_closedWindowItemList.end()) {
         m_closedWindowItemList.erase(it);
+        m_closedWindowIndex.remove(windowKey(closedWindowItem));
         m_numUndoClosedItems--;
     }
     emit removeWindowInOtherInstances(real_sender, closedWindowItem);
 
     if (propagate) {
         emitNotifyRemove(closedWindowItem);
+
+        // The window is being reopened or discarded here, nobody else needs
+        // its state. The file is removed without loading it: reopening loads
+        // it beforehand.
+        removeWindowState(closedWindowItem);
     }
 }
 
@@ -176,27 +211,59 @@ bool isSenderOfSignal(const QString &service)
 void KonqClosedWindowsManager::emitNotifyClosedWindowItem(
     const KonqClosedWindowItem *closedWindowItem)
 {
+    const WindowKey key = windowKey(closedWindowItem);
     emit notifyClosedWindowItem(closedWindowItem->title(),
                                 closedWindowItem->numTabs(),
-                                m_konqClosedItemsStore->name(),
-                                closedWindowItem->configGroup().name());
+                                key.first, key.second);
 }
 
 void KonqClosedWindowsManager::emitNotifyRemove(
     const KonqClosedWindowItem *closedWindowItem)
 {
+    const WindowKey key = windowKey(closedWindowItem);
+    emit notifyRemove(key.first, key.second);
+}
+
+KonqClosedWindowsManager::WindowKey KonqClosedWindowsManager::windowKey(
+    const KonqClosedWindowItem *closedWindowItem) const
+{
+    // There's no need to call to configGroup() if it's a remote window item,
+    // and it would load its config file
     const KonqClosedRemoteWindowItem *closedRemoteWindowItem =
         dynamic_cast<const KonqClosedRemoteWindowItem *>(closedWindowItem);
+    if (closedRemoteWindowItem) {
+        return WindowKey(closedRemoteWindowItem->remoteConfigFileName(),
+                         closedRemoteWindowItem->remoteGroupName());
+    }
+    return WindowKey(m_localStateFiles.value(closedWindowItem),
+                     QString::fromLatin1(s_windowStateGroup));
+}
 
-    // Here we do this because there's no need to call to configGroup() if it's
-    // a remote window item, and it would be error prone to be so, because
-    // it could give us a null pointer and konqueror would crash
-    if (closedRemoteWindowItem)
-        emit notifyRemove(closedRemoteWindowItem->remoteConfigFileName(),
-                          closedRemoteWindowItem->remoteGroupName());
-    else
-        emit notifyRemove(closedWindowItem->configGroup().config()->name(),
-                          closedWindowItem->configGroup().name());
+void KonqClosedWindowsManager::writeWindowState(
+    const KonqClosedWindowItem *closedWindowItem)
+{
+    const QString dir = windowStateDirectory();
+    QDir().mkpath(dir);
+    const QString file = dir + QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+    KConfig stateConfig(file, KConfig::SimpleConfig);
+    KConfigGroup stateGroup(&stateConfig, s_windowStateGroup);
+    closedWindowItem->configGroup().copyTo(&stateGroup);
+    if (!stateConfig.sync()) {
+        qCWarning(KONQUEROR_LOG) << "Couldn't save the closed window to" << file;
+    }
+    m_localStateFiles.insert(closedWindowItem, file);
+}
+
+void KonqClosedWindowsManager::removeWindowState(
+    const KonqClosedWindowItem *closedWindowItem)
+{
+    const QString file = windowKey(closedWindowItem).first;
+    m_localStateFiles.remove(closedWindowItem);
+    // Only our own files, not the stores of other processes of older versions
+    if (file.startsWith(windowStateDirectory())) {
+        QFile::remove(file);
+    }
 }
 
 void KonqClosedWindowsManager::slotNotifyClosedWindowItem(
@@ -236,12 +303,9 @@ void KonqClosedWindowsManager::slotNotifyRemove(
 
     // Find the window item. It can be either remote or local
     KonqClosedWindowItem *closedWindowItem =
-        findClosedRemoteWindowItem(configFileName, configGroup);
+        findClosedWindowItem(configFileName, configGroup);
     if (!closedWindowItem) {
-        closedWindowItem = findClosedLocalWindowItem(configFileName, configGroup);
-        if (!closedWindowItem) {
-            return;
-        }
+        return;
     }
 
     // Remove it in all the windows but don't propagate over dbus,
@@ -249,67 +313,37 @@ void KonqClosedWindowsManager::slotNotifyRemove(
     removeClosedWindowItem(nullptr, closedWindowItem, false);
 }
 
-KonqClosedRemoteWindowItem *KonqClosedWindowsManager::findClosedRemoteWindowItem(
+KonqClosedWindowItem *KonqClosedWindowsManager::findClosedWindowItem(
     const QString &configFileName,
     const QString &configGroup)
 {
     readConfig();
-
-    KonqClosedRemoteWindowItem *closedRemoteWindowItem = nullptr;
-    for (QList<KonqClosedWindowItem *>::const_iterator it = m_closedWindowItemList.constBegin();
-            it != m_closedWindowItemList.constEnd(); ++it) {
-        closedRemoteWindowItem = dynamic_cast<KonqClosedRemoteWindowItem *>(*it);
-
-        if (closedRemoteWindowItem &&
-                closedRemoteWindowItem->equalsTo(configFileName, configGroup)) {
-            return closedRemoteWindowItem;
-        }
-    }
-
-    return closedRemoteWindowItem;
-}
-
-KonqClosedWindowItem *KonqClosedWindowsManager::findClosedLocalWindowItem(
-    const QString &configFileName,
-    const QString &configGroup)
-{
-    readConfig();
-    KonqClosedWindowItem *closedWindowItem = nullptr;
-    for (QList<KonqClosedWindowItem *>::const_iterator it = m_closedWindowItemList.constBegin();
-            it != m_closedWindowItemList.constEnd(); ++it) {
-        closedWindowItem = *it;
-        KonqClosedRemoteWindowItem *closedRemoteWindowItem =
-            dynamic_cast<KonqClosedRemoteWindowItem *>(closedWindowItem);
-
-        if (!closedRemoteWindowItem && closedWindowItem &&
-                closedWindowItem->configGroup().config()->name() == configFileName &&
-                closedWindowItem->configGroup().name() == configGroup) {
-            return closedWindowItem;
-        }
-    }
-
-    return closedWindowItem;
+    return m_closedWindowIndex.value(WindowKey(configFileName, configGroup));
 }
 
 /**
- * @returns the number of konqueror processes by counting the number of
- * org.kde.konqueror services in dbus.
+ * @returns the number of konqueror processes, by checking which of the
+ * processes that created a file in @p dir are still on dbus. Every konqueror
+ * process creates one when it starts.
  *
  * If dbus fails it returns -1.
  */
-static int numberOfKonquerorProcesses()
+static int numberOfKonquerorProcesses(const QString &dir)
 {
-    QDBusConnection dbus = QDBusConnection::sessionBus();
-    QDBusReply<QStringList> reply = dbus.interface()->registeredServiceNames();
-    if (!reply.isValid()) {
+    QDBusConnectionInterface *idbus = QDBusConnection::sessionBus().interface();
+    if (!idbus) {
         return -1;
     }
 
-    const QStringList allServices = reply;
-    int count = 0; // count the number of running konqueror processes. Should be at least one, us.
-    for (QStringList::const_iterator it = allServices.begin(), end = allServices.end(); it != end; ++it) {
-        const QString service = *it;
-        if (service.startsWith(QLatin1String("org.kde.konqueror"))) {
+    int count = 0; // Should be at least one, us.
+    QDirIterator it(dir, QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        const QDBusReply<bool> reply = idbus->isServiceRegistered(KonqMisc::decodeFilename(it.fileName()));
+        if (!reply.isValid()) {
+            return -1;
+        }
+        if (reply.value()) {
             count++;
         }
     }
@@ -321,14 +355,27 @@ void KonqClosedWindowsManager::removeClosedItemsConfigFiles()
     // We'll only remove closed items config files if we are the only process
     // left or if dbus fails (just in case there is any other konqi process
     // but we couldn't see it).
-    int count = numberOfKonquerorProcesses();
+    const QString dir = closedItemsDirectory();
+    int count = numberOfKonquerorProcesses(dir);
     if (count > 1 || count == -1) {
         return;
     }
 
     // We are the only instance of konqueror left and thus we can safely remove
-    // all those temporary files.
-    QString dir = QDir::tempPath() + QLatin1Char('/') +  "closeditems/";
+    // the state of windows which aren't in the saved list anymore (e.g. if a
+    // process crashed)...
+    readConfig();
+    QDirIterator stateIt(windowStateDirectory(), QDir::Files);
+    while (stateIt.hasNext()) {
+        const QString filename = stateIt.next();
+        if (!m_closedWindowIndex.contains(WindowKey(filename, QString::fromLatin1(s_windowStateGroup)))) {
+            QFile::remove(filename);
+        }
+    }
+
+    // ... and all those temporary files, including the closed tabs spilled
+    // to disk.
+    QDir(KonqClosedTabItem::spillDirectory()).removeRecursively();
     QDBusConnectionInterface *idbus = QDBusConnection::sessionBus().interface();
     QDirIterator it(dir, QDir::Writable | QDir::Files);
     while (it.hasNext()) {
@@ -351,26 +398,25 @@ void KonqClosedWindowsManager::saveConfig()
 
     KConfig *config = new KConfig(file, KConfig::SimpleConfig);
 
-    // Populate the config file
+    // Populate the config file. The state of the windows is already in their
+    // own files, only list them.
     KonqClosedWindowItem *closedWindowItem = nullptr;
     uint counter = m_closedWindowItemList.size() - 1;
     for (QList<KonqClosedWindowItem *>::const_iterator it = m_closedWindowItemList.constBegin();
             it != m_closedWindowItemList.constEnd(); ++it, --counter) {
         closedWindowItem = *it;
+        const WindowKey key = windowKey(closedWindowItem);
         KConfigGroup configGroup(config, "Closed_Window" + QString::number(counter));
         configGroup.writeEntry("title", closedWindowItem->title());
         configGroup.writeEntry("numTabs", closedWindowItem->numTabs());
-        closedWindowItem->configGroup().copyTo(&configGroup);
+        configGroup.writeEntry("stateFile", key.first);
+        configGroup.writeEntry("stateGroup", key.second);
     }
 
     KConfigGroup configGroup(KSharedConfig::openConfig(), "Undo");
     configGroup.writeEntry("Number of Closed Windows", m_closedWindowItemList.size());
     configGroup.sync();
 
-    // Finally the most important thing, which is to save the store config
-    // so that other konqi processes can reopen windows closed in this process.
-    m_konqClosedItemsStore->sync();
-
     delete config;
 }
 
@@ -391,6 +437,7 @@ void KonqClosedWindowsManager ::readConfig()
     }
 
     m_blockClosedItems = true;
+    bool migrated = false;
     for (int i = 0; i < m_numUndoClosedItems; i++) {
         // For each item, create a new ClosedWindowItem
         KConfigGroup configGroup(m_konqClosedItemsConfig, "Closed_Window" +
@@ -409,17 +456,36 @@ void KonqClosedWindowsManager ::readConfig()
 
         QString title = configGroup.readEntry("title", i18n("no name"));
         int numTabs = configGroup.readEntry("numTabs", 0);
+        QString stateFile = configGroup.readEntry("stateFile", QString());
+        QString stateGroup = configGroup.readEntry("stateGroup", QString());
+
+        if (stateFile.isEmpty()) {
+            // Saved by an older version, with the state of the window in the
+            // list: move it to its own file
+            KonqClosedWindowItem oldItem(title, memoryStore(), i, numTabs);
+            configGroup.copyTo(&oldItem.configGroup());
+            oldItem.configGroup().deleteEntry("title");
+            oldItem.configGroup().deleteEntry("numTabs");
+            writeWindowState(&oldItem);
+            stateFile = m_localStateFiles.take(&oldItem);
+            stateGroup = QString::fromLatin1(s_windowStateGroup);
+            migrated = true;
+        }
 
-        KonqClosedWindowItem *closedWindowItem = new KonqClosedWindowItem(
-            title, memoryStore(), i, numTabs);
-        configGroup.copyTo(&closedWindowItem->configGroup());
-        configGroup.writeEntry("foo", 0);
+        // Only the summary is kept in memory, the state of the window is read
+        // from its file if it's reopened
+        KonqClosedWindowItem *closedWindowItem = new KonqClosedRemoteWindowItem(
+            title, memoryStore(), stateGroup, stateFile, i, numTabs, QString());
 
         // Add the item only to this window
         addClosedWindowItem(nullptr, closedWindowItem, false);
     }
 
     m_blockClosedItems = false;
+
+    if (migrated) {
+        saveConfig();
+    }
 }
 
 bool KonqClosedWindowsManager::undoAvailable() const
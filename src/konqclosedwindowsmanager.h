@@ -9,8 +9,11 @@
 #define KONQCLOSEDWINDOWSMANAGER_H
 
 #include "konqprivate_export.h"
+#include <QHash>
 #include <QList>
 #include <QObject>
+#include <QPair>
+#include <QString>
 class KonqClosedRemoteWindowItem;
 class KonqUndoManager;
 class KConfig;
@@ -26,6 +29,12 @@ class KonqClosedWindowsManagerPrivate;
  *  - it synchronizes the closed window list with other
  * Konqueror instances via DBUS.
  *
+ *  - it saves the closed windows so that new Konqueror instances can reopen
+ * them. The state of each closed window is written once, to its own file,
+ * when it's closed and removed when it's reopened; the closeditems_saved
+ * file only lists the title, number of tabs and state file of each window.
+ * Windows closed in other instances or in previous sessions only keep that
+ * summary in memory, their state is read when they are reopened.
  */
 class KONQ_TESTS_EXPORT KonqClosedWindowsManager : public QObject
 {
@@ -94,12 +103,28 @@ Q_SIGNALS:
                                       KonqClosedWindowItem *closedWindowItem);
 private:
 
-    KonqClosedRemoteWindowItem *findClosedRemoteWindowItem(const QString &configFileName,
-            const QString &configGroup);
+    /**
+     * The config file and group holding the state of a closed window, which
+     * identify it across konqueror processes.
+     */
+    typedef QPair<QString, QString> WindowKey;
 
-    KonqClosedWindowItem *findClosedLocalWindowItem(const QString &configFileName,
+    WindowKey windowKey(const KonqClosedWindowItem *closedWindowItem) const;
+
+    KonqClosedWindowItem *findClosedWindowItem(const QString &configFileName,
             const QString &configGroup);
 
+    /**
+     * Writes the state of a window closed in this process to its own file,
+     * where other processes can read it.
+     */
+    void writeWindowState(const KonqClosedWindowItem *closedWindowItem);
+
+    /**
+     * Removes the file holding the state of a closed window.
+     */
+    void removeWindowState(const KonqClosedWindowItem *closedWindowItem);
+
     /**
      * This function removes all the closed items temporary files. Only done if
      * there's no other konqueror process running than us, otherwise that process
@@ -108,6 +133,9 @@ private:
     void removeClosedItemsConfigFiles();
 private:
     QList<KonqClosedWindowItem *> m_closedWindowItemList;
+    QHash<WindowKey, KonqClosedWindowItem *> m_closedWindowIndex;
+    /// The state files of the windows closed in this process
+    QHash<const KonqClosedWindowItem *, QString> m_localStateFiles;
     int m_numUndoClosedItems;
     KConfig *m_konqClosedItemsConfig, *m_konqClosedItemsStore;
     int m_maxNumClosedItems;
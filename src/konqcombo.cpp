@@ -45,15 +45,15 @@ const int KonqCombo::temporary = 0;
 static QString titleOfURL(const QString &urlStr)
 {
     QUrl url(QUrl::fromUserInput(urlStr));
-    const KonqHistoryList &historylist = KonqHistoryManager::kself()->entries();
-    KonqHistoryList::const_iterator historyentry = historylist.constFindEntry(url);
-    if (historyentry == historylist.constEnd() && !url.url().endsWith('/')) {
+    KonqHistoryManager *historyManager = KonqHistoryManager::kself();
+    KonqHistoryEntry historyentry = historyManager->findEntry(url);
+    if (historyentry.url.isEmpty() && !url.url().endsWith('/')) {
         if (!url.path().endsWith('/')) {
             url.setPath(url.path() + '/');
         }
-        historyentry = historylist.constFindEntry(url);
+        historyentry = historyManager->findEntry(url);
     }
-    return historyentry != historylist.end() ? (*historyentry).title : QString();
+    return historyentry.title;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
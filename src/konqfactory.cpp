@@ -17,6 +17,7 @@
 #include <QWidget>
 #include <QFile>
 #include <QCoreApplication>
+#include <QHash>
 
 // KDE
 #include "konqdebug.h"
@@ -26,10 +27,14 @@
 #include <kmessagebox.h>
 #include <kmimetypetrader.h>
 #include <kservicetypetrader.h>
+#include <kservice_version.h>
+#include <KSycoca>
 
 // Local
 #include "konqsettings.h"
 #include "konqmainwindow.h"
+#include "konqpartpool.h"
+#include "konqstartuptrace.h"
 
 KonqViewFactory::KonqViewFactory(const QString &libName, KPluginFactory *factory)
     : m_libName(libName), m_factory(factory),
@@ -48,12 +53,27 @@ KParts::ReadOnlyPart *KonqViewFactory::create(QWidget *parentWidget, QObject *pa
         return nullptr;
     }
 
+    // Pooled parts have no parent object, like the parts of views
+    if (!parent) {
+        if (KParts::ReadOnlyPart *part = KonqPartPool::self()->take(*this, parentWidget)) {
+            return part;
+        }
+    }
+    return createPart(parentWidget, parent);
+}
+
+KParts::ReadOnlyPart *KonqViewFactory::createPart(QWidget *parentWidget, QObject *parent)
+{
+    if (!m_factory) {
+        return nullptr;
+    }
+    KonqStartupSpan span("Part creation", m_libName);
+
     KParts::ReadOnlyPart *part = m_factory->create<KParts::ReadOnlyPart>(parentWidget, parent, QString(), m_args);
 
     if (!part) {
         qCWarning(KONQUEROR_LOG) << "No KParts::ReadOnlyPart created from" << m_libName;
     } else {
-        KonqParts::Plugin::loadPlugins(part, part, part->componentName());
         QFrame *frame = qobject_cast<QFrame *>(part->widget());
         if (frame) {
             frame->setFrameStyle(QFrame::NoFrame);
@@ -62,6 +82,17 @@ KParts::ReadOnlyPart *KonqViewFactory::create(QWidget *parentWidget, QObject *pa
     return part;
 }
 
+bool KonqViewFactory::loadPlugins(KParts::ReadOnlyPart *part)
+{
+    if (!part || part->property("konqPluginsLoaded").toBool()) {
+        return false;
+    }
+    KonqStartupSpan span("Plugin loading", part->componentName());
+    part->setProperty("konqPluginsLoaded", true);
+    KonqParts::Plugin::loadPlugins(part, part, part->componentName());
+    return true;
+}
+
 static KonqViewFactory tryLoadingService(KService::Ptr service)
 {
     if (auto factoryResult = KPluginFactory::loadFactory(KPluginInfo(service).toMetaData())) {
@@ -177,25 +208,103 @@ KonqViewFactory KonqFactory::createView(const QString &serviceType,
     return viewFactory;
 }
 
-void KonqFactory::getOffers(const QString &serviceType,
-                            KService::List *partServiceOffers,
-                            KService::List *appServiceOffers)
+struct KonqCachedOffers {
+    KService::List partOffers;
+    KService::List appOffers;
+    bool hasPartOffers = false;
+    bool hasAppOffers = false;
+};
+
+class KonqOffersCache
+{
+public:
+    KonqOffersCache()
+    {
+        // Whatever changed, the offers of any service type may be different now
+#if KSERVICE_VERSION >= QT_VERSION_CHECK(5, 80, 0)
+        QObject::connect(KSycoca::self(), QOverload<>::of(&KSycoca::databaseChanged), KSycoca::self(), &KonqFactory::clearOffersCache);
+#else
+        QObject::connect(KSycoca::self(), QOverload<const QStringList &>::of(&KSycoca::databaseChanged), KSycoca::self(), &KonqFactory::clearOffersCache);
+#endif
+    }
+
+    QHash<QString, KonqCachedOffers> offers;
+    KonqFactory::OffersCacheStatistics statistics;
+};
+
+Q_GLOBAL_STATIC(KonqOffersCache, globalOffersCache)
+
+static KService::List queryOffers(const QString &serviceType, bool parts)
 {
+    if (!parts) {
+        return KMimeTypeTrader::self()->query(serviceType, QStringLiteral("Application"),
+                            QStringLiteral("DesktopEntryName != 'kfmclient' and DesktopEntryName != 'kfmclient_dir' and DesktopEntryName != 'kfmclient_html'"));
+    }
 #ifdef __GNUC__
 #warning Temporary hack -- must separate mimetypes and servicetypes better
 #endif
-    if (partServiceOffers && serviceType.length() > 0 && serviceType[0].isUpper()) {
-        *partServiceOffers = KServiceTypeTrader::self()->query(serviceType,
+    if (serviceType.length() > 0 && serviceType[0].isUpper()) {
+        return KServiceTypeTrader::self()->query(serviceType,
                              QStringLiteral("DesktopEntryName != 'kfmclient' and DesktopEntryName != 'kfmclient_dir' and DesktopEntryName != 'kfmclient_html'"));
-        return;
+    }
+    return KMimeTypeTrader::self()->query(serviceType, QStringLiteral("KParts/ReadOnlyPart"));
+}
+
+void KonqFactory::getOffers(const QString &serviceType,
+                            KService::List *partServiceOffers,
+                            KService::List *appServiceOffers)
+{
+    KonqOffersCache *cache = globalOffersCache;
+    // The trader queries would do this: it rebuilds ksycoca (and clears the
+    // cache) if desktop files or file associations changed. It's cheap, the
+    // check is only done once in a while.
+    KSycoca::self()->ensureCacheValid();
 
+    // Not a reference: a query could rebuild ksycoca, and clear the cache
+    KonqCachedOffers cached = cache->offers.value(serviceType);
+    bool hit = true;
+    if (partServiceOffers) {
+        if (!cached.hasPartOffers) {
+            cached.partOffers = queryOffers(serviceType, true);
+            cached.hasPartOffers = true;
+            hit = false;
+        }
+        *partServiceOffers = cached.partOffers;
     }
-    if (appServiceOffers) {
-        *appServiceOffers = KMimeTypeTrader::self()->query(serviceType, QStringLiteral("Application"),
-                            QStringLiteral("DesktopEntryName != 'kfmclient' and DesktopEntryName != 'kfmclient_dir' and DesktopEntryName != 'kfmclient_html'"));
+    // Part-only service types, such as Browser/View, have no applications
+    const bool partsOnly = partServiceOffers && serviceType.length() > 0 && serviceType[0].isUpper();
+    if (appServiceOffers && !partsOnly) {
+        if (!cached.hasAppOffers) {
+            cached.appOffers = queryOffers(serviceType, false);
+            cached.hasAppOffers = true;
+            hit = false;
+        }
+        *appServiceOffers = cached.appOffers;
     }
 
-    if (partServiceOffers) {
-        *partServiceOffers = KMimeTypeTrader::self()->query(serviceType, QStringLiteral("KParts/ReadOnlyPart"));
+    if (hit) {
+        ++cache->statistics.hits;
+    } else {
+        cache->offers.insert(serviceType, cached);
+        ++cache->statistics.misses;
+    }
+}
+
+KonqFactory::OffersCacheStatistics KonqFactory::offersCacheStatistics()
+{
+    OffersCacheStatistics statistics = globalOffersCache->statistics;
+    statistics.serviceTypes = globalOffersCache->offers.count();
+    return statistics;
+}
+
+void KonqFactory::clearOffersCache()
+{
+    if (globalOffersCache.isDestroyed()) {
+        return;
+    }
+    if (!globalOffersCache->offers.isEmpty()) {
+        qCDebug(KONQUEROR_LOG) << "Clearing the cached offers of" << globalOffersCache->offers.count() << "service types";
     }
+    globalOffersCache->offers.clear();
+    ++globalOffersCache->statistics.invalidations;
 }
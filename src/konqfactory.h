@@ -33,8 +33,35 @@ public:
 
     void setArgs(const QVariantList &args);
 
+    QString libName() const
+    {
+        return m_libName;
+    }
+
+    QVariantList args() const
+    {
+        return m_args;
+    }
+
+    /**
+     * Returns the part for a view: an idle one from KonqPartPool if it has
+     * one created by this factory, or a new one.
+     */
     KParts::ReadOnlyPart *create(QWidget *parentWidget, QObject *parent);
 
+    /**
+     * Creates a new part, bypassing the pool.
+     */
+    KParts::ReadOnlyPart *createPart(QWidget *parentWidget, QObject *parent);
+
+    /**
+     * Loads the plugins of @p part and inserts them as its child GUI clients,
+     * unless this was done already. Parts are created without their plugins,
+     * which are only needed once the part is shown, see KonqView::loadPlugins().
+     * @return true if the plugins were loaded now
+     */
+    static bool loadPlugins(KParts::ReadOnlyPart *part);
+
     bool isNull() const
     {
         return m_factory ? false : true;
@@ -69,9 +96,37 @@ public:
                                KService::List *appServiceOffers = nullptr,
                                bool forceAutoEmbed = false);
 
+    /**
+     * Returns the parts and the applications which can handle @p serviceType,
+     * in order of preference.
+     *
+     * The offers are cached per service type, since opening or restoring many
+     * views keeps asking for the same ones. The cache is cleared whenever
+     * the system configuration cache (ksycoca) changes, which includes
+     * changes to the file associations of the user.
+     */
     static void getOffers(const QString &serviceType,
                           KService::List *partServiceOffers = nullptr,
                           KService::List *appServiceOffers = nullptr);
+
+    struct OffersCacheStatistics {
+        int hits = 0;
+        int misses = 0;
+        /// How many times the cache was cleared
+        int invalidations = 0;
+        /// The number of service types currently cached
+        int serviceTypes = 0;
+    };
+
+    /**
+     * Returns statistics about the use of the cache of getOffers().
+     */
+    static OffersCacheStatistics offersCacheStatistics();
+
+    /**
+     * Forgets all the cached offers.
+     */
+    static void clearOffersCache();
 };
 
 #endif
@@ -44,7 +44,9 @@ public:
     enum Option {
         None = 0x0,
         SaveUrls = 0x01,
-        SaveHistoryItems = 0x02
+        SaveHistoryItems = 0x02,
+        // Only the current history item, for a copy which gets the others from copyHistory()
+        SaveCurrentHistoryItem = 0x04
     };
     Q_DECLARE_FLAGS(Options, Option)
 
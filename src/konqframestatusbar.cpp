@@ -19,8 +19,12 @@
 #include <KLocalizedString>
 #include <kactioncollection.h>
 #include <QAction>
+#include <QGuiApplication>
 #include <QIcon>
 #include <QMouseEvent>
+#include <QScreen>
+#include <QtMath>
+#include <QWindow>
 
 static QPixmap statusBarIcon(const char *name)
 {
@@ -69,6 +73,9 @@ private:
 
 #define DEFAULT_HEADER_HEIGHT 13
 
+// m_pendingProgress when no progress was received since the last frame
+static const int s_noPendingProgress = -2;
+
 void KonqCheckBox::paintEvent(QPaintEvent *)
 {
     QPainter p(this);
@@ -83,10 +90,18 @@ void KonqCheckBox::paintEvent(QPaintEvent *)
 KonqFrameStatusBar::KonqFrameStatusBar(KonqFrame *_parent)
     : QStatusBar(_parent),
       m_pParentKonqFrame(_parent),
-      m_pStatusLabel(nullptr)
+      m_pStatusLabel(nullptr),
+      m_pendingProgress(s_noPendingProgress),
+      m_hasPendingSpeed(false),
+      m_pendingSpeed(0),
+      m_hasPendingMessage(false),
+      m_pendingMessageType(KonqStatusBarMessageLabel::Default)
 {
     setSizeGripEnabled(false);
 
+    m_updateTimer.setSingleShot(true);
+    connect(&m_updateTimer, &QTimer::timeout, this, &KonqFrameStatusBar::applyPendingUpdates);
+
     // TODO remove active view indicator and use a different bg color like dolphin does?
     // Works nicely for file management, but not so much with other parts...
     m_led = new QLabel(this);
@@ -195,7 +210,8 @@ void KonqFrameStatusBar::message(const QString &msg)
     // We don't use the message()/clear() mechanism of QStatusBar because
     // it really looks ugly (the label border goes away, the active-view indicator
     // is hidden...)
-    QString saveMsg = m_savedMessage;
+    // A speed not shown yet is what clearing the message has to bring back
+    QString saveMsg = m_hasPendingSpeed ? speedText(m_pendingSpeed) : m_savedMessage;
     slotDisplayStatusText(msg);
     m_savedMessage = saveMsg;
 }
@@ -203,38 +219,92 @@ void KonqFrameStatusBar::message(const QString &msg)
 void KonqFrameStatusBar::slotDisplayStatusText(const QString &text)
 {
     //qCDebug(KONQUEROR_LOG) << text;
-    m_pStatusLabel->setMessage(text, KonqStatusBarMessageLabel::Default);
+    m_pendingMessage = text;
+    m_pendingMessageType = KonqStatusBarMessageLabel::Default;
+    m_hasPendingMessage = true;
+    m_hasPendingSpeed = false;
     m_savedMessage = text;
+    scheduleUpdate();
 }
 
 // ### TODO: was also used in kde3 for the signals from kactioncollection...
 void KonqFrameStatusBar::slotClear()
 {
+    // Like every other update, the clear goes through the pending message,
+    // which replaces a speed not shown yet with the text it would have saved
+    if (m_hasPendingSpeed) {
+        m_savedMessage = speedText(m_pendingSpeed);
+    }
     slotDisplayStatusText(m_savedMessage);
 }
 
 void KonqFrameStatusBar::slotLoadingProgress(int percent)
 {
-    if (percent == -1 || percent == 100) { // hide on error and on success
-        m_progressBar->hide();
-    } else {
-        m_progressBar->show();
-    }
-
-    m_progressBar->setValue(percent);
+    m_pendingProgress = percent;
+    scheduleUpdate();
 }
 
 void KonqFrameStatusBar::slotSpeedProgress(int bytesPerSecond)
 {
-    QString sizeStr;
+    // Formatted when shown, most values never are
+    m_pendingSpeed = bytesPerSecond;
+    m_hasPendingSpeed = true;
+    m_hasPendingMessage = false;
+    scheduleUpdate();
+}
 
+QString KonqFrameStatusBar::speedText(int bytesPerSecond)
+{
     if (bytesPerSecond > 0) {
-        sizeStr = i18n("%1/s", KIO::convertSize(bytesPerSecond));
-    } else {
-        sizeStr = i18n("Stalled");
+        return i18n("%1/s", KIO::convertSize(bytesPerSecond));
+    }
+    return i18n("Stalled");
+}
+
+void KonqFrameStatusBar::scheduleUpdate()
+{
+    // Nothing is painted while hidden, showEvent() catches up
+    if (m_updateTimer.isActive() || !isVisible()) {
+        return;
     }
+    const QWindow *window = this->window()->windowHandle();
+    const QScreen *screen = window ? window->screen() : QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60;
+    m_updateTimer.start(qCeil(1000 / refreshRate));
+}
+
+void KonqFrameStatusBar::applyPendingUpdates()
+{
+    m_updateTimer.stop();
+
+    if (m_pendingProgress != s_noPendingProgress) {
+        const int percent = m_pendingProgress;
+        m_pendingProgress = s_noPendingProgress;
+        if (percent == -1 || percent == 100) { // hide on error and on success
+            m_progressBar->hide();
+        } else {
+            m_progressBar->show();
+        }
+        m_progressBar->setValue(percent);
+    }
+
+    if (m_hasPendingSpeed) {
+        m_hasPendingSpeed = false;
+        const QString sizeStr = speedText(m_pendingSpeed);
+        m_pStatusLabel->setMessage(sizeStr, KonqStatusBarMessageLabel::Default);   // let's share the same label...
+        m_savedMessage = sizeStr;
+    } else if (m_hasPendingMessage) {
+        m_hasPendingMessage = false;
+        m_pStatusLabel->setMessage(m_pendingMessage, m_pendingMessageType);
+    }
+}
 
-    slotDisplayStatusText(sizeStr);   // let's share the same label...
+void KonqFrameStatusBar::showEvent(QShowEvent *event)
+{
+    QStatusBar::showEvent(event);
+    if (m_pendingProgress != s_noPendingProgress || m_hasPendingSpeed || m_hasPendingMessage) {
+        scheduleUpdate();
+    }
 }
 
 void KonqFrameStatusBar::slotConnectToNewView(KonqView *, KParts::ReadOnlyPart *, KParts::ReadOnlyPart *newOne)
@@ -286,6 +356,16 @@ void KonqFrameStatusBar::updateActiveStatus()
 
 void KonqFrameStatusBar::setMessage(const QString &msg, KonqStatusBarMessageLabel::Type type)
 {
-    m_pStatusLabel->setMessage(msg, type);
+    if (type == KonqStatusBarMessageLabel::Error) {
+        // Never superseded: the label queues them
+        applyPendingUpdates();
+        m_pStatusLabel->setMessage(msg, type);
+        return;
+    }
+    m_pendingMessage = msg;
+    m_pendingMessageType = type;
+    m_hasPendingMessage = true;
+    m_hasPendingSpeed = false;
+    scheduleUpdate();
 }
 
@@ -9,6 +9,7 @@
 #define KONQ_FRAMESTATUSBAR_H
 
 #include <QStatusBar>
+#include <QTimer>
 #include "konqstatusbarmessagelabel.h"
 class QLabel;
 class QProgressBar;
@@ -23,6 +24,12 @@ class ReadOnlyPart;
 /**
  * The KonqFrameStatusBar is the statusbar under each konqueror view.
  * It indicates in particular whether a view is active or not.
+ *
+ * Parts can report their progress thousands of times per second, so the
+ * progress, speed and messages aren't shown right away: only the latest
+ * ones are, once per frame of the display, and not at all while the
+ * statusbar is hidden. Error messages are the exception, they are queued
+ * by the message label and shown right away.
  */
 class KonqFrameStatusBar : public QStatusBar
 {
@@ -74,18 +81,36 @@ Q_SIGNALS:
 protected:
     bool eventFilter(QObject *, QEvent *) override;
     void mousePressEvent(QMouseEvent *) override;
+    void showEvent(QShowEvent *) override;
     /**
      * Brings up the context menu for this frame
      */
     virtual void splitFrameMenu();
 
+private Q_SLOTS:
+    /**
+     * Shows the latest progress, speed and message received since the last frame
+     */
+    void applyPendingUpdates();
+
 private:
+    void scheduleUpdate();
+    static QString speedText(int bytesPerSecond);
+
     KonqFrame *m_pParentKonqFrame;
     QCheckBox *m_pLinkedViewCheckBox;
     QProgressBar *m_progressBar;
     KonqStatusBarMessageLabel *m_pStatusLabel;
     QLabel *m_led;
     QString m_savedMessage;
+
+    QTimer m_updateTimer;
+    int m_pendingProgress;
+    bool m_hasPendingSpeed;
+    int m_pendingSpeed;
+    bool m_hasPendingMessage;
+    QString m_pendingMessage;
+    KonqStatusBarMessageLabel::Type m_pendingMessageType;
 };
 
 #endif /* KONQ_FRAMESTATUSBAR_H */
@@ -0,0 +1,204 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqhibernator.h"
+#include "konqmainwindow.h"
+#include "konqpartpool.h"
+#include "konqview.h"
+#include "konqviewmetrics.h"
+#include "konqsettingsxt.h"
+#include "konqdebug.h"
+
+#include <KPluginFactory>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSet>
+#include <QWidget>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+class KonqHibernatedPartFactory : public KPluginFactory
+{
+public:
+    KonqHibernatedPartFactory()
+    {
+        registerPlugin<KonqHibernatedPart>();
+    }
+};
+
+Q_GLOBAL_STATIC(KonqHibernatedPartFactory, globalHibernatedPartFactory)
+
+KonqHibernatedPart::KonqHibernatedPart(QWidget *parentWidget, QObject *parent, const QVariantList &args)
+    : KParts::ReadOnlyPart(parent)
+{
+    Q_UNUSED(args);
+    setWidget(new QWidget(parentWidget));
+}
+
+KPluginFactory *KonqHibernatedPart::factory()
+{
+    return globalHibernatedPartFactory;
+}
+
+bool KonqHibernatedPart::openUrl(const QUrl &url)
+{
+    // KonqView wakes up before opening anything, there's nothing to load here
+    setUrl(url);
+    return true;
+}
+
+bool KonqHibernatedPart::openFile()
+{
+    return true;
+}
+
+class KonqHibernatorSingleton
+{
+public:
+    KonqHibernator self;
+};
+
+Q_GLOBAL_STATIC(KonqHibernatorSingleton, globalHibernator)
+
+KonqHibernator *KonqHibernator::self()
+{
+    return &globalHibernator->self;
+}
+
+// How often idle time and memory use are checked
+static const int s_checkInterval = 60 * 1000;
+
+KonqHibernator::KonqHibernator()
+    : QObject(nullptr)
+    , m_residentMemory(&KonqHibernator::residentMemory)
+{
+    m_timer.setInterval(s_checkInterval);
+    connect(&m_timer, &QTimer::timeout, this, &KonqHibernator::slotCheckViews);
+    reparseConfiguration();
+}
+
+void KonqHibernator::reparseConfiguration()
+{
+    if (KonqSettings::hibernationIdleTime() > 0 || KonqSettings::hibernationMemoryBudget() > 0) {
+        m_timer.start();
+    } else {
+        m_timer.stop();
+    }
+}
+
+void KonqHibernator::slotCheckViews()
+{
+    const int idleMinutes = KonqSettings::hibernationIdleTime();
+    const qint64 idleTime = idleMinutes > 0 ? qint64(idleMinutes) * 60 * 1000 : -1;
+    hibernateViews(idleTime, qint64(KonqSettings::hibernationMemoryBudget()) * 1024 * 1024);
+}
+
+int KonqHibernator::hibernateViews(qint64 idleTime, qint64 memoryBudget)
+{
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    if (!windows) {
+        return 0;
+    }
+
+    QVector<KonqView *> candidates;
+    int liveViews = 0;
+    for (KonqMainWindow *window : qAsConst(*windows)) {
+        for (KonqView *view : window->viewMap()) {
+            if (view->isHibernated()) {
+                continue;
+            }
+            ++liveViews;
+            if (view->canHibernate()) {
+                candidates.append(view);
+            }
+        }
+    }
+    // Least recently used first
+    std::sort(candidates.begin(), candidates.end(), [](KonqView *a, KonqView *b) {
+        return a->idleTime() > b->idleTime();
+    });
+
+    int hibernated = 0;
+    int next = 0;
+    if (idleTime >= 0) {
+        for (; next < candidates.count() && candidates.at(next)->idleTime() >= idleTime; ++next) {
+            if (candidates.at(next)->hibernate()) {
+                ++hibernated;
+            }
+        }
+    }
+
+    if (memoryBudget > 0) {
+        const qint64 memory = viewsMemory();
+        if (memory > memoryBudget) {
+            // Parts kept ready for new views are the first to go
+            KonqPartPool::self()->releaseParts();
+            // Memory isn't returned to the system right away, so assume every
+            // live view uses the same share of it rather than measuring again
+            const int liveAfterIdle = liveViews - hibernated;
+            const int toRelease = int((liveAfterIdle * (memory - memoryBudget) + memory - 1) / memory);
+            const int end = qMin(candidates.count(), next + toRelease);
+            for (; next < end; ++next) {
+                if (candidates.at(next)->hibernate()) {
+                    ++hibernated;
+                }
+            }
+        }
+    }
+
+    if (hibernated > 0) {
+        qCDebug(KONQUEROR_LOG) << "Hibernated" << hibernated << "views";
+    }
+    return hibernated;
+}
+
+qint64 KonqHibernator::viewsMemory() const
+{
+    // Views of the same site can share a renderer
+    QSet<qint64> pids;
+    pids.insert(QCoreApplication::applicationPid());
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    if (windows) {
+        for (KonqMainWindow *window : qAsConst(*windows)) {
+            for (KonqView *view : window->viewMap()) {
+                pids.insert(KonqViewMetrics::rendererPid(view->part()));
+            }
+        }
+    }
+
+    qint64 memory = 0;
+    for (qint64 pid : qAsConst(pids)) {
+        memory += m_residentMemory(pid);
+    }
+    return memory;
+}
+
+void KonqHibernator::setResidentMemoryFunction(ResidentMemoryFunction function)
+{
+    m_residentMemory = function ? function : &KonqHibernator::residentMemory;
+}
+
+qint64 KonqHibernator::residentMemory(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    QFile file(pid > 0 ? QStringLiteral("/proc/%1/statm").arg(pid) : QStringLiteral("/proc/self/statm"));
+    if (file.open(QIODevice::ReadOnly)) {
+        // size resident shared text lib data dt, in pages
+        const QList<QByteArray> fields = file.readLine().split(' ');
+        if (fields.count() > 1) {
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return 0;
+}
@@ -0,0 +1,105 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQHIBERNATOR_H
+#define KONQHIBERNATOR_H
+
+#include "konqprivate_export.h"
+
+#include <KParts/ReadOnlyPart>
+
+#include <QObject>
+#include <QTimer>
+
+class KPluginFactory;
+
+/**
+ * The part shown by a hibernated KonqView in place of its real part.
+ * It only remembers the URL of the view, and never loads anything.
+ */
+class KonqHibernatedPart : public KParts::ReadOnlyPart
+{
+    Q_OBJECT
+public:
+    KonqHibernatedPart(QWidget *parentWidget, QObject *parent, const QVariantList &args);
+
+    void setHibernatedUrl(const QUrl &url)
+    {
+        setUrl(url);
+    }
+
+    /**
+     * Returns the factory used to create hibernated parts with a KonqViewFactory.
+     */
+    static KPluginFactory *factory();
+
+    bool openUrl(const QUrl &url) override;
+
+protected:
+    bool openFile() override;
+};
+
+/**
+ * Hibernates inactive views (see KonqView::hibernate()) which have been
+ * idle for longer than the configured time, and the least recently used
+ * ones when the resident memory of the process and of the renderer
+ * processes of the views exceeds the configured budget. Both are checked
+ * periodically; nothing happens when neither is configured.
+ */
+class KONQ_TESTS_EXPORT KonqHibernator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static KonqHibernator *self();
+
+    /**
+     * Starts or stops the periodic checks according to the settings.
+     */
+    void reparseConfiguration();
+
+    /**
+     * Hibernates the views of all windows idle for at least @p idleTime
+     * milliseconds (if it isn't negative), and then, as long as the memory
+     * used by the views (see viewsMemory()) is over @p memoryBudget bytes
+     * (if it isn't 0), a share of the remaining views, least recently used
+     * first.
+     * @return the number of views hibernated
+     */
+    int hibernateViews(qint64 idleTime, qint64 memoryBudget = 0);
+
+    /**
+     * Returns the resident memory of this process and of the processes
+     * rendering the views of all windows (see KonqViewMetrics::rendererPid()),
+     * each process counted once, in bytes.
+     */
+    qint64 viewsMemory() const;
+
+    /**
+     * Returns the resident memory of the process @p pid, or of this one if
+     * it's 0, in bytes, or 0 if it can't be determined on this platform.
+     */
+    static qint64 residentMemory(qint64 pid = 0);
+
+    typedef qint64 (*ResidentMemoryFunction)(qint64 pid);
+    /**
+     * Makes viewsMemory() measure processes with @p function rather than
+     * residentMemory(), for tests. nullptr restores residentMemory().
+     */
+    void setResidentMemoryFunction(ResidentMemoryFunction function);
+
+private Q_SLOTS:
+    void slotCheckViews();
+
+private:
+    KonqHibernator();
+    friend class KonqHibernatorSingleton;
+
+    QTimer m_timer;
+    ResidentMemoryFunction m_residentMemory;
+};
+
+#endif // KONQHIBERNATOR_H
@@ -27,11 +27,13 @@ KonqHistoryManager::KonqHistoryManager(KBookmarkManager *bookmarkManager, QObjec
     m_pCompletion->setOrder(KCompletion::Weighted);
 
     // and load the history
+    connect(this, &KonqHistoryManager::entriesLoaded, this, &KonqHistoryManager::slotEntriesLoaded);
     loadHistory();
 
     connect(m_updateTimer, &QTimer::timeout, this, &KonqHistoryManager::slotEmitUpdated);
     connect(this, &KonqHistoryManager::cleared, this, &KonqHistoryManager::slotCleared);
     connect(this, &KonqHistoryManager::entryRemoved, this, &KonqHistoryManager::slotEntryRemoved);
+    connect(this, &KonqHistoryManager::entriesRemoved, this, &KonqHistoryManager::slotEntriesRemoved);
 }
 
 KonqHistoryManager::~KonqHistoryManager()
@@ -45,18 +47,18 @@ bool KonqHistoryManager::loadHistory()
     clearPending();
     m_pCompletion->clear();
 
-    if (!KonqHistoryProvider::loadHistory()) {
-        return false;
-    }
+    // The completion is filled by slotEntriesLoaded()
+    return KonqHistoryProvider::loadHistory();
+}
 
-    QListIterator<KonqHistoryEntry> it(entries());
-    while (it.hasNext()) {
-        const KonqHistoryEntry &entry = it.next();
+void KonqHistoryManager::slotEntriesLoaded(const KonqHistoryList &entries)
+{
+    // A chunk at a time while idle after startup: the oldest urls are only
+    // completed a moment after the first window shows up
+    for (const KonqHistoryEntry &entry : entries) {
         const QString prettyUrlString = entry.url.toDisplayString();
         addToCompletion(prettyUrlString, entry.typedUrl, entry.numberOfTimesVisited);
     }
-
-    return true;
 }
 
 void KonqHistoryManager::addPending(const QUrl &url, const QString &typedUrl,
@@ -126,9 +128,9 @@ void KonqHistoryManager::addToHistory(bool pending, const QUrl &_url,
         // We add a copy of the current history entry of the url to the
         // pending list, so that we can restore it if the user canceled.
         // If there is no entry for the url yet, we just store the url.
-        KonqHistoryList::const_iterator oldEntry = constFindEntry(url);
-        m_pending.insert(u, (oldEntry != entries().constEnd()) ?
-                         new KonqHistoryEntry(*oldEntry) : nullptr);
+        const KonqHistoryEntry oldEntry = findEntry(url);
+        m_pending.insert(u, !oldEntry.url.isEmpty() ?
+                         new KonqHistoryEntry(oldEntry) : nullptr);
     }
 
     // notify all konqueror instances about the entry
@@ -268,3 +270,14 @@ void KonqHistoryManager::slotEntryRemoved(const KonqHistoryEntry &entry)
     removeFromCompletion(entry.url.toDisplayString(), entry.typedUrl);
     addToUpdateList(urlString);
 }
+
+void KonqHistoryManager::slotEntriesRemoved(const KonqHistoryList &entries)
+{
+    m_updateURLs.reserve(m_updateURLs.count() + entries.count());
+    for (const KonqHistoryEntry &entry : entries) {
+        removeFromCompletion(entry.url.toDisplayString(), entry.typedUrl);
+        m_updateURLs.append(entry.url.url());
+    }
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->start(500);
+}
@@ -145,6 +145,8 @@ private Q_SLOTS:
 
     void slotCleared();
     void slotEntryRemoved(const KonqHistoryEntry &entry);
+    void slotEntriesRemoved(const KonqHistoryList &entries);
+    void slotEntriesLoaded(const KonqHistoryList &entries);
 
 private:
     void finishAddingEntry(const KonqHistoryEntry &entry, bool isSender) override;
@@ -207,6 +207,10 @@ QList<QUrl> GroupEntry::urls() const
 
 }
 
+// Past this many removed entries, resetting the model is cheaper than
+// removing their rows
+static const int s_maxRemovedRows = 1000;
+
 static QString groupForUrl(const QUrl &url)
 {
     if (url.isLocalFile()) {
@@ -227,6 +231,8 @@ KonqHistoryModel::KonqHistoryModel(QObject *parent)
             this, SLOT(slotEntryAdded(KonqHistoryEntry)));
     connect(provider, SIGNAL(entryRemoved(KonqHistoryEntry)),
             this, SLOT(slotEntryRemoved(KonqHistoryEntry)));
+    connect(provider, SIGNAL(entriesRemoved(KonqHistoryList)),
+            this, SLOT(slotEntriesRemoved(KonqHistoryList)));
 
     KonqHistoryList entries(provider->entries());
 
@@ -412,6 +418,86 @@ void KonqHistoryModel::slotEntryRemoved(const KonqHistoryEntry &entry)
     }
 }
 
+void KonqHistoryModel::slotEntriesRemoved(const KonqHistoryList &entries)
+{
+    QHash<KHM::GroupEntry *, QSet<QUrl>> removedUrls;
+    for (const KonqHistoryEntry &entry : entries) {
+        KHM::GroupEntry *group = m_root->groupsByName.value(groupForUrl(entry.url));
+        if (group) {
+            removedUrls[group].insert(entry.url);
+        }
+    }
+    if (removedUrls.isEmpty()) {
+        return;
+    }
+
+    // Removing rows keeps the expanded groups and the selection of the
+    // attached views, but every removal makes them lay out again: past a
+    // large batch, reset the model once instead.
+    const bool reset = entries.count() > s_maxRemovedRows;
+    if (reset) {
+        beginResetModel();
+    }
+    QHash<KHM::GroupEntry *, QSet<QUrl>>::const_iterator it = removedUrls.constBegin();
+    const QHash<KHM::GroupEntry *, QSet<QUrl>>::const_iterator end = removedUrls.constEnd();
+    for (; it != end; ++it) {
+        removeEntries(it.key(), it.value(), reset ? DontEmitSignals : EmitSignals);
+    }
+    if (reset) {
+        endResetModel();
+    }
+}
+
+void KonqHistoryModel::removeEntries(KHM::GroupEntry *group, const QSet<QUrl> &urls, SignalEmission se)
+{
+    QList<KHM::HistoryEntry *> &items = group->entries;
+    int remaining = items.count();
+    for (KHM::HistoryEntry *item : qAsConst(items)) {
+        if (urls.contains(item->entry.url)) {
+            --remaining;
+        }
+    }
+
+    if (remaining == 0) {
+        const int row = m_root->groups.indexOf(group);
+        if (se == EmitSignals) {
+            beginRemoveRows(QModelIndex(), row, row);
+        }
+        m_root->groupsByName.remove(group->key);
+        m_root->groups.removeAt(row);
+        delete group;
+        if (se == EmitSignals) {
+            endRemoveRows();
+        }
+        return;
+    }
+
+    // Remove each run of consecutive rows at once, starting from the last
+    // one so that the rows still to remove keep their position
+    const QModelIndex groupIndex = indexFor(group);
+    int last = items.count() - 1;
+    while (last >= 0) {
+        if (!urls.contains(items.at(last)->entry.url)) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && urls.contains(items.at(first - 1)->entry.url)) {
+            --first;
+        }
+        if (se == EmitSignals) {
+            beginRemoveRows(groupIndex, first, last);
+        }
+        for (int i = last; i >= first; --i) {
+            delete items.takeAt(i);
+        }
+        if (se == EmitSignals) {
+            endRemoveRows();
+        }
+        last = first - 1;
+    }
+}
+
 KHM::Entry *KonqHistoryModel::entryFromIndex(const QModelIndex &index, bool returnRootIfNull) const
 {
     if (index.isValid()) {
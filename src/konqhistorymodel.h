@@ -8,6 +8,7 @@
 #define KONQ_HISTORYMODEL_H
 
 #include <QAbstractItemModel>
+#include <QSet>
 
 #include "konq_historyentry.h"
 
@@ -42,11 +43,13 @@ public Q_SLOTS:
 private Q_SLOTS:
     void slotEntryAdded(const KonqHistoryEntry &);
     void slotEntryRemoved(const KonqHistoryEntry &);
+    void slotEntriesRemoved(const KonqHistoryList &);
 
 private:
     enum SignalEmission { EmitSignals, DontEmitSignals };
     KHM::Entry *entryFromIndex(const QModelIndex &index, bool returnRootIfNull = false) const;
     KHM::GroupEntry *getGroupItem(const QUrl &url, SignalEmission se);
+    void removeEntries(KHM::GroupEntry *group, const QSet<QUrl> &urls, SignalEmission se);
     QModelIndex indexFor(KHM::HistoryEntry *entry) const;
     QModelIndex indexFor(KHM::GroupEntry *entry) const;
 
@@ -15,6 +15,7 @@
 #include "konqsettingsxt.h"
 #include "konqurl.h"
 #include "konqclosedwindowsmanager.h"
+#include "konqstartuptrace.h"
 
 #include <KAboutData>
 #include <KCrash>
@@ -163,8 +164,11 @@ static void fixOldStartUrl() {
 
 extern "C" Q_DECL_EXPORT int kdemain(int argc, char **argv)
 {
+    KonqStartupTrace *trace = KonqStartupTrace::self(); // starts the clock
     QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts); // says QtWebEngine
     KonquerorApplication app(argc, argv);
+    trace->addSpan("Application", 0, trace->now());
+    const qint64 initializationStart = trace->now();
     KLocalizedString::setApplicationDomain("konqueror");
 
     KAboutData aboutData("konqueror", i18n("Konqueror"), KONQUEROR_VERSION);
@@ -253,8 +257,11 @@ extern "C" Q_DECL_EXPORT int kdemain(int argc, char **argv)
     });
 
     fixOldStartUrl();
+    // From the application to the first window: command line, D-Bus, settings
+    trace->addSpan("Initialization", initializationStart, trace->now());
 
     if (app.isSessionRestored()) {
+        KonqStartupSpan span("Session restore");
         KonqSessionManager::self()->askUserToRestoreAutosavedAbandonedSessions();
 
         int n = 1;
@@ -270,6 +277,7 @@ extern "C" Q_DECL_EXPORT int kdemain(int argc, char **argv)
     } else if (parser.isSet("preload")) {
         new KonqMainWindow(KonqUrl::url(KonqUrl::Type::Blank)); // prepare an empty window, with the web renderer preloaded
     } else {
+        KonqStartupSpan span("Command line");
         int ret = 0;
         KonqMainWindow *mainWindow = handleCommandLine(parser, QDir::currentPath(), &ret);
         if (!mainWindow) {
@@ -281,6 +289,10 @@ extern "C" Q_DECL_EXPORT int kdemain(int argc, char **argv)
 
     const int ret = app.exec();
 
+    if (trace->isEnabled()) {
+        trace->write(); // in case no page was ever loaded
+    }
+
     bool alwaysPreload = KonqSettings::alwaysHavePreloaded();
 
     // Delete all KonqMainWindows, so that we don't have
@@ -12,6 +12,11 @@
 #include "konqmouseeventfilter.h"
 #include "konqclosedwindowsmanager.h"
 #include "konqsessionmanager.h"
+#include "konqhibernator.h"
+#include "konqmemorypressurehandler.h"
+#include "konqpartpool.h"
+#include "konqmimetypecache.h"
+#include "konqstartuptrace.h"
 #include "konqsessiondlg.h"
 #include "konqdraggablelabel.h"
 #include "konqcloseditem.h"
@@ -194,6 +199,7 @@ KonqMainWindow::KonqMainWindow(const QUrl &initialURL)
     , m_pURLCompletion(nullptr)
     , m_isPopupWithProxyWindow(false)
 {
+    KonqStartupSpan span("Main window");
     if (!s_lstMainWindows) {
         s_lstMainWindows = new QList<KonqMainWindow *>;
     }
@@ -235,12 +241,19 @@ KonqMainWindow::KonqMainWindow(const QUrl &initialURL)
 
     // init history-manager, load history, get completion object
     if (!s_pCompletion) {
-        s_bookmarkManager = KBookmarkManager::userBookmarksManager();
+        {
+            KonqStartupSpan span("Bookmark manager");
+            s_bookmarkManager = KBookmarkManager::userBookmarksManager();
 
-        // let the KBookmarkManager know that we are a browser, equals to "keditbookmarks --browser"
-        s_bookmarkManager->setEditorOptions(QStringLiteral("konqueror"), true);
+            // let the KBookmarkManager know that we are a browser, equals to "keditbookmarks --browser"
+            s_bookmarkManager->setEditorOptions(QStringLiteral("konqueror"), true);
+        }
 
-        KonqHistoryManager *mgr = new KonqHistoryManager(s_bookmarkManager);
+        KonqHistoryManager *mgr;
+        {
+            KonqStartupSpan span("History");
+            mgr = new KonqHistoryManager(s_bookmarkManager);
+        }
         s_pCompletion = mgr->completionObject();
 
         // setup the completion object before createGUI(), so that the combo
@@ -264,6 +277,7 @@ KonqMainWindow::KonqMainWindow(const QUrl &initialURL)
     connect(m_pUndoManager, SIGNAL(undoAvailable(bool)),
             this, SLOT(slotUndoAvailable(bool)));
 
+    const qint64 guiStart = KonqStartupTrace::self()->now();
     initCombo();
     initActions();
 
@@ -272,6 +286,11 @@ KonqMainWindow::KonqMainWindow(const QUrl &initialURL)
     setStandardToolBarMenuEnabled(true);
 
     createGUI(nullptr);
+    KonqStartupTrace::self()->addSpan("GUI building", guiStart, KonqStartupTrace::self()->now());
+
+    // The plugins of the first part only add to its GUI, they can wait until the window is shown
+    DelayedInitializer *pluginInitializer = new DelayedInitializer(QEvent::Show, this);
+    connect(pluginInitializer, &DelayedInitializer::initialize, this, &KonqMainWindow::initPartPlugins);
 
     m_combo->setParent(toolBar(QStringLiteral("locationToolBar")));
     m_combo->show();
@@ -305,8 +324,12 @@ KonqMainWindow::KonqMainWindow(const QUrl &initialURL)
 
     //qCDebug(KONQUEROR_LOG) << this << "created";
 
-    KonqSessionManager::self();
     m_fullyConstructed = true;
+    KonqSessionManager::self()->markWindowDirty(this);
+    KonqHibernator::self();
+    KonqMemoryPressureHandler::self();
+    KonqPartPool::self()->scheduleRefill();
+    connect(KonqMimeTypeCache::self(), &KonqMimeTypeCache::verified, this, &KonqMainWindow::slotMimeTypeVerified);
 }
 
 KonqMainWindow::~KonqMainWindow()
@@ -345,6 +368,8 @@ KonqMainWindow::~KonqMainWindow()
     if (s_lstMainWindows == nullptr) {
         delete s_comboConfig;
         s_comboConfig = nullptr;
+        // Nothing left to open views in
+        KonqPartPool::self()->releaseParts();
     }
 
     delete m_configureDialog;
@@ -381,6 +406,15 @@ QWidget *KonqMainWindow::createContainer(QWidget *parent, int index, const QDomE
         }
     }
 
+    // The toolbar settings are saved with the window, see saveMainWindowSettings()
+    if (KToolBar *bar = qobject_cast<KToolBar *>(res)) {
+        connect(bar, &QToolBar::iconSizeChanged, this, &KonqMainWindow::slotMainWindowSettingsChanged, Qt::UniqueConnection);
+        connect(bar, &QToolBar::toolButtonStyleChanged, this, &KonqMainWindow::slotMainWindowSettingsChanged, Qt::UniqueConnection);
+        connect(bar, &QToolBar::orientationChanged, this, &KonqMainWindow::slotMainWindowSettingsChanged, Qt::UniqueConnection);
+        connect(bar, &QToolBar::topLevelChanged, this, &KonqMainWindow::slotMainWindowSettingsChanged, Qt::UniqueConnection);
+        connect(bar, &QToolBar::visibilityChanged, this, &KonqMainWindow::slotMainWindowSettingsChanged, Qt::UniqueConnection);
+    }
+
     if (res && element.tagName() == QLatin1String("Menu")) {
         const QString &menuName = element.attribute(QStringLiteral("name"));
         if (menuName == QLatin1String("edit") || menuName == QLatin1String("tools")) {
@@ -392,6 +426,13 @@ QWidget *KonqMainWindow::createContainer(QWidget *parent, int index, const QDomE
     return res;
 }
 
+void KonqMainWindow::initPartPlugins()
+{
+    if (m_currentView) {
+        m_currentView->loadPlugins();
+    }
+}
+
 void KonqMainWindow::initBookmarkBar()
 {
     KToolBar *bar = this->findChild<KToolBar *>(QStringLiteral("bookmarkToolBar"));
@@ -1480,6 +1521,20 @@ void KonqMainWindow::slotIconsChanged()
     updateWindowIcon();
 }
 
+void KonqMainWindow::slotMimeTypeVerified(const QUrl &url, const QString &guessedMimeType, const QString &mimeType)
+{
+    if (mimeType.isEmpty() || mimeType == guessedMimeType) {
+        return;
+    }
+    // The part was chosen from a wrong guess, open the URL again with the right one
+    const MapViews views = m_mapViews; // changing the part changes the map
+    for (KonqView *view : views) {
+        if (view->url() == url && view->serviceType() == guessedMimeType) {
+            openUrl(view, url, mimeType);
+        }
+    }
+}
+
 void KonqMainWindow::slotOpenWith()
 {
     if (!m_currentView) {
@@ -1880,6 +1935,14 @@ void KonqMainWindow::slotPartActivated(KParts::Part *part)
             //qCDebug(KONQUEROR_LOG) << "Passive mode - return";
             return;
         }
+        if (newView->isHibernated()) {
+            // Recreating the real part makes it the active one (see
+            // slotPartChanged), which calls this method again
+            newView->wakeUp();
+            if (!newView->isHibernated()) {
+                return;
+            }
+        }
     }
 
     KParts::BrowserExtension *ext = nullptr;
@@ -1893,7 +1956,15 @@ void KonqMainWindow::slotPartActivated(KParts::Part *part)
     }
 
     qCDebug(KONQUEROR_LOG) << "New current view" << newView;
+    if (oldView) {
+        oldView->resetIdleTime();
+    }
+    if (newView) {
+        newView->resetIdleTime();
+    }
     m_currentView = newView;
+    // The active tab is part of the session
+    KonqSessionManager::self()->markWindowDirty(this);
     if (newView) {
         m_paShowStatusBar->setChecked(newView->frame()->statusbar()->isVisible());
     }
@@ -1935,6 +2006,10 @@ void KonqMainWindow::slotPartActivated(KParts::Part *part)
 
     m_paShowDeveloperTools->setEnabled(m_currentView && m_currentView->isWebEngineView());
 
+    // Until the window is shown, the part is merged without its plugins, see initPartPlugins()
+    if (isVisible()) {
+        KonqViewFactory::loadPlugins(m_currentView->part());
+    }
     createGUI(part);
 
     // View-dependent GUI
@@ -2077,6 +2152,7 @@ void KonqMainWindow::viewCountChanged()
     // This is called (by the view manager) when the number of views changes.
     linkableViewCountChanged();
     viewsChanged();
+    KonqSessionManager::self()->markWindowDirty(this);
 }
 
 void KonqMainWindow::viewsChanged()
@@ -2364,6 +2440,47 @@ void KonqMainWindow::openMultiURL(const QList<QUrl> &url)
     }
 }
 
+// The type of a URL opened in a hibernated tab, or an empty string if
+// UrlLoader has to see it first. @p guessed tells whether the type is only
+// assumed, and has to be checked when the tab wakes up
+static QString hibernatedTabMimeType(const QUrl &url, const QString &mimeType, bool *guessed)
+{
+    QString type = mimeType;
+    *guessed = false;
+    if (type.isEmpty()) {
+        if (url.isLocalFile()) {
+            type = KonqMimeTypeCache::self()->mimeTypeForLocalFile(url.toLocalFile());
+        } else {
+            if (url.scheme().startsWith(QLatin1String("http"))) {
+                type = QStringLiteral("text/html"); // as UrlLoader assumes
+            } else {
+                type = KonqMimeTypeCache::self()->guess(url);
+            }
+            *guessed = true;
+        }
+    }
+    if (type.isEmpty() || !KonqFMSettings::settings()->shouldEmbed(type) || UrlLoader::isExecutable(type)
+        || type == QLatin1String("application/x-desktop") || !KProtocolManager::protocolForArchiveMimetype(type).isEmpty()) {
+        return QString();
+    }
+    return type;
+}
+
+void KonqMainWindow::openHibernatedTabs(const QList<QUrl> &urls, const KonqOpenURLRequest &req)
+{
+    for (const QUrl &url : urls) {
+        bool guessed = false;
+        const QString mimeType = req.tempFile ? QString() : hibernatedTabMimeType(url, req.args.mimeType(), &guessed);
+        if (!mimeType.isEmpty() && m_pViewManager->addHibernatedTab(url, mimeType, false, guessed)) {
+            continue;
+        }
+        KonqOpenURLRequest tabReq(req);
+        tabReq.browserArgs.setNewTab(true);
+        tabReq.newTabInFront = false;
+        openUrl(nullptr, url, req.args.mimeType(), tabReq);
+    }
+}
+
 void KonqMainWindow::slotRemoveView()
 {
     if (!m_currentView) {
@@ -2593,7 +2710,7 @@ void KonqMainWindow::slotUpAboutToShow()
     QUrl u(QUrl::fromUserInput(m_currentView->locationBarURL()));
     u = KIO::upUrl(u);
     while (!u.path().isEmpty()) {
-        QAction *action = new QAction(QIcon::fromTheme(KonqPixmapProvider::self()->iconNameFor(u)),
+        QAction *action = new QAction(KonqPixmapProvider::self()->iconForUrl(u),
                                       u.toDisplayString(QUrl::PreferLocalFile),
                                       popup);
         action->setData(u);
@@ -3143,12 +3260,18 @@ void KonqMainWindow::slotClearLocationBar()
 
 void KonqMainWindow::slotForceSaveMainWindowSettings()
 {
+    slotMainWindowSettingsChanged();
     if (autoSaveSettings()) {   // don't do it on e.g. JS window.open windows with no toolbars!
         KConfigGroup config = KSharedConfig::openConfig()->group("MainWindow");
         saveMainWindowSettings(config);
     }
 }
 
+void KonqMainWindow::slotMainWindowSettingsChanged()
+{
+    KonqSessionManager::self()->markWindowDirty(this);
+}
+
 void KonqMainWindow::slotShowMenuBar()
 {
     menuBar()->setVisible(!menuBar()->isVisible());
@@ -4581,8 +4704,13 @@ void KonqMainWindow::reparseConfiguration()
     qCDebug(KONQUEROR_LOG);
 
     KonqSettings::self()->load();
+    // The file associations may have been changed too
+    KonqFactory::clearOffersCache();
     m_pViewManager->applyConfiguration();
     KonqMouseEventFilter::self()->reparseConfiguration();
+    KonqHibernator::self()->reparseConfiguration();
+    KonqMemoryPressureHandler::self()->reparseConfiguration();
+    KonqPartPool::self()->reparseConfiguration();
 
     MapViews::ConstIterator it = m_mapViews.constBegin();
     MapViews::ConstIterator end = m_mapViews.constEnd();
@@ -5380,6 +5508,10 @@ bool KonqMainWindow::refuseExecutingKonqueror(const QString &mimeType)
 
 bool KonqMainWindow::event(QEvent *e)
 {
+    if (e->type() == QEvent::Resize || e->type() == QEvent::WindowStateChange) {
+        KonqSessionManager::self()->markWindowDirty(this);
+    }
+
     if (e->type() == QEvent::StatusTip) {
         if (m_currentView && m_currentView->frame()->statusbar()) {
             KonqFrameStatusBar *statusBar = m_currentView->frame()->statusbar();
@@ -134,12 +134,25 @@ public:
 
     void openMultiURL(const QList<QUrl> &url);
 
+    /**
+     * Opens @p urls in tabs behind the current one. They are only loaded when
+     * activated, unless @p req asks for a temporary file to be deleted, or
+     * the URL needs more than a part to be shown (e.g. an executable).
+     */
+    void openHibernatedTabs(const QList<QUrl> &urls, const KonqOpenURLRequest &req);
+
     /// Returns the view manager for this window.
     KonqViewManager *viewManager() const
     {
         return m_pViewManager;
     }
 
+    /// Returns the undo manager for this window, which keeps its closed tabs.
+    KonqUndoManager *undoManager() const
+    {
+        return m_pUndoManager;
+    }
+
     /// KXMLGUIBuilder methods, reimplemented for delayed bookmark-toolbar initialization
     QWidget *createContainer(QWidget *parent, int index, const QDomElement &element, QAction *&containerAction) override;
     void removeContainer(QWidget *container, QWidget *parent, QDomElement &element, QAction *containerAction) override;
@@ -432,6 +445,7 @@ private Q_SLOTS:
     void slotReconfigure();
 
     void slotForceSaveMainWindowSettings();
+    void slotMainWindowSettingsChanged();
 
     void slotOpenWith();
 
@@ -476,6 +490,8 @@ private Q_SLOTS:
 
     void slotIconsChanged();
 
+    void slotMimeTypeVerified(const QUrl &url, const QString &guessedMimeType, const QString &mimeType);
+
     bool event(QEvent *) override;
 
     void slotMoveTabLeft();
@@ -541,6 +557,8 @@ private Q_SLOTS:
 
     void initBookmarkBar();
 
+    void initPartPlugins();
+
     void showPageSecurity();
     
     void toggleCompleteFullScreen(bool on);
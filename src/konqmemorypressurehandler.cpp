@@ -0,0 +1,335 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqmemorypressurehandler.h"
+#include "konqfactory.h"
+#include "konqhibernator.h"
+#include "konqmainwindow.h"
+#include "konqmimetypecache.h"
+#include "konqpartpool.h"
+#include "konqpixmapprovider.h"
+#include "konqundomanager.h"
+#include "konqview.h"
+#include "konqsettingsxt.h"
+#include "konqdebug.h"
+
+#include <KParts/ReadOnlyPart>
+
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+class KonqMemoryPressureHandlerSingleton
+{
+public:
+    KonqMemoryPressureHandler self;
+};
+
+Q_GLOBAL_STATIC(KonqMemoryPressureHandlerSingleton, globalMemoryPressureHandler)
+
+KonqMemoryPressureHandler *KonqMemoryPressureHandler::self()
+{
+    return &globalMemoryPressureHandler->self;
+}
+
+// Without a report for this long, the pressure is over
+static const int s_calmPeriod = 60 * 1000;
+// Views not shown for this long are the first ones to hibernate
+static const qint64 s_idleTime = 5 * 60 * 1000;
+// Percentages of the last ten seconds during which tasks were stalled
+static const double s_moderateStall = 10.0;
+static const double s_criticalStall = 5.0;
+
+KonqMemoryPressureHandler::KonqMemoryPressureHandler()
+    : QObject(nullptr)
+    , m_pressureStallFd(-1)
+    , m_pressureStallNotifier(nullptr)
+    , m_cgroupWatcher(nullptr)
+    , m_nextStep(ReleasePartPool)
+{
+    reparseConfiguration();
+}
+
+KonqMemoryPressureHandler::~KonqMemoryPressureHandler()
+{
+#ifdef Q_OS_LINUX
+    if (m_pressureStallFd >= 0) {
+        ::close(m_pressureStallFd);
+    }
+#endif
+}
+
+void KonqMemoryPressureHandler::reparseConfiguration()
+{
+    stopMonitoring();
+    if (KonqSettings::reactToMemoryPressure() && !monitorPressureStall()) {
+        monitorCgroupEvents();
+    }
+}
+
+bool KonqMemoryPressureHandler::monitorPressureStall(const QString &path)
+{
+#ifdef Q_OS_LINUX
+    const QByteArray fileName = QFile::encodeName(path.isEmpty() ? QStringLiteral("/proc/pressure/memory") : path);
+    const int fd = ::open(fileName.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    // Some tasks stalled for 150 ms within 2 s, the shortest window allowed
+    // to unprivileged processes. The kernel reports it at most once per window.
+    static const char trigger[] = "some 150000 2000000";
+    if (::write(fd, trigger, sizeof(trigger)) < 0) {
+        qCDebug(KONQUEROR_LOG) << "Can't set a memory pressure trigger on" << fileName;
+        ::close(fd);
+        return false;
+    }
+
+    delete m_pressureStallNotifier;
+    if (m_pressureStallFd >= 0) {
+        ::close(m_pressureStallFd);
+    }
+    m_pressureStallFd = fd;
+    m_pressureStallNotifier = new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+    connect(m_pressureStallNotifier, &QSocketNotifier::activated, this, &KonqMemoryPressureHandler::slotPressureStall);
+    return true;
+#else
+    Q_UNUSED(path);
+    return false;
+#endif
+}
+
+bool KonqMemoryPressureHandler::monitorCgroupEvents(const QString &path)
+{
+    QString eventsPath = path;
+    if (eventsPath.isEmpty()) {
+        // The cgroup v2 hierarchy is the one with id 0: "0::/user.slice/..."
+        QFile cgroup(QStringLiteral("/proc/self/cgroup"));
+        if (cgroup.open(QIODevice::ReadOnly)) {
+            while (!cgroup.atEnd()) {
+                const QByteArray line = cgroup.readLine().trimmed();
+                if (line.startsWith("0::")) {
+                    eventsPath = QLatin1String("/sys/fs/cgroup") + QFile::decodeName(line.mid(3)) + QLatin1String("/memory.events");
+                }
+            }
+        }
+    }
+    if (eventsPath.isEmpty()) {
+        return false;
+    }
+
+    m_cgroupEventsPath = eventsPath;
+    m_cgroupEvents = readCgroupEvents();
+    if (m_cgroupEvents.isEmpty()) {
+        m_cgroupEventsPath.clear();
+        return false;
+    }
+    if (!m_cgroupWatcher) {
+        m_cgroupWatcher = new QFileSystemWatcher(this);
+        connect(m_cgroupWatcher, &QFileSystemWatcher::fileChanged, this, &KonqMemoryPressureHandler::slotCgroupEventsChanged);
+    }
+    // The kernel notifies the changes of the counters as modifications of the file
+    return m_cgroupWatcher->addPath(eventsPath);
+}
+
+void KonqMemoryPressureHandler::stopMonitoring()
+{
+    delete m_pressureStallNotifier;
+    m_pressureStallNotifier = nullptr;
+#ifdef Q_OS_LINUX
+    if (m_pressureStallFd >= 0) {
+        ::close(m_pressureStallFd);
+        m_pressureStallFd = -1;
+    }
+#endif
+    delete m_cgroupWatcher;
+    m_cgroupWatcher = nullptr;
+    m_cgroupEventsPath.clear();
+    m_cgroupEvents.clear();
+}
+
+KonqMemoryPressureHandler::Level KonqMemoryPressureHandler::levelFromPressureStall(const QByteArray &contents)
+{
+    // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    Level level = NoPressure;
+    const QList<QByteArray> lines = contents.split('\n');
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(' ');
+        if (fields.count() < 2 || !fields.at(1).startsWith("avg10=")) {
+            continue;
+        }
+        const double stall = fields.at(1).mid(6).toDouble();
+        if (fields.at(0) == "full" && stall >= s_criticalStall) {
+            return CriticalPressure;
+        }
+        if (fields.at(0) == "some" && stall >= s_moderateStall) {
+            level = ModeratePressure;
+        }
+    }
+    return level;
+}
+
+void KonqMemoryPressureHandler::slotPressureStall()
+{
+    QByteArray contents;
+#ifdef Q_OS_LINUX
+    char buffer[256];
+    if (::lseek(m_pressureStallFd, 0, SEEK_SET) == 0) {
+        const ssize_t size = ::read(m_pressureStallFd, buffer, sizeof(buffer) - 1);
+        if (size > 0) {
+            contents = QByteArray(buffer, size);
+        }
+    }
+#endif
+    // The trigger fired, so there's some pressure even if the averages don't show it yet
+    pressureReported(qMax(levelFromPressureStall(contents), ModeratePressure));
+}
+
+QHash<QByteArray, qint64> KonqMemoryPressureHandler::readCgroupEvents() const
+{
+    // low 0
+    // high 12
+    // ...
+    QHash<QByteArray, qint64> events;
+    QFile file(m_cgroupEventsPath);
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            const QList<QByteArray> fields = file.readLine().trimmed().split(' ');
+            if (fields.count() == 2) {
+                events.insert(fields.at(0), fields.at(1).toLongLong());
+            }
+        }
+    }
+    return events;
+}
+
+void KonqMemoryPressureHandler::slotCgroupEventsChanged(const QString &path)
+{
+    // Files replaced rather than modified are no longer watched
+    if (!m_cgroupWatcher->files().contains(path)) {
+        m_cgroupWatcher->addPath(path);
+    }
+
+    const QHash<QByteArray, qint64> events = readCgroupEvents();
+    auto grew = [this, &events](const char *name) {
+        return events.value(name) > m_cgroupEvents.value(name);
+    };
+    Level level = NoPressure;
+    // The hard limit was reached, the kernel is reclaiming or killing
+    if (grew("max") || grew("oom") || grew("oom_kill")) {
+        level = CriticalPressure;
+    // The soft limit was exceeded, the kernel is throttling
+    } else if (grew("high")) {
+        level = ModeratePressure;
+    }
+    m_cgroupEvents = events;
+    // Other counters, e.g. "low", say nothing about pressure
+    if (level != NoPressure) {
+        pressureReported(level);
+    }
+}
+
+int KonqMemoryPressureHandler::pressureReported(Level level)
+{
+    if (level == NoPressure) {
+        // The pressure is over
+        m_nextStep = ReleasePartPool;
+        m_lastReport.invalidate();
+        return 0;
+    }
+    if (m_lastReport.isValid() && m_lastReport.elapsed() > s_calmPeriod) {
+        m_nextStep = ReleasePartPool;
+    }
+    m_lastReport.start();
+
+    int taken = 0;
+    if (level == CriticalPressure) {
+        // No time to go one step at a time: all the caches, and some views
+        while (m_nextStep < HibernateIdleViews) {
+            takeStep(m_nextStep);
+            m_nextStep = Step(m_nextStep + 1);
+            ++taken;
+        }
+        // New views may have been opened since the last time
+        takeStep(qMin(m_nextStep, HibernateBackgroundViews));
+        m_nextStep = qMin(Step(m_nextStep + 1), StepCount);
+        ++taken;
+    } else if (m_nextStep < HibernateIdleViews) {
+        // Views are only hibernated under critical pressure
+        takeStep(m_nextStep);
+        m_nextStep = Step(m_nextStep + 1);
+        ++taken;
+    }
+
+#ifdef __GLIBC__
+    // Otherwise the freed memory mostly stays with the process
+    if (taken > 0) {
+        malloc_trim(0);
+    }
+#endif
+    qCDebug(KONQUEROR_LOG) << "Memory pressure" << level << "- took" << taken << "steps, resident memory now" << KonqHibernator::residentMemory();
+    emit memoryReleased(level);
+    return taken;
+}
+
+// Lets the parts drop what they can rebuild, e.g. the decisions of the ad filter
+static void trimPartCaches()
+{
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    if (!windows) {
+        return;
+    }
+    for (KonqMainWindow *window : qAsConst(*windows)) {
+        for (KonqView *view : window->viewMap()) {
+            KParts::ReadOnlyPart *part = view->part();
+            if (part && part->metaObject()->indexOfSlot("trimCaches()") >= 0) {
+                QMetaObject::invokeMethod(part, "trimCaches");
+            }
+        }
+    }
+}
+
+void KonqMemoryPressureHandler::takeStep(Step step)
+{
+    QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList();
+    switch (step) {
+    case ReleasePartPool:
+        KonqPartPool::self()->releaseParts();
+        break;
+    case ClearLookupCaches:
+        KonqMimeTypeCache::self()->clear();
+        KonqFactory::clearOffersCache();
+        trimPartCaches();
+        break;
+    case ClearIconCaches:
+        // The favicons of the urls are saved with the location bar history, only drop what's rendered
+        KonqPixmapProvider::self()->clearIconCaches();
+        break;
+    case TrimClosedTabs:
+        if (windows) {
+            for (KonqMainWindow *window : qAsConst(*windows)) {
+                window->undoManager()->trimClosedTabs(0);
+            }
+        }
+        break;
+    case HibernateIdleViews:
+        KonqHibernator::self()->hibernateViews(s_idleTime);
+        break;
+    case HibernateBackgroundViews:
+        KonqHibernator::self()->hibernateViews(0);
+        break;
+    case StepCount:
+        break;
+    }
+}
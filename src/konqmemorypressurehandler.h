@@ -0,0 +1,135 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQMEMORYPRESSUREHANDLER_H
+#define KONQMEMORYPRESSUREHANDLER_H
+
+#include "konqprivate_export.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+
+/**
+ * Releases memory when the system runs short of it.
+ *
+ * The pressure is reported by the kernel: through a PSI trigger on
+ * /proc/pressure/memory when possible, otherwise through the memory.events
+ * file of the cgroup of the process, whose "high" counter grows when the
+ * cgroup goes over its soft limit and "max" and "oom" ones when it reaches
+ * its hard limit.
+ *
+ * Each report makes Konqueror give up a bit more memory, cheapest to get
+ * back first (see Step): moderate pressure only trims caches and closed
+ * tabs, critical pressure goes on with hibernating background views. When
+ * no pressure has been reported for a while, the next report starts again
+ * from the first step.
+ */
+class KONQ_TESTS_EXPORT KonqMemoryPressureHandler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static KonqMemoryPressureHandler *self();
+
+    enum Level {
+        NoPressure,
+        ModeratePressure,
+        CriticalPressure
+    };
+    Q_ENUM(Level)
+
+    /**
+     * What is released, in order.
+     */
+    enum Step {
+        ReleasePartPool,        ///< The parts kept ready for new views
+        ClearLookupCaches,      ///< The MIME type, part offers and ad filter caches
+        ClearIconCaches,        ///< The rendered icons, not which favicon each URL has
+        TrimClosedTabs,         ///< All the closed tabs but the last one of each window
+        HibernateIdleViews,     ///< The views not shown for a few minutes
+        HibernateBackgroundViews, ///< All the views which aren't shown
+        StepCount
+    };
+
+    /**
+     * Starts or stops listening to the kernel according to the settings.
+     */
+    void reparseConfiguration();
+
+    /**
+     * Listens to the PSI file @p path, /proc/pressure/memory by default.
+     * @return false if no trigger could be set on it
+     */
+    bool monitorPressureStall(const QString &path = QString());
+
+    /**
+     * Listens to the cgroup v2 memory.events file @p path, the one of the
+     * cgroup of the process by default.
+     * @return false if it can't be read
+     */
+    bool monitorCgroupEvents(const QString &path = QString());
+
+    /**
+     * Stops listening to the kernel.
+     */
+    void stopMonitoring();
+
+    /**
+     * Releases memory for a report of @p level pressure, going on from the
+     * step where the previous report stopped. A report of no pressure means
+     * the next one starts from the first step again.
+     * @return the number of steps taken
+     */
+    int pressureReported(Level level);
+
+    /**
+     * Returns the step the next report will start with.
+     */
+    Step nextStep() const
+    {
+        return m_nextStep;
+    }
+
+    /**
+     * Returns the pressure level described by the contents of a PSI file:
+     * critical when some tasks were all stalled for a significant share of
+     * the last ten seconds, moderate when some of them were.
+     */
+    static Level levelFromPressureStall(const QByteArray &contents);
+
+Q_SIGNALS:
+    /**
+     * Emitted after releasing memory for a report of @p level pressure.
+     */
+    void memoryReleased(KonqMemoryPressureHandler::Level level);
+
+private Q_SLOTS:
+    void slotPressureStall();
+    void slotCgroupEventsChanged(const QString &path);
+
+private:
+    KonqMemoryPressureHandler();
+    ~KonqMemoryPressureHandler() override;
+    friend class KonqMemoryPressureHandlerSingleton;
+
+    void takeStep(Step step);
+    QHash<QByteArray, qint64> readCgroupEvents() const;
+
+    int m_pressureStallFd;
+    QSocketNotifier *m_pressureStallNotifier;
+    QFileSystemWatcher *m_cgroupWatcher;
+    QString m_cgroupEventsPath;
+    QHash<QByteArray, qint64> m_cgroupEvents;
+    Step m_nextStep;
+    // Since the last report
+    QElapsedTimer m_lastReport;
+};
+
+#endif // KONQMEMORYPRESSUREHANDLER_H
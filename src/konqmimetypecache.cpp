@@ -0,0 +1,127 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqmimetypecache.h"
+#include "konqdebug.h"
+
+#include <KIO/MimetypeJob>
+
+#include <QFileInfo>
+#include <QMimeDatabase>
+
+class KonqMimeTypeCacheSingleton
+{
+public:
+    KonqMimeTypeCache self;
+};
+
+Q_GLOBAL_STATIC(KonqMimeTypeCacheSingleton, globalMimeTypeCache)
+
+KonqMimeTypeCache *KonqMimeTypeCache::self()
+{
+    return &globalMimeTypeCache->self;
+}
+
+// Local files and URL patterns together
+static const int s_maxEntries = 1000;
+
+KonqMimeTypeCache::KonqMimeTypeCache()
+    : QObject(nullptr)
+{
+    m_entries.setMaxCost(s_maxEntries);
+}
+
+QString KonqMimeTypeCache::urlPattern(const QUrl &url)
+{
+    // Without an extension, or with a query, the path doesn't say anything
+    // about the type: "download?id=1" and "download?id=2" can be anything
+    if (url.hasQuery()) {
+        return QString();
+    }
+    const QString fileName = url.fileName();
+    const int dot = fileName.lastIndexOf(QLatin1Char('.'));
+    if (dot <= 0) {
+        return QString();
+    }
+    const QUrl dir = url.adjusted(QUrl::RemoveFilename | QUrl::RemoveFragment | QUrl::RemoveUserInfo);
+    return dir.toString() + QLatin1Char('*') + fileName.mid(dot).toLower();
+}
+
+QString KonqMimeTypeCache::mimeTypeForLocalFile(const QString &path)
+{
+    const QFileInfo info(path);
+    const QDateTime lastModified = info.lastModified();
+    const qint64 size = info.size();
+    Entry *entry = m_entries.object(path);
+    if (entry && entry->lastModified == lastModified && entry->size == size) {
+        ++m_statistics.hits;
+        return entry->mimeType;
+    }
+
+    ++m_statistics.misses;
+    QMimeDatabase db;
+    const QString mimeType = db.mimeTypeForFile(info).name();
+    // A file without modification time can't be validated
+    if (lastModified.isValid()) {
+        m_entries.insert(path, new Entry{mimeType, lastModified, size});
+    }
+    return mimeType;
+}
+
+QString KonqMimeTypeCache::guess(const QUrl &url)
+{
+    const QString pattern = urlPattern(url);
+    const Entry *entry = pattern.isEmpty() ? nullptr : m_entries.object(pattern);
+    if (!entry) {
+        ++m_statistics.misses;
+        return QString();
+    }
+    ++m_statistics.hits;
+    return entry->mimeType;
+}
+
+void KonqMimeTypeCache::record(const QUrl &url, const QString &mimeType)
+{
+    if (url.isLocalFile() || mimeType.isEmpty() || mimeType == QLatin1String("application/octet-stream")) {
+        return;
+    }
+    const QString pattern = urlPattern(url);
+    if (!pattern.isEmpty()) {
+        m_entries.insert(pattern, new Entry{mimeType, QDateTime(), -1});
+    }
+}
+
+void KonqMimeTypeCache::verify(const QUrl &url, const QString &guessedMimeType)
+{
+    KIO::MimetypeJob *job = KIO::mimetype(url, KIO::HideProgressInfo);
+    connect(job, &KJob::result, this, [this, job, url, guessedMimeType]() {
+        QString mimeType;
+        if (job->error()) {
+            qCDebug(KONQUEROR_LOG) << "Couldn't verify the type of" << url << job->errorString();
+        } else {
+            mimeType = job->mimetype();
+            if (mimeType != guessedMimeType) {
+                qCDebug(KONQUEROR_LOG) << url << "is" << mimeType << "and not" << guessedMimeType;
+                ++m_statistics.corrections;
+                record(url, mimeType);
+            }
+        }
+        Q_EMIT verified(url, guessedMimeType, mimeType);
+    });
+}
+
+void KonqMimeTypeCache::clear()
+{
+    m_entries.clear();
+    m_statistics = Statistics();
+}
+
+KonqMimeTypeCache::Statistics KonqMimeTypeCache::statistics() const
+{
+    Statistics statistics = m_statistics;
+    statistics.entries = m_entries.count();
+    return statistics;
+}
@@ -0,0 +1,97 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQMIMETYPECACHE_H
+#define KONQMIMETYPECACHE_H
+
+#include "konqprivate_export.h"
+
+#include <QCache>
+#include <QDateTime>
+#include <QObject>
+#include <QUrl>
+
+/**
+ * Remembers the MIME types found for URLs, so that UrlLoader can choose a
+ * part right away instead of waiting for a KIO::OpenUrlJob or sniffing the
+ * contents of a local file again.
+ *
+ * Local files are remembered by path, and the type is only reused as long
+ * as the modification time and size of the file don't change. Remote URLs
+ * are remembered by pattern: files with the same extension in the same
+ * directory of the same host are assumed to have the same type, which is
+ * checked with verify() after the URL was opened. URLs without an
+ * extension or with a query are never guessed.
+ *
+ * The number of entries is bounded, the least recently used ones are
+ * dropped first.
+ */
+class KONQ_TESTS_EXPORT KonqMimeTypeCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static KonqMimeTypeCache *self();
+
+    /**
+     * Returns the MIME type of the local file @p path, as
+     * QMimeDatabase::mimeTypeForFile() does, if needed.
+     */
+    QString mimeTypeForLocalFile(const QString &path);
+
+    /**
+     * Returns the MIME type which the remote @p url probably has, or an empty
+     * string if nothing is known about similar URLs.
+     */
+    QString guess(const QUrl &url);
+
+    /**
+     * Remembers that the remote @p url has type @p mimeType.
+     */
+    void record(const QUrl &url, const QString &mimeType);
+
+    /**
+     * Asks the server for the type of @p url, which was opened as
+     * @p guessedMimeType because of guess(). This only transfers the
+     * response headers. The cache is corrected if the guess was wrong, and
+     * verified() is emitted in any case.
+     */
+    void verify(const QUrl &url, const QString &guessedMimeType);
+
+    void clear();
+
+    struct Statistics {
+        int hits = 0;
+        int misses = 0;
+        int corrections = 0;
+        int entries = 0;
+    };
+    Statistics statistics() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the type of @p url was checked by verify(). @p mimeType
+     * is empty if it couldn't be determined.
+     */
+    void verified(const QUrl &url, const QString &guessedMimeType, const QString &mimeType);
+
+private:
+    KonqMimeTypeCache();
+    friend class KonqMimeTypeCacheSingleton;
+
+    static QString urlPattern(const QUrl &url);
+
+    struct Entry {
+        QString mimeType;
+        // Only for local files
+        QDateTime lastModified;
+        qint64 size;
+    };
+    QCache<QString, Entry> m_entries;
+    Statistics m_statistics;
+};
+
+#endif // KONQMIMETYPECACHE_H
@@ -0,0 +1,152 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqpartpool.h"
+#include "konqhibernator.h"
+#include "konqmainwindow.h"
+#include "konqview.h"
+#include "konqsettingsxt.h"
+#include "konqdebug.h"
+
+#include <KParts/ReadOnlyPart>
+
+#include <QCoreApplication>
+#include <QWidget>
+
+class KonqPartPoolSingleton
+{
+public:
+    KonqPartPool self;
+};
+
+Q_GLOBAL_STATIC(KonqPartPoolSingleton, globalPartPool)
+
+KonqPartPool *KonqPartPool::self()
+{
+    return &globalPartPool->self;
+}
+
+// How long nothing must happen before a part is created for the pool
+static const int s_refillDelay = 2000;
+
+KonqPartPool::KonqPartPool()
+    : QObject(nullptr)
+    , m_factoryResolved(false)
+{
+    m_refillTimer.setSingleShot(true);
+    m_refillTimer.setInterval(s_refillDelay);
+    connect(&m_refillTimer, &QTimer::timeout, this, &KonqPartPool::slotRefillOne);
+    // The parts can't outlive the application
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            releaseParts();
+        });
+    }
+}
+
+KonqPartPool::~KonqPartPool()
+{
+    // Normally empty already, see releaseParts()
+    qDeleteAll(m_parts);
+}
+
+KParts::ReadOnlyPart *KonqPartPool::take(const KonqViewFactory &factory, QWidget *parentWidget)
+{
+    if (m_parts.isEmpty() || factory.libName() != m_factory.libName() || factory.args() != m_factory.args()) {
+        return nullptr;
+    }
+    KParts::ReadOnlyPart *part = m_parts.takeFirst();
+    part->widget()->setParent(parentWidget);
+    scheduleRefill();
+    return part;
+}
+
+void KonqPartPool::scheduleRefill()
+{
+    if (m_parts.count() < KonqSettings::pooledBrowserParts()) {
+        m_refillTimer.start(); // postponed again if already scheduled
+    }
+}
+
+bool KonqPartPool::canGrow() const
+{
+    if (m_parts.count() >= KonqSettings::pooledBrowserParts() || !KonqMainWindow::mainWindowList()) {
+        return false;
+    }
+    // Measured like hibernation does, the renderers of the views included
+    const qint64 memoryBudget = qint64(KonqSettings::hibernationMemoryBudget()) * 1024 * 1024;
+    return memoryBudget <= 0 || KonqHibernator::self()->viewsMemory() < memoryBudget;
+}
+
+bool KonqPartPool::addPart()
+{
+    if (!m_factoryResolved) {
+        // Whatever would show a web page in a new view
+        KonqFactory konqFactory;
+        m_factory = konqFactory.createView(QStringLiteral("text/html"), QString(), nullptr, nullptr, nullptr, true);
+        m_factoryResolved = true;
+    }
+    if (m_factory.isNull()) {
+        return false;
+    }
+    // No parent widget yet: it's given one by take()
+    KParts::ReadOnlyPart *part = m_factory.createPart(nullptr, nullptr);
+    if (!part || !part->widget()) {
+        delete part;
+        return false;
+    }
+    m_parts.append(part);
+    return true;
+}
+
+void KonqPartPool::refill()
+{
+    m_refillTimer.stop();
+    while (canGrow() && addPart()) {
+    }
+}
+
+void KonqPartPool::slotRefillOne()
+{
+    // Wait until no view is loading anything
+    if (QList<KonqMainWindow *> *windows = KonqMainWindow::mainWindowList()) {
+        for (KonqMainWindow *window : qAsConst(*windows)) {
+            for (KonqView *view : window->viewMap()) {
+                if (view->isLoading()) {
+                    m_refillTimer.start();
+                    return;
+                }
+            }
+        }
+    }
+
+    // One part at a time, not to block the user for long
+    if (canGrow() && addPart() && canGrow()) {
+        m_refillTimer.start();
+    }
+}
+
+int KonqPartPool::releaseParts(int count)
+{
+    m_refillTimer.stop();
+    int released = 0;
+    while (!m_parts.isEmpty() && (count < 0 || released < count)) {
+        delete m_parts.takeLast();
+        ++released;
+    }
+    if (released > 0) {
+        qCDebug(KONQUEROR_LOG) << "Released" << released << "pooled parts";
+    }
+    return released;
+}
+
+void KonqPartPool::reparseConfiguration()
+{
+    releaseParts();
+    m_factoryResolved = false;
+    m_factory = KonqViewFactory();
+    scheduleRefill();
+}
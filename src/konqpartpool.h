@@ -0,0 +1,93 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQPARTPOOL_H
+#define KONQPARTPOOL_H
+
+#include "konqprivate_export.h"
+#include "konqfactory.h"
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+namespace KParts
+{
+class ReadOnlyPart;
+}
+
+/**
+ * A few idle instances of the preferred browser part (the one showing
+ * text/html), created in advance so that new views, e.g. new tabs, don't
+ * have to wait for a part to be constructed.
+ *
+ * KonqViewFactory::create() takes a part from the pool whenever it's asked
+ * for one the pool has. Taken parts are replaced when the application is
+ * idle. The pool isn't refilled while the resident memory is over the
+ * hibernation memory budget, and releaseParts() empties it, e.g. under
+ * memory pressure.
+ */
+class KONQ_TESTS_EXPORT KonqPartPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    static KonqPartPool *self();
+
+    /**
+     * Returns an idle part created by @p factory, with its widget moved to
+     * @p parentWidget, or nullptr if the pool has none.
+     */
+    KParts::ReadOnlyPart *take(const KonqViewFactory &factory, QWidget *parentWidget);
+
+    /**
+     * The number of idle parts in the pool.
+     */
+    int count() const
+    {
+        return m_parts.count();
+    }
+
+    /**
+     * Refills the pool, one part at a time, when the application is idle.
+     */
+    void scheduleRefill();
+
+    /**
+     * Creates the missing parts right away.
+     */
+    void refill();
+
+    /**
+     * Deletes up to @p count idle parts (all of them if negative).
+     * @return the number of parts deleted
+     */
+    int releaseParts(int count = -1);
+
+    /**
+     * Applies the pool size setting. The preferred browser part is looked
+     * up again, since the file associations may have changed too.
+     */
+    void reparseConfiguration();
+
+private Q_SLOTS:
+    void slotRefillOne();
+
+private:
+    KonqPartPool();
+    ~KonqPartPool() override;
+    friend class KonqPartPoolSingleton;
+
+    bool canGrow() const;
+    bool addPart();
+
+    QList<KParts::ReadOnlyPart *> m_parts;
+    KonqViewFactory m_factory;
+    bool m_factoryResolved;
+    QTimer m_refillTimer;
+};
+
+#endif // KONQPARTPOOL_H
@@ -29,9 +29,18 @@ KonqPixmapProvider *KonqPixmapProvider::self()
     return &globalPixmapProvider->self;
 }
 
+// Default for the number of urls whose icon name is cached
+static const int s_defaultMaxCount = 10000;
+
+// Maximum number of cached icons, and size in KiB of the cached pixmaps
+static const int s_iconCacheSize = 1000;
+static const int s_pixmapCacheSize = 4096;
+
 KonqPixmapProvider::KonqPixmapProvider()
-    : QObject()
+    : QObject(), m_maxCount(s_defaultMaxCount),
+      m_iconCache(s_iconCacheSize), m_pixmapCache(s_pixmapCacheSize)
 {
+    connect(KIconLoader::global(), &KIconLoader::iconLoaderSettingsChanged, this, &KonqPixmapProvider::clearIconCaches);
 }
 
 KonqPixmapProvider::~KonqPixmapProvider()
@@ -44,51 +53,138 @@ void KonqPixmapProvider::downloadHostIcon(const QUrl &hostUrl)
     if (!hostUrl.scheme().startsWith(QLatin1String("http"))) {
         return;
     }
+    // Opening a bookmark menu or a session asks for the icon of the same
+    // hosts many times
+    const QString requestKey = hostUrl.host();
+    if (m_pendingRequests.contains(requestKey)) {
+        ++m_statistics.redundantRequestsAvoided;
+        return;
+    }
+    m_pendingRequests.insert(requestKey);
+
     KIO::FavIconRequestJob *job = new KIO::FavIconRequestJob(hostUrl);
-    connect(job, &KIO::FavIconRequestJob::result, this, [job, this](KJob *) {
-        bool modified = false;
-        const QUrl _hostUrl = job->hostUrl();
-        QMap<QUrl, QString>::iterator itEnd = iconMap.end();
-        for (QMap<QUrl, QString>::iterator it = iconMap.begin(); it != itEnd; ++it) {
-            const QUrl url(it.key());
-            if (url.host() == _hostUrl.host()) {
-                // For host default-icons still query the favicon manager to get
-                // the correct icon for pages that have an own one.
-                const QString icon = KIO::favIconForUrl(url);
-                if (!icon.isEmpty() && *it != icon) {
-                    *it = icon;
-                    modified = true;
-                }
-            }
-        }
-        if (modified) {
-            emit changed();
-        }
+    connect(job, &KIO::FavIconRequestJob::result, this, [job, requestKey, this](KJob *) {
+        m_pendingRequests.remove(requestKey);
+        updateHostIcons(job->hostUrl());
     });
 }
 
+void KonqPixmapProvider::updateHostIcons(const QUrl &hostUrl)
+{
+    bool modified = false;
+    const QSet<QUrl> urls = m_urlsByHost.value(hostUrl.host());
+    for (const QUrl &url : urls) {
+        // For host default-icons still query the favicon manager to get
+        // the correct icon for pages that have an own one.
+        const QString icon = KIO::favIconForUrl(url);
+        QString &cachedIcon = m_iconMap[url].icon;
+        if (!icon.isEmpty() && cachedIcon != icon) {
+            cachedIcon = icon;
+            modified = true;
+        }
+    }
+    // The favicon file may have been replaced
+    removeCachedIcons(KIO::favIconForUrl(hostUrl));
+    if (modified) {
+        emit changed();
+    }
+}
+
 void KonqPixmapProvider::setIconForUrl(const QUrl &hostUrl, const QUrl &iconUrl)
 {
+    const QString requestKey = hostUrl.toString(QUrl::RemoveQuery | QUrl::RemoveFragment) + QLatin1Char(' ') + iconUrl.toString();
+    if (m_pendingRequests.contains(requestKey)) {
+        ++m_statistics.redundantRequestsAvoided;
+        return;
+    }
+    m_pendingRequests.insert(requestKey);
+
     KIO::FavIconRequestJob *job = new KIO::FavIconRequestJob(hostUrl);
     job->setIconUrl(iconUrl);
-    connect(job, &KIO::FavIconRequestJob::result, this, [job, this](KJob *) {
-        bool modified = false;
-        const QUrl _hostUrl = job->hostUrl();
-        QMap<QUrl, QString>::iterator itEnd = iconMap.end();
-        for (QMap<QUrl, QString>::iterator it = iconMap.begin(); it != itEnd; ++it) {
-            const QUrl url(it.key());
-            if (url.host() == _hostUrl.host() && url.path() == _hostUrl.path()) {
-                const QString icon = job->iconFile();
-                if (!icon.isEmpty() && *it != icon) {
-                    *it = icon;
-                    modified = true;
-                }
+    connect(job, &KIO::FavIconRequestJob::result, this, [job, requestKey, this](KJob *) {
+        m_pendingRequests.remove(requestKey);
+        updateIconForUrl(job->hostUrl(), job->iconFile());
+    });
+}
+
+void KonqPixmapProvider::updateIconForUrl(const QUrl &hostUrl, const QString &icon)
+{
+    if (icon.isEmpty()) {
+        return;
+    }
+    removeCachedIcons(icon);
+    bool modified = false;
+    const QSet<QUrl> urls = m_urlsByHost.value(hostUrl.host());
+    for (const QUrl &url : urls) {
+        if (url.path() == hostUrl.path()) {
+            QString &cachedIcon = m_iconMap[url].icon;
+            if (cachedIcon != icon) {
+                cachedIcon = icon;
+                modified = true;
             }
         }
-        if (modified) {
-            emit changed();
+    }
+    if (modified) {
+        emit changed();
+    }
+}
+
+QString KonqPixmapProvider::cachedIconName(const QUrl &url)
+{
+    const QHash<QUrl, CacheEntry>::const_iterator it = m_iconMap.constFind(url);
+    if (it == m_iconMap.constEnd()) {
+        return QString();
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->lruPosition);
+    return it->icon;
+}
+
+void KonqPixmapProvider::insert(const QUrl &url, const QString &icon)
+{
+    QHash<QUrl, CacheEntry>::iterator it = m_iconMap.find(url);
+    if (it != m_iconMap.end()) {
+        it->icon = icon;
+        m_lru.splice(m_lru.begin(), m_lru, it->lruPosition);
+        return;
+    }
+
+    m_lru.push_front(url);
+    m_iconMap.insert(url, CacheEntry{icon, m_lru.begin()});
+    m_urlsByHost[url.host()].insert(url);
+    evict();
+}
+
+void KonqPixmapProvider::evict()
+{
+    while (m_iconMap.count() > m_maxCount) {
+        const QUrl url = m_lru.back();
+        m_lru.pop_back();
+        m_iconMap.remove(url);
+
+        const QHash<QString, QSet<QUrl>>::iterator hostIt = m_urlsByHost.find(url.host());
+        if (hostIt != m_urlsByHost.end()) {
+            hostIt->remove(url);
+            if (hostIt->isEmpty()) {
+                m_urlsByHost.erase(hostIt);
+            }
         }
-    });
+    }
+}
+
+void KonqPixmapProvider::setMaxCount(int count)
+{
+    m_maxCount = qMax(1, count);
+    evict();
+}
+
+int KonqPixmapProvider::maxCount() const
+{
+    return m_maxCount;
+}
+
+int KonqPixmapProvider::count() const
+{
+    return m_iconMap.count();
 }
 
 // at first, tries to find the iconname in the cache
@@ -97,13 +193,9 @@ void KonqPixmapProvider::setIconForUrl(const QUrl &hostUrl, const QUrl &iconUrl)
 // finally, inserts the url/icon pair into the cache
 QString KonqPixmapProvider::iconNameFor(const QUrl &url)
 {
-    QMap<QUrl, QString>::iterator it = iconMap.find(url);
-    QString icon;
-    if (it != iconMap.end()) {
-        icon = it.value();
-        if (!icon.isEmpty()) {
-            return icon;
-        }
+    QString icon = cachedIconName(url);
+    if (!icon.isEmpty()) {
+        return icon;
     }
 
     if (url.url().isEmpty()) {
@@ -118,7 +210,7 @@ QString KonqPixmapProvider::iconNameFor(const QUrl &url)
     }
 
     // cache the icon found for url
-    iconMap.insert(url, icon);
+    insert(url, icon);
 
     return icon;
 }
@@ -130,7 +222,7 @@ QPixmap KonqPixmapProvider::pixmapFor(const QString &url, int size)
 
 void KonqPixmapProvider::load(KConfigGroup &kc, const QString &key)
 {
-    iconMap.clear();
+    clear();
     const QStringList list = kc.readPathEntry(key, QStringList());
     QStringList::const_iterator it = list.begin();
     QStringList::const_iterator itEnd = list.end();
@@ -140,7 +232,7 @@ void KonqPixmapProvider::load(KConfigGroup &kc, const QString &key)
             break;
         }
         const QString icon(*it);
-        iconMap.insert(QUrl::fromUserInput(url), icon);
+        insert(QUrl::fromUserInput(url), icon);
         ++it;
     }
 }
@@ -151,12 +243,13 @@ void KonqPixmapProvider::save(KConfigGroup &kc, const QString &key,
                               const QStringList &items)
 {
     QStringList list;
-    QStringList::const_iterator itEnd = items.end();
-    for (QStringList::const_iterator it = items.begin(); it != itEnd; ++it) {
-        QMap<QUrl, QString>::const_iterator mit = iconMap.constFind(QUrl::fromUserInput(*it));
-        if (mit != iconMap.constEnd()) {
+    list.reserve(2 * items.count());
+    // Save in reverse order, so that loading restores the order of use
+    for (auto it = items.crbegin(); it != items.crend(); ++it) {
+        const QHash<QUrl, CacheEntry>::const_iterator mit = m_iconMap.constFind(QUrl::fromUserInput(*it));
+        if (mit != m_iconMap.constEnd()) {
             list.append(mit.key().url());
-            list.append(mit.value());
+            list.append(mit->icon);
         }
     }
     kc.writePathEntry(key, list);
@@ -164,7 +257,32 @@ void KonqPixmapProvider::save(KConfigGroup &kc, const QString &key,
 
 void KonqPixmapProvider::clear()
 {
-    iconMap.clear();
+    m_iconMap.clear();
+    m_lru.clear();
+    m_urlsByHost.clear();
+    clearIconCaches();
+}
+
+void KonqPixmapProvider::clearIconCaches()
+{
+    m_iconCache.clear();
+    m_pixmapCache.clear();
+}
+
+void KonqPixmapProvider::removeCachedIcons(const QString &icon)
+{
+    m_iconCache.remove(icon);
+    const QList<QPair<QString, int>> keys = m_pixmapCache.keys();
+    for (const QPair<QString, int> &key : keys) {
+        if (key.first == icon) {
+            m_pixmapCache.remove(key);
+        }
+    }
+}
+
+KonqPixmapProvider::Statistics KonqPixmapProvider::statistics() const
+{
+    return m_statistics;
 }
 
 QPixmap KonqPixmapProvider::loadIcon(const QString &icon, int size)
@@ -172,16 +290,36 @@ QPixmap KonqPixmapProvider::loadIcon(const QString &icon, int size)
     if (size == 0) {
         size = KIconLoader::SizeSmall;
     }
-    return QIcon::fromTheme(icon).pixmap(size);
+    const QPair<QString, int> key(icon, size);
+    if (const QPixmap *pixmap = m_pixmapCache.object(key)) {
+        ++m_statistics.cacheHits;
+        return *pixmap;
+    }
+    ++m_statistics.cacheMisses;
+    const QPixmap pixmap = loadIcon(icon).pixmap(size);
+    const int cost = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    m_pixmapCache.insert(key, new QPixmap(pixmap), cost);
+    return pixmap;
+}
+
+QIcon KonqPixmapProvider::loadIcon(const QString &icon)
+{
+    if (const QIcon *cached = m_iconCache.object(icon)) {
+        ++m_statistics.cacheHits;
+        return *cached;
+    }
+    ++m_statistics.cacheMisses;
+    const QIcon result = QIcon::fromTheme(icon);
+    m_iconCache.insert(icon, new QIcon(result));
+    return result;
 }
 
 QIcon KonqPixmapProvider::iconForUrl(const QUrl &url)
 {
-    return QIcon::fromTheme(iconNameFor(url));
+    return loadIcon(iconNameFor(url));
 }
 
 QIcon KonqPixmapProvider::iconForUrl(const QString &url_str)
 {
     return iconForUrl(QUrl::fromUserInput(url_str));
 }
-
@@ -9,10 +9,15 @@
 
 #include "konqprivate_export.h"
 
-#include <QMap>
+#include <QCache>
+#include <QHash>
+#include <QIcon>
 #include <QPixmap>
+#include <QSet>
 #include <QUrl>
 
+#include <list>
+
 class KConfigGroup;
 class KConfig;
 
@@ -53,6 +58,12 @@ public:
      */
     void clear();
 
+    /**
+     * Forgets the icons and pixmaps rendered so far, but not the icon names
+     * of the urls: they are rendered again when needed.
+     */
+    void clearIconCaches();
+
     /**
      * Looks up an iconname for @p url. Uses a cache for the iconname of url.
      */
@@ -60,16 +71,82 @@ public:
     QIcon iconForUrl(const QUrl &url);
     QIcon iconForUrl(const QString &url_str);
 
+    /**
+     * Sets the maximum number of urls whose icon name is cached. When the
+     * cache is full, the least recently used urls are forgotten.
+     */
+    void setMaxCount(int count);
+    int maxCount() const;
+    /**
+     * @returns the number of urls whose icon name is cached
+     */
+    int count() const;
+
+    /**
+     * Statistics about the icon and pixmap caches and the favicon requests
+     */
+    struct Statistics {
+        int cacheHits = 0;
+        int cacheMisses = 0;
+        int redundantRequestsAvoided = 0;
+    };
+    Statistics statistics() const;
+
+    // Public for unit tests
+    /**
+     * Updates the icons of all cached urls of the host of @p hostUrl, after
+     * its default favicon was downloaded.
+     */
+    void updateHostIcons(const QUrl &hostUrl);
+    /**
+     * Sets @p icon for all cached urls matching @p hostUrl (host and path),
+     * after a custom favicon was downloaded.
+     */
+    void updateIconForUrl(const QUrl &hostUrl, const QString &icon);
+
 Q_SIGNALS:
     void changed();
 
 private:
     QPixmap loadIcon(const QString &icon, int size);
+    QIcon loadIcon(const QString &icon);
+    /**
+     * Forgets the icons and pixmaps rendered for @p icon, e.g. because a
+     * new favicon was downloaded into the same file.
+     */
+    void removeCachedIcons(const QString &icon);
 
     KonqPixmapProvider();
     friend class KonqPixmapProviderSingleton;
 
-    QMap<QUrl, QString> iconMap;
+    /**
+     * @returns the cached icon name of @p url, marking it as recently used,
+     * or a null string if @p url isn't cached
+     */
+    QString cachedIconName(const QUrl &url);
+    void insert(const QUrl &url, const QString &icon);
+    void evict();
+
+    struct CacheEntry {
+        QString icon;
+        std::list<QUrl>::iterator lruPosition;
+    };
+
+    QHash<QUrl, CacheEntry> m_iconMap;
+    // The urls of m_iconMap, most recently used first
+    std::list<QUrl> m_lru;
+    // The urls of m_iconMap by host, so favicon updates only visit the
+    // urls of the host they are for
+    QHash<QString, QSet<QUrl>> m_urlsByHost;
+    int m_maxCount;
+
+    // QIcon::fromTheme() looks the name up in the icon theme each time, and
+    // menus with many entries ask for the same few icons over and over.
+    QCache<QString, QIcon> m_iconCache;
+    QCache<QPair<QString, int>, QPixmap> m_pixmapCache; // cost in KiB
+    // The favicon requests which are running, to start each one only once
+    QSet<QString> m_pendingRequests;
+    Statistics m_statistics;
 };
 
 #endif // KONQ_PIXMAPPROVIDER_H
@@ -33,6 +33,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTreeWidget>
+#include <QScopedPointer>
 #include <QScrollBar>
 #include <QApplication>
 #include <QDesktopWidget>
@@ -128,8 +129,8 @@ SessionRestoreDialog::SessionRestoreDialog(const QStringList &sessionFilePaths,
     Q_FOREACH (const QString &sessionFile, sessionFilePaths) {
         qCDebug(KONQUEROR_LOG) << sessionFile;
         QTreeWidgetItem *windowItem = nullptr;
-        KConfig config(sessionFile, KConfig::SimpleConfig);
-        const QList<KConfigGroup> groups = windowConfigGroups(config);
+        QScopedPointer<KConfig> config(KonqSessionWriter::openSession(sessionFile));
+        const QList<KConfigGroup> groups = windowConfigGroups(*config);
         Q_FOREACH (const KConfigGroup &group, groups) {
             // To avoid a recursive search, let's do linear search on Foo_CurrentHistoryItem=1
             Q_FOREACH (const QString &key, group.keyList()) {
@@ -346,7 +347,6 @@ KonqSessionManager::KonqSessionManager()
     : m_autosaveDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QLatin1Char('/') + "autosave")
     , m_autosaveEnabled(false) // so that enableAutosave works
     , m_createdOwnedByDir(false)
-    , m_sessionConfig(nullptr)
 {
     // Initialize dbus interfaces
     new KonqSessionManagerAdaptor(this);
@@ -373,10 +373,10 @@ KonqSessionManager::KonqSessionManager()
 
 KonqSessionManager::~KonqSessionManager()
 {
-    if (m_sessionConfig) {
-        QFile::remove(m_sessionConfig->name());
+    m_writer.waitForFinished();
+    if (!m_sessionFilePath.isEmpty()) {
+        QFile::remove(m_sessionFilePath);
     }
-    delete m_sessionConfig;
 }
 
 // Don't restore preloaded konquerors
@@ -395,10 +395,14 @@ void KonqSessionManager::disableAutosave()
 
     m_autosaveEnabled = false;
     m_autoSaveTimer.stop();
-    if (m_sessionConfig) {
-        QFile::remove(m_sessionConfig->name());
-        delete m_sessionConfig;
-        m_sessionConfig = nullptr;
+    m_autosavedWindows.clear();
+    m_autosavedSnapshot.clear();
+    m_dirtyWindows.clear();
+    if (!m_sessionFilePath.isEmpty()) {
+        // Don't let a pending save recreate the file
+        m_writer.waitForFinished();
+        QFile::remove(m_sessionFilePath);
+        m_sessionFilePath.clear();
     }
 }
 
@@ -412,9 +416,11 @@ void KonqSessionManager::enableAutosave()
     QString filename = QLatin1String("autosave/") + m_baseService;
     const QString filePath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QLatin1Char('/') + filename;
 
-    delete m_sessionConfig;
-    m_sessionConfig = new KConfig(filePath, KConfig::SimpleConfig);
-    //qCDebug(KONQUEROR_LOG) << "config filename:" << m_sessionConfig->name();
+    m_sessionFilePath = filePath;
+    //qCDebug(KONQUEROR_LOG) << "config filename:" << m_sessionFilePath;
+    // Nothing was written to the new file yet
+    m_autosavedWindows.clear();
+    m_autosavedSnapshot.clear();
 
     m_autosaveEnabled = true;
     m_autoSaveTimer.start();
@@ -443,24 +449,71 @@ void KonqSessionManager::autoSaveSession()
         return;
     }
 
+    QList<KonqMainWindow *> windows;
+    if (KonqMainWindow::mainWindowList()) {
+        foreach (KonqMainWindow *window, *KonqMainWindow::mainWindowList()) {
+            if (!window->isPreloaded()) {
+                windows.append(window);
+            }
+        }
+    }
+
+    // A window only needs to be serialized again if it changed, or if it
+    // isn't stored in the same "WindowN" group as last time
+    QList<int> windowsToSave;
+    for (int i = 0; i < windows.count(); ++i) {
+        KonqMainWindow *window = windows.at(i);
+        if (i >= m_autosavedWindows.count() || m_autosavedWindows.at(i) != window || m_dirtyWindows.contains(window)) {
+            windowsToSave.append(i);
+        }
+    }
+    if (windowsToSave.isEmpty() && windows.count() == m_autosavedWindows.count()) {
+        ++m_autosaveStatistics.skippedSaves;
+        return;
+    }
+
     const bool isActive = m_autoSaveTimer.isActive();
     if (isActive) {
         m_autoSaveTimer.stop();
     }
 
-    saveCurrentSessionToFile(m_sessionConfig);
-    m_sessionConfig->sync();
-    m_sessionConfig->markAsClean();
+    // Only the snapshot is taken here, the file is written by m_writer's thread
+    m_autosavedSnapshot.resize(windows.count());
+    foreach (int index, windowsToSave) {
+        KConfig config(QString(), KConfig::SimpleConfig); // in memory
+        KConfigGroup configGroup(&config, "Window");
+        windows.at(index)->saveProperties(configGroup);
+        m_autosavedSnapshot[index] = KonqSessionWriter::windowEntries(configGroup);
+    }
+    m_writer.write(m_sessionFilePath, m_autosavedSnapshot);
+
+    m_autosavedWindows = windows;
+    m_dirtyWindows.clear();
+    ++m_autosaveStatistics.saves;
+    m_autosaveStatistics.windowsSerialized += windowsToSave.count();
 
     // Now that we have saved current session it's safe to remove our owned_by
     // directory
-    deleteOwnedSessions();
+    if (m_createdOwnedByDir) {
+        m_writer.waitForFinished();
+        deleteOwnedSessions();
+    }
 
     if (isActive) {
         m_autoSaveTimer.start();
     }
 }
 
+void KonqSessionManager::markWindowDirty(KonqMainWindow *window)
+{
+    m_dirtyWindows.insert(window);
+}
+
+void KonqSessionManager::waitForAutosave()
+{
+    m_writer.waitForFinished();
+}
+
 void KonqSessionManager::saveCurrentSessions(const QString &path)
 {
     emit saveCurrentSession(path);
@@ -592,8 +645,8 @@ void KonqSessionManager::restoreSession(const QString &sessionFilePath, bool
         return;
     }
 
-    KConfig config(sessionFilePath, KConfig::SimpleConfig);
-    const QList<KConfigGroup> groups = windowConfigGroups(config);
+    QScopedPointer<KConfig> config(KonqSessionWriter::openSession(sessionFilePath));
+    const QList<KConfigGroup> groups = windowConfigGroups(*config);
     Q_FOREACH (const KConfigGroup &configGroup, groups) {
         if (!openTabsInsideCurrentWindow) {
             KonqViewManager::openSavedWindow(configGroup)->show();
@@ -610,8 +663,8 @@ static void removeDiscardedSessions(const QStringList &sessionFiles, const QStri
     }
 
     Q_FOREACH (const QString &sessionFile, sessionFiles) {
-        KConfig config(sessionFile, KConfig::SimpleConfig);
-        QList<KConfigGroup> groups = windowConfigGroups(config);
+        QScopedPointer<KConfig> config(KonqSessionWriter::openSession(sessionFile));
+        QList<KConfigGroup> groups = windowConfigGroups(*config);
         for (int i = 0, count = groups.count(); i < count; ++i) {
             KConfigGroup &group = groups[i];
             const QString rootItem = group.readEntry("RootItem", "empty");
@@ -625,6 +678,10 @@ static void removeDiscardedSessions(const QStringList &sessionFiles, const QStri
             }
             group.writeEntry(viewsKey, views);
         }
+        // Binary sessions were imported in memory, write them back
+        if (KonqSessionWriter::isBinarySession(sessionFile)) {
+            KonqSessionWriter::writeSession(sessionFile, KonqSessionWriter::snapshotFromConfig(*config));
+        }
     }
 }
 
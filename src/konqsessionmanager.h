@@ -12,11 +12,14 @@
 #include <QTimer>
 #include <QStringList>
 #include <QString>
+#include <QSet>
 
 #include <kconfig.h>
 #include <QDialog>
 #include <konqprivate_export.h>
 
+#include "konqsessionwriter.h"
+
 class KonqMainWindow;
 class QDialogButtonBox;
 class QTreeWidget;
@@ -154,6 +157,33 @@ public:
      */
     QString autosaveDirectory() const;
 
+    /**
+     * Marks @p window as changed since the last autosave (a tab was opened,
+     * closed or moved, a view navigated...). autoSaveSession() only serializes
+     * the windows marked this way, and doesn't write anything if none was.
+     */
+    void markWindowDirty(KonqMainWindow *window);
+
+    struct AutosaveStatistics {
+        int saves = 0; ///< autosaves which wrote the session file
+        int skippedSaves = 0; ///< autosaves skipped because nothing changed
+        int windowsSerialized = 0; ///< windows serialized by the autosaves
+    };
+
+    /**
+     * Blocks until the session file written by the last autoSaveSession()
+     * is on disk.
+     */
+    void waitForAutosave();
+
+    /**
+     * Returns counters about the autosaves done so far, for the unit tests.
+     */
+    AutosaveStatistics autosaveStatistics() const
+    {
+        return m_autosaveStatistics;
+    }
+
 public Q_SLOTS:
     /**
      * Ask the user with a dialog if session should be restored
@@ -164,6 +194,7 @@ public Q_SLOTS:
      * Saves current session.
      * This is function is called by the autosave timer, but you can call it too
      * if you want. It won't do anything if m_autosaveEnabled is false.
+     * The file is written asynchronously, see waitForAutosave().
      */
     void autoSaveSession();
 
@@ -205,7 +236,14 @@ private:
     QString m_baseService;
     bool m_autosaveEnabled;
     bool m_createdOwnedByDir;
-    KConfig *m_sessionConfig;
+    QString m_sessionFilePath;
+    KonqSessionWriter m_writer;
+    // The windows saved by the last autosave, in order, their entries, and
+    // the windows which changed since then.
+    QList<KonqMainWindow *> m_autosavedWindows;
+    KonqSessionSnapshot m_autosavedSnapshot;
+    QSet<KonqMainWindow *> m_dirtyWindows;
+    AutosaveStatistics m_autosaveStatistics;
 
 Q_SIGNALS: // DBUS signals
     /**
@@ -0,0 +1,266 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqsessionwriter.h"
+#include "konqdebug.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QDataStream>
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+
+class KonqSessionWriterJob : public QRunnable
+{
+public:
+    explicit KonqSessionWriterJob(KonqSessionWriter *writer)
+        : m_writer(writer)
+    {
+    }
+
+    void run() override
+    {
+        m_writer->writePending();
+    }
+
+private:
+    KonqSessionWriter *m_writer;
+};
+
+KonqSessionWriter::KonqSessionWriter()
+    : m_hasPending(false)
+    , m_jobQueued(false)
+{
+    // A single thread, so that saves are written in the order they were requested
+    m_pool.setMaxThreadCount(1);
+}
+
+KonqSessionWriter::~KonqSessionWriter()
+{
+    waitForFinished();
+}
+
+// Like KConfig does for the names of nested groups, keys of subgroups are
+// prefixed with the path of the subgroup, separated by '\x1d'
+static const char s_groupSeparator = '\x1d';
+
+static void appendEntries(const KConfigGroup &group, const QByteArray &prefix, KonqSessionWindowEntries *entries)
+{
+    const QStringList keys = group.keyList();
+    entries->reserve(entries->count() + keys.count());
+    for (const QString &key : keys) {
+        // Reading the value as a QByteArray gives the raw data, whatever type was written
+        entries->append(qMakePair(prefix + key.toUtf8(), group.readEntry(key, QByteArray())));
+    }
+    // e.g. the "Toolbar mainToolBar" groups written by saveMainWindowSettings()
+    const QStringList groups = group.groupList();
+    for (const QString &name : groups) {
+        appendEntries(group.group(name), prefix + name.toUtf8() + s_groupSeparator, entries);
+    }
+}
+
+KonqSessionWindowEntries KonqSessionWriter::windowEntries(const KConfigGroup &group)
+{
+    KonqSessionWindowEntries entries;
+    appendEntries(group, QByteArray(), &entries);
+    return entries;
+}
+
+void KonqSessionWriter::writeEntries(const KonqSessionWindowEntries &entries, KConfigGroup &group)
+{
+    QByteArray currentPath;
+    KConfigGroup currentGroup = group;
+    for (const QPair<QByteArray, QByteArray> &entry : entries) {
+        const QByteArray &key = entry.first;
+        const int separator = key.lastIndexOf(s_groupSeparator);
+        const QByteArray path = separator < 0 ? QByteArray() : key.left(separator);
+        if (path != currentPath) {
+            currentPath = path;
+            currentGroup = group;
+            if (!path.isEmpty()) {
+                const QList<QByteArray> names = path.split(s_groupSeparator);
+                for (const QByteArray &name : names) {
+                    currentGroup = currentGroup.group(QString::fromUtf8(name));
+                }
+            }
+        }
+        currentGroup.writeEntry(key.constData() + separator + 1, entry.second);
+    }
+}
+
+void KonqSessionWriter::write(const QString &filePath, const KonqSessionSnapshot &snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pendingFilePath = filePath;
+    m_pendingSnapshot = snapshot;
+    m_hasPending = true;
+    if (!m_jobQueued) {
+        m_jobQueued = true;
+        m_pool.start(new KonqSessionWriterJob(this));
+    }
+}
+
+void KonqSessionWriter::waitForFinished()
+{
+    m_pool.waitForDone();
+}
+
+void KonqSessionWriter::writePending()
+{
+    forever {
+        QString filePath;
+        KonqSessionSnapshot snapshot;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!m_hasPending) {
+                m_jobQueued = false;
+                return;
+            }
+            filePath = m_pendingFilePath;
+            snapshot = m_pendingSnapshot;
+            m_pendingSnapshot.clear();
+            m_hasPending = false;
+        }
+        if (!writeSession(filePath, snapshot)) {
+            qCWarning(KONQUEROR_LOG) << "Couldn't save the session to" << filePath;
+        }
+    }
+}
+
+// "KSES"
+static const quint32 s_sessionMagic = 0x4b534553;
+static const quint32 s_sessionVersion = 1;
+
+bool KonqSessionWriter::writeSession(const QString &filePath, const KonqSessionSnapshot &snapshot)
+{
+    // The file is only replaced once the new contents are completely on disk
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (!writeSession(&file, snapshot)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool KonqSessionWriter::writeSession(QIODevice *device, const KonqSessionSnapshot &snapshot)
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << s_sessionMagic << s_sessionVersion << quint32(snapshot.count());
+
+    for (const KonqSessionWindowEntries &entries : snapshot) {
+        stream << quint32(entries.count());
+        QByteArray previousKey;
+        for (const QPair<QByteArray, QByteArray> &entry : entries) {
+            const QByteArray &key = entry.first;
+            const int maxPrefix = qMin(qMin(key.size(), previousKey.size()), 0xffff);
+            int prefix = 0;
+            while (prefix < maxPrefix && key.at(prefix) == previousKey.at(prefix)) {
+                ++prefix;
+            }
+            stream << quint16(prefix) << key.mid(prefix) << entry.second;
+            previousKey = key;
+        }
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool KonqSessionWriter::readSession(const QString &filePath, KonqSessionSnapshot *snapshot)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return readSession(&file, snapshot);
+}
+
+bool KonqSessionWriter::readSession(QIODevice *device, KonqSessionSnapshot *snapshot)
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 magic, version, windowCount;
+    stream >> magic >> version >> windowCount;
+    if (stream.status() != QDataStream::Ok || magic != s_sessionMagic || version != s_sessionVersion) {
+        return false;
+    }
+
+    snapshot->clear();
+    // Don't trust the counts to preallocate, the file might be corrupted
+    for (quint32 i = 0; i < windowCount && stream.status() == QDataStream::Ok; ++i) {
+        KonqSessionWindowEntries entries;
+        quint32 entryCount;
+        stream >> entryCount;
+        QByteArray previousKey;
+        for (quint32 j = 0; j < entryCount && stream.status() == QDataStream::Ok; ++j) {
+            quint16 prefix;
+            QByteArray suffix, value;
+            stream >> prefix >> suffix >> value;
+            if (prefix > previousKey.size()) {
+                return false;
+            }
+            const QByteArray key = previousKey.left(prefix) + suffix;
+            entries.append(qMakePair(key, value));
+            previousKey = key;
+        }
+        snapshot->append(entries);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool KonqSessionWriter::isBinarySession(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    quint32 magic;
+    stream >> magic;
+    return stream.status() == QDataStream::Ok && magic == s_sessionMagic;
+}
+
+KConfig *KonqSessionWriter::openSession(const QString &filePath)
+{
+    if (!isBinarySession(filePath)) {
+        return new KConfig(filePath, KConfig::SimpleConfig);
+    }
+
+    KConfig *config = new KConfig(QString(), KConfig::SimpleConfig); // in memory
+    KonqSessionSnapshot snapshot;
+    if (readSession(filePath, &snapshot)) {
+        snapshotToConfig(snapshot, config);
+    } else {
+        qCWarning(KONQUEROR_LOG) << "Couldn't read the session file" << filePath;
+    }
+    return config;
+}
+
+KonqSessionSnapshot KonqSessionWriter::snapshotFromConfig(const KConfig &config)
+{
+    KonqSessionSnapshot snapshot;
+    const int count = KConfigGroup(&config, "General").readEntry("Number of Windows", 0);
+    snapshot.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        snapshot.append(windowEntries(KConfigGroup(&config, "Window" + QString::number(i))));
+    }
+    return snapshot;
+}
+
+void KonqSessionWriter::snapshotToConfig(const KonqSessionSnapshot &snapshot, KConfig *config)
+{
+    for (int i = 0; i < snapshot.count(); ++i) {
+        KConfigGroup windowGroup(config, "Window" + QString::number(i));
+        writeEntries(snapshot.at(i), windowGroup);
+    }
+    KConfigGroup generalGroup(config, "General");
+    generalGroup.writeEntry("Number of Windows", snapshot.count());
+}
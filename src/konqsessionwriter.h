@@ -0,0 +1,129 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQSESSIONWRITER_H
+#define KONQSESSIONWRITER_H
+
+#include "konqprivate_export.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+class KConfig;
+class KConfigGroup;
+class QIODevice;
+
+/**
+ * The raw (key, value) entries of the config group describing one window,
+ * as written by KonqMainWindow::saveProperties(). Entries of its subgroups
+ * have their key prefixed with the path of the subgroup.
+ */
+typedef QVector<QPair<QByteArray, QByteArray> > KonqSessionWindowEntries;
+
+/**
+ * A session which can be written to disk from any thread: the entries of
+ * every window, in order. It only holds plain, implicitly shared data.
+ */
+typedef QVector<KonqSessionWindowEntries> KonqSessionSnapshot;
+
+/**
+ * Writes session files in a worker thread.
+ *
+ * The GUI thread only has to take a snapshot of the windows; encoding the
+ * file and syncing it to disk happen in the background. Files are replaced
+ * atomically, so a crash in the middle of a save leaves the previous session
+ * in place. If several saves are requested while the worker is busy, only the
+ * most recent one is written.
+ *
+ * Autosaved sessions use a compact binary format, streamed to and from the
+ * file: a header (magic, version, number of windows) followed, for each
+ * window, by its number of entries and the entries themselves. Keys share
+ * long prefixes ("HistoryItemViewT12_3...") so each key only stores the
+ * length of the prefix it has in common with the previous one, and the rest.
+ * Sessions saved by the user are still KConfig files; openSession() reads
+ * both.
+ */
+class KONQ_TESTS_EXPORT KonqSessionWriter
+{
+public:
+    KonqSessionWriter();
+    /**
+     * Waits for the pending save, if any.
+     */
+    ~KonqSessionWriter();
+
+    /**
+     * Returns the entries of @p group and its subgroups, to be stored in a
+     * snapshot.
+     */
+    static KonqSessionWindowEntries windowEntries(const KConfigGroup &group);
+
+    /**
+     * Writes @p entries back to @p group, recreating its subgroups.
+     */
+    static void writeEntries(const KonqSessionWindowEntries &entries, KConfigGroup &group);
+
+    /**
+     * Writes @p snapshot to @p filePath in the worker thread.
+     */
+    void write(const QString &filePath, const KonqSessionSnapshot &snapshot);
+
+    /**
+     * Blocks until all the requested saves have been written.
+     */
+    void waitForFinished();
+
+    /**
+     * Writes @p snapshot to @p filePath synchronously in the binary format,
+     * replacing the file atomically.
+     * @return true on success
+     */
+    static bool writeSession(const QString &filePath, const KonqSessionSnapshot &snapshot);
+    static bool writeSession(QIODevice *device, const KonqSessionSnapshot &snapshot);
+
+    /**
+     * Reads the binary session file @p filePath into @p snapshot.
+     * @return false if the file couldn't be read or isn't a binary session
+     */
+    static bool readSession(const QString &filePath, KonqSessionSnapshot *snapshot);
+    static bool readSession(QIODevice *device, KonqSessionSnapshot *snapshot);
+
+    /**
+     * Returns true if @p filePath is a binary session file.
+     */
+    static bool isBinarySession(const QString &filePath);
+
+    /**
+     * Opens the session file @p filePath, binary or KConfig, as a KConfig
+     * with a "General" group and a "WindowN" group per window. Binary
+     * sessions are imported into an in-memory KConfig, which isn't saved
+     * back to the file.
+     */
+    static KConfig *openSession(const QString &filePath);
+
+    /**
+     * Converts between snapshots and KConfig sessions.
+     */
+    static KonqSessionSnapshot snapshotFromConfig(const KConfig &config);
+    static void snapshotToConfig(const KonqSessionSnapshot &snapshot, KConfig *config);
+
+private:
+    friend class KonqSessionWriterJob;
+    void writePending();
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    QString m_pendingFilePath;
+    KonqSessionSnapshot m_pendingSnapshot;
+    bool m_hasPending;
+    bool m_jobQueued;
+};
+
+#endif // KONQSESSIONWRITER_H
@@ -0,0 +1,111 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqstartuptrace.h"
+#include "konqdebug.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+class KonqStartupTraceSingleton
+{
+public:
+    KonqStartupTrace self;
+};
+
+Q_GLOBAL_STATIC(KonqStartupTraceSingleton, globalStartupTrace)
+
+KonqStartupTrace *KonqStartupTrace::self()
+{
+    return &globalStartupTrace->self;
+}
+
+KonqStartupTrace::KonqStartupTrace()
+    : m_navigationStart(-1)
+    , m_firstLoadFinished(false)
+{
+    setFileName(qEnvironmentVariable("KONQUEROR_STARTUP_TRACE"));
+}
+
+void KonqStartupTrace::setFileName(const QString &fileName)
+{
+    m_fileName = fileName;
+    m_spans.clear();
+    m_navigationStart = -1;
+    m_firstLoadFinished = false;
+    m_timer.start();
+}
+
+qint64 KonqStartupTrace::now() const
+{
+    return m_timer.nsecsElapsed() / 1000;
+}
+
+void KonqStartupTrace::addSpan(const char *name, qint64 start, qint64 end, const QString &detail)
+{
+    // Only the startup is traced, until the first page is loaded
+    if (isEnabled() && !m_firstLoadFinished) {
+        m_spans.append(Span{name, start, end - start, detail});
+    }
+}
+
+void KonqStartupTrace::navigationStarted()
+{
+    if (isEnabled() && m_navigationStart < 0) {
+        m_navigationStart = now();
+    }
+}
+
+void KonqStartupTrace::loadFinished()
+{
+    if (!isEnabled() || m_firstLoadFinished || m_navigationStart < 0) {
+        return;
+    }
+    addSpan("First load", m_navigationStart, now());
+    m_firstLoadFinished = true;
+    // The time to the first page is what's interesting, don't wait for the exit
+    if (!write()) {
+        qCWarning(KONQUEROR_LOG) << "Couldn't write the startup trace to" << m_fileName;
+    }
+}
+
+bool KonqStartupTrace::write() const
+{
+    if (!isEnabled()) {
+        return false;
+    }
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+    for (const Span &span : m_spans) {
+        QJsonObject event{
+            {QStringLiteral("name"), QString::fromLatin1(span.name)},
+            {QStringLiteral("cat"), QStringLiteral("startup")},
+            {QStringLiteral("ph"), QStringLiteral("X")},
+            {QStringLiteral("ts"), span.start},
+            {QStringLiteral("dur"), span.duration},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), 1}, // everything happens in the GUI thread
+        };
+        if (!span.detail.isEmpty()) {
+            event.insert(QStringLiteral("args"), QJsonObject{{QStringLiteral("detail"), span.detail}});
+        }
+        events.append(event);
+    }
+    const QJsonObject trace{
+        {QStringLiteral("traceEvents"), events},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+    };
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
@@ -0,0 +1,125 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQSTARTUPTRACE_H
+#define KONQSTARTUPTRACE_H
+
+#include "konqprivate_export.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+/**
+ * Records how long the phases of the startup take, until the first page
+ * finished loading, and writes them as a Chrome trace-event JSON file,
+ * which can be opened in about://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is enabled by setting the KONQUEROR_STARTUP_TRACE environment
+ * variable to the path of the file to write. When it isn't set, a span
+ * costs a single check.
+ */
+class KONQ_TESTS_EXPORT KonqStartupTrace
+{
+public:
+    static KonqStartupTrace *self();
+
+    bool isEnabled() const
+    {
+        return !m_fileName.isEmpty();
+    }
+
+    /**
+     * Enables tracing to @p fileName, or disables it if it's empty, and
+     * forgets the spans recorded so far.
+     */
+    void setFileName(const QString &fileName);
+
+    QString fileName() const
+    {
+        return m_fileName;
+    }
+
+    /**
+     * Microseconds since tracing started.
+     */
+    qint64 now() const;
+
+    /**
+     * Records the span @p name, from @p start to @p end (see now()).
+     * @p detail, if any, is shown with it. Nothing is recorded after the
+     * first load finished.
+     */
+    void addSpan(const char *name, qint64 start, qint64 end, const QString &detail = QString());
+
+    /**
+     * Called when a view starts loading a URL. The first time, it starts
+     * the "First load" span.
+     */
+    void navigationStarted();
+
+    /**
+     * Called when a view finished loading. The first time, it ends the
+     * "First load" span and writes the trace.
+     */
+    void loadFinished();
+
+    /**
+     * Writes the spans recorded so far to the trace file.
+     * @return true on success
+     */
+    bool write() const;
+
+private:
+    KonqStartupTrace();
+    friend class KonqStartupTraceSingleton;
+
+    struct Span {
+        const char *name;
+        qint64 start;
+        qint64 duration;
+        QString detail;
+    };
+
+    QElapsedTimer m_timer;
+    QString m_fileName;
+    QVector<Span> m_spans;
+    qint64 m_navigationStart;
+    bool m_firstLoadFinished;
+};
+
+/**
+ * Records the span @p name in the startup trace, from its creation to
+ * its destruction.
+ */
+class KonqStartupSpan
+{
+public:
+    explicit KonqStartupSpan(const char *name, const QString &detail = QString())
+        : m_name(name)
+        , m_detail(detail)
+        , m_start(KonqStartupTrace::self()->isEnabled() ? KonqStartupTrace::self()->now() : -1)
+    {
+    }
+
+    ~KonqStartupSpan()
+    {
+        if (m_start >= 0) {
+            KonqStartupTrace *trace = KonqStartupTrace::self();
+            trace->addSpan(m_name, m_start, trace->now(), m_detail);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(KonqStartupSpan)
+
+    const char *m_name;
+    QString m_detail;
+    qint64 m_start;
+};
+
+#endif // KONQSTARTUPTRACE_H
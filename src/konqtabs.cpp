@@ -27,6 +27,7 @@
 #include "konqmisc.h"
 #include "konqsettingsxt.h"
 #include "konqframevisitor.h"
+#include "konqsessionmanager.h"
 
 #include <kacceleratormanager.h>
 #include <konqpixmapprovider.h>
@@ -178,7 +179,7 @@ void KonqFrameTabs::setTitle(const QString &title, QWidget *sender)
 void KonqFrameTabs::setTabIcon(const QUrl &url, QWidget *sender)
 {
     //qCDebug(KONQUEROR_LOG) << "KonqFrameTabs::setTabIcon( " << url << " , " << sender << " )";
-    QIcon iconSet = QIcon::fromTheme(KonqPixmapProvider::self()->iconNameFor(url));
+    QIcon iconSet = KonqPixmapProvider::self()->iconForUrl(url);
     const int pos = indexOf(sender);
     KTabWidget::setTabIcon(pos, iconSet);
 }
@@ -269,6 +270,7 @@ void KonqFrameTabs::slotMovedTab(int from, int to)
     KonqFrameBase *fromFrame = m_childFrameList.at(from);
     m_childFrameList.removeAll(fromFrame);
     m_childFrameList.insert(to, fromFrame);
+    KonqSessionManager::self()->markWindowDirty(m_pViewManager->mainWindow());
 
     KonqFrameBase *currentFrame = dynamic_cast<KonqFrameBase *>(currentWidget());
     if (currentFrame && !m_pViewManager->isLoadingProfile()) {
@@ -324,7 +326,7 @@ void KonqFrameTabs::refreshSubPopupMenuTab()
                 title = url.toDisplayString();
             }
             title = KStringHandler::csqueeze(title, 50);
-            QAction *action = m_pSubPopupMenuTab->addAction(QIcon::fromTheme(KonqPixmapProvider::self()->iconNameFor(url)), title);
+            QAction *action = m_pSubPopupMenuTab->addAction(KonqPixmapProvider::self()->iconForUrl(url), title);
             action->setData(i);
         }
         ++i;
@@ -195,8 +195,13 @@ void KonqUndoManager::undoClosedItem(int index)
     if (closedTabItem) {
         emit openClosedTab(*closedTabItem);
     } else if (closedRemoteWindowItem) {
+        // Load the state of the window before its file is removed
+        closedRemoteWindowItem->configGroup();
         m_cwManager->removeClosedWindowItem(this, closedRemoteWindowItem);
         emit openClosedWindow(*closedRemoteWindowItem);
+
+        // Save config so that this window won't appear in new konqueror processes
+        m_cwManager->saveConfig();
     } else if (closedWindowItem) {
         m_cwManager->removeClosedWindowItem(this, closedWindowItem);
         emit openClosedWindow(*closedWindowItem);
@@ -248,11 +253,54 @@ void KonqUndoManager::addClosedTabItem(KonqClosedTabItem *closedTabItem)
         }
     }
 
+    closedTabItem->pack();
     m_closedItemList.prepend(closedTabItem);
+    enforceClosedTabsBudget();
     emit undoTextChanged(i18n("Und&o: Closed Tab"));
     emit undoAvailable(true);
 }
 
+void KonqUndoManager::enforceClosedTabsBudget()
+{
+    const qint64 budget = qint64(KonqSettings::closedTabsMemoryBudget()) * 1024;
+    if (budget > 0) {
+        trimClosedTabs(budget);
+    }
+}
+
+void KonqUndoManager::trimClosedTabs(qint64 budget)
+{
+    qint64 memoryUsage = 0;
+    for (const KonqClosedItem *closedItem : qAsConst(m_closedItemList)) {
+        if (const KonqClosedTabItem *closedTabItem = dynamic_cast<const KonqClosedTabItem *>(closedItem)) {
+            memoryUsage += closedTabItem->memoryUsage();
+        }
+    }
+
+    // Oldest first, but always keep the tab which was just closed. Tabs which
+    // can't be spilled are forgotten.
+    const bool spill = KonqSettings::spillClosedTabsToDisk();
+    bool removed = false;
+    for (int i = m_closedItemList.count() - 1; i > 0 && memoryUsage > budget; --i) {
+        KonqClosedTabItem *closedTabItem = dynamic_cast<KonqClosedTabItem *>(m_closedItemList.at(i));
+        if (!closedTabItem || closedTabItem->isSpilled()) {
+            continue;
+        }
+        const int itemMemoryUsage = closedTabItem->memoryUsage();
+        if (spill && closedTabItem->spill()) {
+            memoryUsage -= itemMemoryUsage;
+        } else {
+            m_closedItemList.removeAt(i);
+            delete closedTabItem;
+            memoryUsage -= itemMemoryUsage;
+            removed = true;
+        }
+    }
+    if (removed) {
+        emit closedItemsListChanged();
+    }
+}
+
 void KonqUndoManager::updateSupportsFileUndo(bool enable)
 {
     m_supportsFileUndo = enable;
@@ -262,15 +310,14 @@ void KonqUndoManager::updateSupportsFileUndo(bool enable)
 void KonqUndoManager::clearClosedItemsList(bool onlyInthisWindow)
 {
     populate();
-    QList<KonqClosedItem *>::iterator it = m_closedItemList.begin();
-    for (; it != m_closedItemList.end(); ++it) {
-        KonqClosedItem *closedItem = *it;
+    const QList<KonqClosedItem *> closedItemList = m_closedItemList;
+    m_closedItemList.clear();
+    for (KonqClosedItem *closedItem : closedItemList) {
         const KonqClosedTabItem *closedTabItem =
             dynamic_cast<const KonqClosedTabItem *>(closedItem);
         const KonqClosedWindowItem *closedWindowItem =
             dynamic_cast<const KonqClosedWindowItem *>(closedItem);
 
-        m_closedItemList.erase(it);
         if (closedTabItem) {
             delete closedTabItem;
         } else if (closedWindowItem && !onlyInthisWindow) {
@@ -51,6 +51,12 @@ public:
     void addClosedWindowItem(KonqClosedWindowItem *closedWindowItem);
     void updateSupportsFileUndo(bool enable);
 
+    /**
+     * Spills or removes the oldest closed tabs, all but the last one, while
+     * they use more than @p budget bytes.
+     */
+    void trimClosedTabs(qint64 budget);
+
 public Q_SLOTS:
     void undo();
     void clearClosedItemsList(bool onlyInthisWindow = false);
@@ -95,6 +101,12 @@ private:
     /// Fill the m_closedItemList with closed windows
     void populate();
 
+    /**
+     * Spills or removes the oldest closed tabs while they use more memory
+     * than allowed by the ClosedTabsMemoryBudget setting.
+     */
+    void enforceClosedTabsBudget();
+
     QList<KonqClosedItem *> m_closedItemList;
     KonqClosedWindowsManager *m_cwManager;
     bool m_supportsFileUndo = false;
@@ -23,7 +23,8 @@ namespace KonqUrl {
         Specs,
         Intro,
         Tips,
-        Plugins
+        Plugins,
+        Performance
     };
     
     QLatin1String scheme();
@@ -17,6 +17,12 @@
 #include "konqhistorymanager.h"
 #include "konqpixmapprovider.h"
 #include "konqbrowserinterface.h"
+#include "konqstartuptrace.h"
+#include "konqsessionmanager.h"
+#include "konqhibernator.h"
+#include "konqmimetypecache.h"
+#include "delayedinitializer.h"
+#include <konq_kpart_plugin.h>
 
 #include <kio/job.h>
 #include <kio/jobuidelegate.h>
@@ -49,6 +55,7 @@
 #include <KParts/OpenUrlArguments>
 #include <KParts/BrowserExtension>
 #include <KParts/WindowArgs>
+#include <KXMLGUIFactory>
 #include <QMimeDatabase>
 
 //#define DEBUG_HISTORY
@@ -94,6 +101,10 @@ KonqView::KonqView(KonqViewFactory &viewFactory,
     m_bBuiltinView = false;
     m_bURLDropHandling = false;
     m_bErrorURL = false;
+    m_bHibernated = false;
+    m_bReplayingCompleted = false;
+    m_bVerifyMimeType = false;
+    m_idleTimer.start();
 
 #ifdef KActivities_FOUND
     m_activityResourceInstance = new KActivities::ResourceInstance(mainWindow->winId(), this);
@@ -120,7 +131,6 @@ KonqView::~KonqView()
         delete m_pPart;
     }
 
-    qDeleteAll(m_lstHistory);
     m_lstHistory.clear();
 
     setUrlLoader(nullptr);
@@ -137,6 +147,12 @@ void KonqView::openUrl(const QUrl &url, const QString &locationBarURL,
 {
     qCDebug(KONQUEROR_LOG) << "url=" << url << "locationBarURL=" << locationBarURL;
 
+    if (m_bHibernated && !recreatePart()) {
+        return;
+    }
+    KonqStartupTrace::self()->navigationStarted();
+    m_metrics.navigationStarted(m_pPart);
+
     setPartMimeType();
 
     KParts::OpenUrlArguments args;
@@ -244,6 +260,8 @@ void KonqView::switchView(KonqViewFactory &viewFactory)
     }
     
     m_pPart = part;
+    m_bHibernated = false; // see hibernate()
+    m_bVerifyMimeType = false; // see hibernateWithUrl()
 
     // Set the statusbar in the BE asap to avoid a KMainWindow statusbar being created.
     KParts::StatusBarExtension *sbext = statusBarExtension();
@@ -259,6 +277,10 @@ void KonqView::switchView(KonqViewFactory &viewFactory)
     }
 
     connectPart();
+    // The plugins aren't needed before the view is activated or shown, e.g.
+    // never for a background tab which isn't switched to
+    DelayedInitializer *pluginInitializer = new DelayedInitializer(QEvent::Show, m_pPart->widget());
+    connect(pluginInitializer, &DelayedInitializer::initialize, this, &KonqView::loadPlugins);
 
     QVariant prop;
 
@@ -508,6 +530,10 @@ void KonqView::slotStarted(KIO::Job *job)
 {
     //qCDebug(KONQUEROR_LOG) << job;
     setLoading(true);
+    // Navigations started by the part itself, e.g. when following a link
+    if (!m_metrics.isLoading()) {
+        m_metrics.navigationStarted(m_pPart);
+    }
 
     if (job) {
         // Manage passwords properly...
@@ -517,6 +543,9 @@ void KonqView::slotStarted(KIO::Job *job)
         connect(job, SIGNAL(percent(KJob*,ulong)), this, SLOT(slotPercent(KJob*,ulong)));
         connect(job, SIGNAL(speed(KJob*,ulong)), this, SLOT(slotSpeed(KJob*,ulong)));
         connect(job, SIGNAL(infoMessage(KJob*,QString,QString)), this, SLOT(slotInfoMessage(KJob*,QString)));
+        connect(job, &KJob::result, this, [this](KJob *finishedJob) {
+            m_metrics.addBytes(finishedJob->processedAmount(KJob::Bytes));
+        });
     }
 }
 
@@ -568,6 +597,10 @@ void KonqView::slotCompleted()
 
 void KonqView::slotCompleted(bool hasPending)
 {
+    // Only meant for the plugins, see loadPlugins()
+    if (m_bReplayingCompleted) {
+        return;
+    }
     //qCDebug(KONQUEROR_LOG) << "hasPending=" << hasPending;
     m_pKonqFrame->statusbar()->slotLoadingProgress(-1);
 
@@ -584,6 +617,10 @@ void KonqView::slotCompleted(bool hasPending)
         emit viewCompleted(this);
     }
     setLoading(false, hasPending);
+    m_metrics.loadFinished(m_bAborted);
+    if (!m_bAborted) {
+        KonqStartupTrace::self()->loadFinished();
+    }
 
     if (!m_bGotIconURL && !m_bAborted) {
         if (KonqSettings::enableFavicon() == true) {
@@ -706,41 +743,52 @@ void KonqView::slotOpenURLNotify()
 void KonqView::createHistoryEntry()
 {
     // First, remove any forward history
-    HistoryEntry *current = currentHistoryEntry();
+    const HistoryEntry *current = currentHistoryEntry();
     if (current) {
 #ifdef DEBUG_HISTORY
         qCDebug(KONQUEROR_LOG) << "Truncating history";
 #endif
-        while (current != m_lstHistory.last()) {
-            delete m_lstHistory.takeLast();
+        while (current != m_lstHistory.last().data()) {
+            m_lstHistory.removeLast();
         }
     }
     // Append a new entry
 #ifdef DEBUG_HISTORY
     qCDebug(KONQUEROR_LOG) << "Append a new entry";
 #endif
-    appendHistoryEntry(new HistoryEntry);
+    appendHistoryEntry(HistoryEntry::Ptr(new HistoryEntry));
     setHistoryIndex(m_lstHistory.count() - 1); // made current
+    KonqSessionManager::self()->markWindowDirty(m_pMainWindow);
 #ifdef DEBUG_HISTORY
     qCDebug(KONQUEROR_LOG) << "at=" << historyIndex() << "count=" << m_lstHistory.count();
 #endif
 }
 
-void KonqView::appendHistoryEntry(HistoryEntry *historyEntry)
+void KonqView::appendHistoryEntry(const HistoryEntry::Ptr &historyEntry)
 {
     // If there are too many HistoryEntries remove old ones
     while (m_lstHistory.count() > 0 && m_lstHistory.count() >= KonqSettings::maximumHistoryEntriesPerView()) {
-        delete m_lstHistory.takeFirst();
+        m_lstHistory.removeFirst();
     }
 
     m_lstHistory.append(historyEntry);
 }
 
+HistoryEntry *KonqView::writableHistoryEntry()
+{
+    if (m_lstHistoryIndex < 0 || m_lstHistoryIndex >= m_lstHistory.count()) {
+        return nullptr;
+    }
+    HistoryEntry::Ptr &entry = m_lstHistory[m_lstHistoryIndex];
+    entry.detach(); // copies it if another view shares it
+    return entry.data();
+}
+
 void KonqView::updateHistoryEntry(bool needsReload)
 {
     Q_ASSERT(!m_bLockHistory);   // should never happen
 
-    HistoryEntry *current = currentHistoryEntry();
+    HistoryEntry *current = writableHistoryEntry();
     if (!current) {
         return;
     }
@@ -780,6 +828,7 @@ void KonqView::updateHistoryEntry(bool needsReload)
     current->postData = m_doPost ? m_postData : QByteArray();
     current->postContentType = m_doPost ? m_postContentType : QString();
     current->pageReferrer = m_pageReferrer;
+    KonqSessionManager::self()->markWindowDirty(m_pMainWindow);
 }
 
 void KonqView::go(int steps)
@@ -807,6 +856,7 @@ void KonqView::go(int steps)
     stop();
 
     setHistoryIndex(newPos);   // sets current item
+    KonqSessionManager::self()->markWindowDirty(m_pMainWindow);
 
 #ifdef DEBUG_HISTORY
     qCDebug(KONQUEROR_LOG) << "New position" << historyIndex();
@@ -815,10 +865,67 @@ void KonqView::go(int steps)
     restoreHistory();
 }
 
+void KonqView::hibernateWithUrl(const QUrl &url, bool verifyMimeType)
+{
+    KonqHibernatedPart *part = qobject_cast<KonqHibernatedPart *>(m_pPart);
+    if (!part) {
+        return;
+    }
+    part->setHibernatedUrl(url);
+
+    // A single entry without saved state, which restoreHistory() opens
+    createHistoryEntry();
+    HistoryEntry *current = writableHistoryEntry();
+    current->url = url;
+    current->locationBarURL = url.toDisplayString();
+    current->title = url.toDisplayString();
+    current->strServiceType = m_serviceType;
+    current->strServiceName = m_service->desktopEntryName();
+    current->doPost = false;
+    current->pageSecurity = KonqMainWindow::NotCrypted;
+    current->reload = false;
+
+    setLocationBarURL(current->locationBarURL);
+    setCaption(current->title);
+    m_bHibernated = true;
+    m_bVerifyMimeType = verifyMimeType;
+}
+
+void KonqView::loadPlugins()
+{
+    // The plugins of a hibernated view are loaded when it wakes up
+    if (m_bHibernated || !KonqViewFactory::loadPlugins(m_pPart)) {
+        return;
+    }
+    const QList<KonqParts::Plugin *> plugins = KonqParts::Plugin::pluginObjects(m_pPart);
+    // The GUI of the part is merged if it's the current view: add the plugins to it
+    if (KXMLGUIFactory *factory = m_pPart->factory()) {
+        for (KonqParts::Plugin *plugin : plugins) {
+            if (!plugin->factory()) {
+                factory->addClient(plugin);
+            }
+        }
+    }
+    // The plugins follow the page with the started() and completed() signals
+    // of the part: tell them about the page which is already loaded
+    if (!plugins.isEmpty() && !m_bLoading && !m_pPart->url().isEmpty()) {
+        m_bReplayingCompleted = true;
+        emit m_pPart->completed();
+        m_bReplayingCompleted = false;
+    }
+}
+
+int KonqView::pluginCount() const
+{
+    return m_pPart ? KonqParts::Plugin::pluginObjects(m_pPart).count() : 0;
+}
+
 void KonqView::restoreHistory()
 {
-    HistoryEntry h(*currentHistoryEntry());   // make a copy of the current history entry, as the data
-    // the pointer points to will change with the following calls
+    // Keep a reference to the current history entry: it's detached rather
+    // than changed if the following calls update the history
+    const HistoryEntry::Ptr entry = m_lstHistory.value(m_lstHistoryIndex);
+    const HistoryEntry &h = *entry;
 
 #ifdef DEBUG_HISTORY
     qCDebug(KONQUEROR_LOG) << "Restoring servicetype/name, and location bar URL from history:" << h.locationBarURL;
@@ -861,7 +968,7 @@ void KonqView::restoreHistory()
 
 const HistoryEntry *KonqView::historyAt(int pos)
 {
-    return m_lstHistory.value(pos);
+    return m_lstHistory.value(pos).data();
 }
 
 void KonqView::copyHistory(KonqView *other)
@@ -870,13 +977,10 @@ void KonqView::copyHistory(KonqView *other)
         return;
     }
 
-    qDeleteAll(m_lstHistory);
-    m_lstHistory.clear();
-
-    foreach (HistoryEntry *he, other->m_lstHistory) {
-        appendHistoryEntry(new HistoryEntry(*he));
-    }
+    // Both views share the entries (and their buffers) until they diverge
+    m_lstHistory = other->m_lstHistory;
     setHistoryIndex(other->historyIndex());
+    KonqSessionManager::self()->markWindowDirty(m_pMainWindow);
 }
 
 QUrl KonqView::url() const
@@ -979,11 +1083,13 @@ void KonqView::setLinkedView(bool mode)
         m_pMainWindow->linkViewAction()->setChecked(mode);
     }
     frame()->statusbar()->setLinkedView(mode);
+    KonqSessionManager::self()->markWindowDirty(m_pMainWindow);
 }
 
 void KonqView::setLockedLocation(bool b)
 {
     m_bLockedLocation = b;
+    KonqSessionManager::self()->markWindowDirty(m_pMainWindow);
 }
 
 void KonqView::aboutToOpenURL(const QUrl &url, const KParts::OpenUrlArguments &args)
@@ -1116,13 +1222,22 @@ QString KonqView::partObjectPath()
     return dcopProperty.toString();
 }
 
+QVariantMap KonqView::metrics() const
+{
+    QVariantMap metrics = m_metrics.toVariantMap(m_pPart);
+    metrics.insert(QStringLiteral("url"), url().toString());
+    return metrics;
+}
+
 bool KonqView::eventFilter(QObject *obj, QEvent *e)
 {
     if (!m_pPart) {
         return false;
     }
 //  qCDebug(KONQUEROR_LOG) << "--" << obj->className() << "--" << e->type() << "--" ;
-    if (e->type() == QEvent::DragEnter && m_bURLDropHandling && obj == m_pPart->widget()) {
+    if (e->type() == QEvent::Paint) {
+        m_metrics.painted();
+    } else if (e->type() == QEvent::DragEnter && m_bURLDropHandling && obj == m_pPart->widget()) {
         QDragEnterEvent *ev = static_cast<QDragEnterEvent *>(e);
         const QMimeData *mimeData = ev->mimeData();
         if (mimeData->hasUrls()) {
@@ -1229,7 +1344,7 @@ bool KonqView::isWebBrowsingPart() const
 }
 
 
-void HistoryEntry::saveConfig(KConfigGroup &config, const QString &prefix, const KonqFrameBase::Options &options)
+void HistoryEntry::saveConfig(KConfigGroup &config, const QString &prefix, const KonqFrameBase::Options &options) const
 {
     if (options & KonqFrameBase::SaveUrls) {
         config.writeEntry(QStringLiteral("Url").prepend(prefix), url.url());
@@ -1287,8 +1402,8 @@ void KonqView::saveConfig(KConfigGroup &config, const QString &prefix, const Kon
     if (options & KonqFrameBase::SaveUrls) {
         config.writePathEntry(QStringLiteral("URL").prepend(prefix), url().url());
     } else if (options & KonqFrameBase::SaveHistoryItems) {
-        QList<HistoryEntry *>::Iterator it = m_lstHistory.begin();
-        for (int i = 0; it != m_lstHistory.end(); ++it, ++i) {
+        QList<HistoryEntry::Ptr>::ConstIterator it = m_lstHistory.constBegin();
+        for (int i = 0; it != m_lstHistory.constEnd(); ++it, ++i) {
             // In order to not end up with a huge config file, we only save full
             // history for current history item
             KonqFrameBase::Options options;
@@ -1303,13 +1418,18 @@ void KonqView::saveConfig(KConfigGroup &config, const QString &prefix, const Kon
         }
         config.writeEntry(QStringLiteral("CurrentHistoryItem").prepend(prefix), m_lstHistoryIndex);
         config.writeEntry(QStringLiteral("NumberOfHistoryItems").prepend(prefix), historyLength());
+    } else if (options & KonqFrameBase::SaveCurrentHistoryItem) {
+        if (const HistoryEntry *current = currentHistoryEntry()) {
+            current->saveConfig(config, QStringLiteral("HistoryItem0").prepend(prefix), KonqFrameBase::SaveHistoryItems);
+            config.writeEntry(QStringLiteral("CurrentHistoryItem").prepend(prefix), 0);
+            config.writeEntry(QStringLiteral("NumberOfHistoryItems").prepend(prefix), 1);
+        }
     }
 }
 
 void KonqView::loadHistoryConfig(const KConfigGroup &config, const QString &prefix)
 {
     // First, remove any history
-    qDeleteAll(m_lstHistory);
     m_lstHistory.clear();
 
     int historySize = config.readEntry(QStringLiteral("NumberOfHistoryItems").prepend(prefix), 0);
@@ -1323,7 +1443,7 @@ void KonqView::loadHistoryConfig(const KConfigGroup &config, const QString &pref
 
     // restore history list
     for (int i = 0; i < historySize; ++i) {
-        HistoryEntry *historyEntry = new HistoryEntry;
+        HistoryEntry::Ptr historyEntry(new HistoryEntry);
 
         // Only current history item saves completely its HistoryEntry
         KonqFrameBase::Options options;
@@ -1391,3 +1511,62 @@ bool KonqView::isErrorUrl() const
     return m_bErrorURL;
 }
 
+bool KonqView::canHibernate() const
+{
+    return !m_bHibernated && m_pPart && !m_bLoading && !m_bLockHistory && !isLockedViewMode() && !m_bLinkedView
+           && m_pMainWindow->currentView() != this && !m_pKonqFrame->isVisible()
+           && m_lstHistoryIndex >= 0 && !isModified();
+}
+
+bool KonqView::hibernate()
+{
+    if (!canHibernate()) {
+        return false;
+    }
+
+    // Save the state of the page (URL, scroll position...) so
+    // that wakeUp() can restore it
+    updateHistoryEntry(false);
+    const QUrl url = m_pPart->url();
+
+    KonqViewFactory viewFactory(QStringLiteral("konqhibernatedpart"), KonqHibernatedPart::factory());
+    switchView(viewFactory);
+    if (!qobject_cast<KonqHibernatedPart *>(m_pPart)) {
+        return false;
+    }
+    static_cast<KonqHibernatedPart *>(m_pPart)->setHibernatedUrl(url);
+    // m_service is still the real service, so that the session and the
+    // view mode actions don't see a difference
+    m_bHibernated = true;
+    return true;
+}
+
+bool KonqView::recreatePart()
+{
+    KonqFactory konqFactory;
+    KonqViewFactory viewFactory = konqFactory.createView(m_serviceType, m_service->desktopEntryName());
+    if (viewFactory.isNull()) {
+        qCWarning(KONQUEROR_LOG) << "Couldn't recreate the part of hibernated view" << this;
+        return false;
+    }
+    switchView(viewFactory);
+    return !m_bHibernated;
+}
+
+void KonqView::wakeUp()
+{
+    if (!m_bHibernated) {
+        return;
+    }
+    // Recreating the part resets it
+    const bool verifyMimeType = m_bVerifyMimeType;
+    if (!recreatePart()) {
+        return;
+    }
+    restoreHistory();
+    if (verifyMimeType) {
+        // KonqMainWindow opens the URL again if the part was chosen from a wrong type
+        KonqMimeTypeCache::self()->verify(url(), m_serviceType);
+    }
+}
+
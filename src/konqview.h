@@ -11,16 +11,19 @@
 #include "konqmainwindow.h" // hmm, please move PageSecurity out of konq_mainwindow...
 #include "konqfactory.h"
 #include "konqframe.h"
+#include "konqviewmetrics.h"
 
 #include <kservice.h>
 #include <QMimeType>
 
 #include <QList>
+#include <QSharedData>
 
 #include <QObject>
 #include <QStringList>
 #include <QPointer>
 #include <QEvent>
+#include <QElapsedTimer>
 
 #include <config-konqueror.h>
 
@@ -41,9 +44,13 @@ class ResourceInstance;
 
 // TODO: make the history-handling code reuseable (e.g. in kparts) for people who want to use a
 // khtml-based browser in some apps. Back/forward support is all in here currently.
-struct HistoryEntry {
+// Entries are shared between views whose history was copied from each other;
+// KonqView detaches an entry before changing it.
+struct HistoryEntry : public QSharedData {
+    typedef QExplicitlySharedDataPointer<HistoryEntry> Ptr;
+
     void loadItem(const KConfigGroup &config, const QString &prefix, const KonqFrameBase::Options &options);
-    void saveConfig(KConfigGroup &config, const QString &prefix, const KonqFrameBase::Options &options);
+    void saveConfig(KConfigGroup &config, const QString &prefix, const KonqFrameBase::Options &options) const;
 
     QUrl url;
     QString locationBarURL; // can be different from url when showing a index.html
@@ -184,7 +191,7 @@ public:
     /**
      * @return the history of this view
      */
-    const QList<HistoryEntry *> &history()
+    const QList<HistoryEntry::Ptr> &history()
     {
         return m_lstHistory;
     }
@@ -195,15 +202,16 @@ public:
     const HistoryEntry *historyAt(int pos);
 
     /**
-     *
+     * @return the current HistoryEntry, which may be shared with other views
      */
-    HistoryEntry *currentHistoryEntry() const
+    const HistoryEntry *currentHistoryEntry() const
     {
-        return m_lstHistory.value(m_lstHistoryIndex);
+        return m_lstHistory.value(m_lstHistoryIndex).data();
     }
 
     /**
-     * Creates a deep copy of the @p other view's history buffers.
+     * Copies the history of the @p other view. The entries are shared by
+     * both views until one of them changes an entry.
      */
     void copyHistory(KonqView *other);
 
@@ -264,6 +272,73 @@ public:
      */
     bool isModified() const;
 
+    /**
+     * Releases the part of this view (and the memory used by the page it
+     * shows), keeping the history, title and icon of the view. A lightweight
+     * placeholder part takes its place until wakeUp() recreates it, which
+     * happens when the view is activated.
+     * @return false if the view can't be hibernated, see canHibernate()
+     */
+    bool hibernate();
+
+    /**
+     * Recreates the part of a hibernated view and restores its current
+     * history entry.
+     */
+    void wakeUp();
+
+    /**
+     * Hibernates a view which has shown nothing yet, as if it had shown @p url:
+     * waking it up opens @p url. Used by KonqViewManager::addHibernatedTab().
+     * With @p verifyMimeType, the type of the view was only assumed: it is
+     * checked with KonqMimeTypeCache::verify() when the view wakes up.
+     */
+    void hibernateWithUrl(const QUrl &url, bool verifyMimeType = false);
+
+    /**
+     * Returns true if the part of this view was released by hibernate().
+     */
+    bool isHibernated() const
+    {
+        return m_bHibernated;
+    }
+
+    /**
+     * Loads the plugins of the part (see KonqViewFactory::loadPlugins()) if
+     * this wasn't done yet, merging their GUI if this is the current view.
+     * Plugins loaded after the page get its completed() signal again.
+     * Happens when the view is activated, or when the part widget is first
+     * shown.
+     */
+    void loadPlugins();
+
+    /**
+     * Returns the number of plugins loaded for the part.
+     */
+    int pluginCount() const;
+
+    /**
+     * Returns true if the view could be hibernated now: it isn't shown,
+     * loading, modified or a passive/toggle view.
+     */
+    bool canHibernate() const;
+
+    /**
+     * Returns the number of milliseconds since the view was last active.
+     */
+    qint64 idleTime() const
+    {
+        return m_idleTimer.elapsed();
+    }
+
+    /**
+     * Called when the view becomes or stops being the current view.
+     */
+    void resetIdleTime()
+    {
+        m_idleTimer.restart();
+    }
+
     /**
      * Return the security state of page in view
      */
@@ -474,6 +549,11 @@ public:
     QString dbusObjectPath();
     QString partObjectPath();
 
+    /**
+     * Returns how the loading of the current URL went, see KonqViewMetrics.
+     */
+    QVariantMap metrics() const;
+
     // Set the KGlobal active componentData(the one used by KBugReport)
     void setActiveComponent();
 
@@ -577,7 +657,13 @@ private:
     /**
      * Appends a entry in the history.
      */
-    void appendHistoryEntry(HistoryEntry *historyEntry);
+    void appendHistoryEntry(const HistoryEntry::Ptr &historyEntry);
+
+    /**
+     * Returns the current entry in the history, detached from the other
+     * views sharing it, so that it can be changed.
+     */
+    HistoryEntry *writableHistoryEntry();
 
     /**
      * Updates the current entry in the history.
@@ -592,6 +678,11 @@ private:
 
     void finishedWithCurrentURL();
 
+    /**
+     * Creates the real part of a hibernated view again.
+     */
+    bool recreatePart();
+
     bool eventFilter(QObject *obj, QEvent *e) override;
 
 ////////////////// private members ///////////////
@@ -606,7 +697,7 @@ private:
     /**
      * The full history (back + current + forward)
      */
-    QList<HistoryEntry *> m_lstHistory;
+    QList<HistoryEntry::Ptr> m_lstHistory;
     /**
      * The current position in the history
      */
@@ -645,6 +736,11 @@ private:
     uint m_bURLDropHandling: 1;
     uint m_bDisableScrolling: 1;
     uint m_bErrorURL: 1;
+    uint m_bHibernated: 1;
+    uint m_bReplayingCompleted: 1;
+    uint m_bVerifyMimeType: 1;
+    QElapsedTimer m_idleTimer;
+    KonqViewMetrics m_metrics;
     KService::List m_partServiceOffers;
     KService::List m_appServiceOffers;
     KService::Ptr m_service;
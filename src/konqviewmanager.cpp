@@ -15,6 +15,8 @@
 #include "konqtabs.h"
 #include "konqsettingsxt.h"
 #include "konqframevisitor.h"
+#include "konqstartuptrace.h"
+#include "konqhibernator.h"
 #include <konq_events.h>
 #include "konqurl.h"
 
@@ -244,6 +246,21 @@ KonqView *KonqViewManager::addTab(const QString &serviceType, const QString &ser
     return childView;
 }
 
+KonqView *KonqViewManager::addHibernatedTab(const QUrl &url, const QString &mimeType, bool openAfterCurrentPage, bool verifyMimeType)
+{
+    KService::Ptr service;
+    KService::List partServiceOffers, appServiceOffers;
+    // Only to know the part which will be created when the view wakes up
+    if (createView(mimeType, QString(), service, partServiceOffers, appServiceOffers, true /*forceAutoEmbed*/).isNull()) {
+        return nullptr;
+    }
+
+    KonqViewFactory viewFactory(QStringLiteral("konqhibernatedpart"), KonqHibernatedPart::factory());
+    KonqView *childView = setupView(tabContainer(), viewFactory, service, partServiceOffers, appServiceOffers, mimeType, false, openAfterCurrentPage);
+    childView->hibernateWithUrl(url, verifyMimeType);
+    return childView;
+}
+
 KonqView *KonqViewManager::addTabFromHistory(KonqView *currentView, int steps, bool openAfterCurrentPage)
 {
     int oldPos = currentView->historyIndex();
@@ -285,16 +302,17 @@ void KonqViewManager::duplicateTab(int tabIndex, bool openAfterCurrentPage)
     QString prefix = KonqFrameBase::frameTypeToString(tab->frameType()) + QString::number(0); // always T0
     profileGroup.writeEntry("RootItem", prefix);
     prefix.append(QLatin1Char('_'));
-    KonqFrameBase::Options flags = KonqFrameBase::SaveHistoryItems;
+    // The other history entries are shared with the new tab below
+    KonqFrameBase::Options flags = KonqFrameBase::SaveCurrentHistoryItem;
     tab->saveConfig(profileGroup, prefix, flags, nullptr, 0, 1);
 
     loadRootItem(profileGroup, tabContainer(), QUrl(), true, QUrl(), QString(), openAfterCurrentPage);
 
-    if (openAfterCurrentPage) {
-        m_tabContainer->setCurrentIndex(m_tabContainer->currentIndex() + 1);
-    } else {
-        m_tabContainer->setCurrentIndex(m_tabContainer->count() - 1);
+    const int newIndex = openAfterCurrentPage ? m_tabContainer->currentIndex() + 1 : m_tabContainer->count() - 1;
+    if (KonqFrameBase *newTab = m_tabContainer->tabAt(newIndex)) {
+        newTab->copyHistory(tab);
     }
+    m_tabContainer->setCurrentIndex(newIndex);
 
 #ifdef DEBUG_VIEWMGR
     m_pMainWindow->dumpViewList();
@@ -319,13 +337,17 @@ KonqMainWindow *KonqViewManager::breakOffTab(int tab, const QSize &windowSize)
     QString prefix = KonqFrameBase::frameTypeToString(tabFrame->frameType()) + QString::number(0); // always T0
     profileGroup.writeEntry("RootItem", prefix);
     prefix.append(QLatin1Char('_'));
-    KonqFrameBase::Options flags = KonqFrameBase::SaveHistoryItems;
+    // The other history entries are shared with the new window below
+    KonqFrameBase::Options flags = KonqFrameBase::SaveCurrentHistoryItem;
     tabFrame->saveConfig(profileGroup, prefix, flags, nullptr, 0, 1);
 
     KonqMainWindow *mainWindow = new KonqMainWindow;
 
     KonqFrameTabs *newTabContainer = mainWindow->viewManager()->tabContainer();
     mainWindow->viewManager()->loadRootItem(profileGroup, newTabContainer, QUrl(), true, QUrl());
+    if (KonqFrameBase *newTab = newTabContainer->tabAt(0)) {
+        newTab->copyHistory(tabFrame);
+    }
 
     removeTab(tabFrame, false);
 
@@ -891,6 +913,7 @@ void KonqViewManager::loadViewConfigFromGroup(const KConfigGroup &profileGroup,
         bool openUrl)
 {
     Q_UNUSED(filename); // could be useful in case of error messages
+    KonqStartupSpan span("Load view config");
 
     QUrl defaultURL;
     if (m_pMainWindow->currentView()) {
@@ -82,6 +82,16 @@ public:
                      const QString &serviceName = QString(),
                      bool passiveMode = false, bool openAfterCurrentPage = false, int pos = -1);
 
+    /**
+     * Adds a tab which shows @p url only once it's activated: until then, it
+     * is hibernated (see KonqView::hibernate()) and no part is created for it.
+     * @param mimeType the type of @p url, which decides the part to create
+     * @param verifyMimeType whether @p mimeType is only assumed, and has to be
+     * checked when the tab wakes up (see KonqView::hibernateWithUrl())
+     * @return nullptr if no part can show @p mimeType
+     */
+    KonqView *addHibernatedTab(const QUrl &url, const QString &mimeType, bool openAfterCurrentPage = false, bool verifyMimeType = false);
+
     /**
      * Duplicates the specified tab
      */
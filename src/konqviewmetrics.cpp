@@ -0,0 +1,113 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "konqviewmetrics.h"
+#include "konqhibernator.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+KonqViewMetrics::KonqViewMetrics()
+    : m_navigationStart(-1)
+    , m_firstPaint(-1)
+    , m_loadFinished(-1)
+    , m_bytes(0)
+    , m_aborted(false)
+    , m_cpuPid(-1)
+    , m_cpuTimeAtStart(0)
+{
+}
+
+// Returns the value of the dynamic property @p name of @p part, or @p defaultValue if it isn't set
+static qint64 partValue(const QObject *part, const char *name, qint64 defaultValue)
+{
+    const QVariant value = part ? part->property(name) : QVariant();
+    return value.isValid() ? value.toLongLong() : defaultValue;
+}
+
+// Parts which don't say otherwise are rendered by this process
+qint64 KonqViewMetrics::rendererPid(const QObject *part)
+{
+    return partValue(part, "konqRendererPid", QCoreApplication::applicationPid());
+}
+
+void KonqViewMetrics::navigationStarted(const QObject *part)
+{
+    m_cpuPid = rendererPid(part);
+    m_cpuTimeAtStart = cpuTime(m_cpuPid);
+    m_timer.start();
+    m_navigationStart = QDateTime::currentMSecsSinceEpoch();
+    m_firstPaint = -1;
+    m_loadFinished = -1;
+    m_bytes = 0;
+    m_aborted = false;
+}
+
+void KonqViewMetrics::painted()
+{
+    if (m_timer.isValid() && m_firstPaint < 0) {
+        m_firstPaint = m_timer.elapsed();
+    }
+}
+
+void KonqViewMetrics::loadFinished(bool aborted)
+{
+    if (isLoading()) {
+        m_loadFinished = m_timer.elapsed();
+        m_aborted = aborted;
+    }
+}
+
+void KonqViewMetrics::addBytes(qint64 bytes)
+{
+    m_bytes += bytes;
+}
+
+qint64 KonqViewMetrics::cpuTime(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    QFile file(pid > 0 ? QStringLiteral("/proc/%1/stat").arg(pid) : QStringLiteral("/proc/self/stat"));
+    if (file.open(QIODevice::ReadOnly)) {
+        // The command name can contain spaces, the fields are counted from its end
+        const QByteArray line = file.readLine();
+        const QList<QByteArray> fields = line.mid(line.lastIndexOf(')') + 2).split(' ');
+        // utime and stime, the 14th and 15th fields, in clock ticks
+        if (fields.count() > 12) {
+            const qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+            return ticks * 1000 / sysconf(_SC_CLK_TCK);
+        }
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return 0;
+}
+
+QVariantMap KonqViewMetrics::toVariantMap(const QObject *part) const
+{
+    const qint64 pid = rendererPid(part);
+    // The renderer can change with the navigation
+    const qint64 cpuTimeSinceStart = cpuTime(pid) - (pid == m_cpuPid ? m_cpuTimeAtStart : 0);
+
+    QVariantMap metrics;
+    metrics.insert(QStringLiteral("loading"), isLoading());
+    metrics.insert(QStringLiteral("aborted"), m_aborted);
+    metrics.insert(QStringLiteral("navigationStart"), m_navigationStart);
+    metrics.insert(QStringLiteral("firstPaint"), partValue(part, "konqFirstPaint", m_firstPaint));
+    metrics.insert(QStringLiteral("loadFinished"), m_loadFinished);
+    metrics.insert(QStringLiteral("bytes"), partValue(part, "konqBytesReceived", m_bytes));
+    metrics.insert(QStringLiteral("blockedRequests"), partValue(part, "konqBlockedRequests", 0));
+    metrics.insert(QStringLiteral("schemeHandlerTime"), partValue(part, "konqSchemeHandlerTime", 0));
+    metrics.insert(QStringLiteral("rendererPid"), pid);
+    metrics.insert(QStringLiteral("rendererMemory"), KonqHibernator::residentMemory(pid));
+    metrics.insert(QStringLiteral("cpuTime"), m_timer.isValid() ? cpuTimeSinceStart : 0);
+    return metrics;
+}
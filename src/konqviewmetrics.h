@@ -0,0 +1,97 @@
+/* This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 Konqueror developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KONQVIEWMETRICS_H
+#define KONQVIEWMETRICS_H
+
+#include "konqprivate_export.h"
+
+#include <QElapsedTimer>
+#include <QVariantMap>
+
+class QObject;
+
+/**
+ * Records how the loading of the URL shown by a KonqView went, so that it
+ * can be read over D-Bus (see KonqViewAdaptor::metrics()).
+ *
+ * The view itself knows when the navigation started, when the part widget
+ * was first painted, when the load finished and how many bytes its KIO jobs
+ * transferred. Anything else only the part knows: it can report it with
+ * these dynamic properties, which it resets when it starts loading a page:
+ * - konqBytesReceived: bytes transferred for the page and its resources
+ * - konqFirstPaint: milliseconds from the navigation start to the first paint
+ * - konqBlockedRequests: number of requests blocked by the ad filter
+ * - konqSchemeHandlerTime: milliseconds spent answering requests for
+ *   schemes the part handles itself
+ * - konqRendererPid: process rendering the page, if it isn't this one
+ * The values reported by the part win over those the view measured.
+ */
+class KONQ_TESTS_EXPORT KonqViewMetrics
+{
+public:
+    KonqViewMetrics();
+
+    /**
+     * Starts recording the loading of a new URL by @p part, forgetting the
+     * previous one.
+     */
+    void navigationStarted(const QObject *part);
+
+    /**
+     * Called when the part widget is painted.
+     */
+    void painted();
+
+    /**
+     * Called when the part finished loading, or gave up if @p aborted.
+     */
+    void loadFinished(bool aborted);
+
+    /**
+     * Adds @p bytes to the amount transferred for the page.
+     */
+    void addBytes(qint64 bytes);
+
+    bool isLoading() const
+    {
+        return m_timer.isValid() && m_loadFinished < 0;
+    }
+
+    /**
+     * Returns the metrics, completed by what @p part reported. The
+     * navigation start is in milliseconds since the epoch, the other times
+     * in milliseconds since the navigation start, or -1 when they didn't
+     * happen yet.
+     */
+    QVariantMap toVariantMap(const QObject *part) const;
+
+    /**
+     * Returns the CPU time used so far by the process @p pid, or by this one
+     * if it's 0, in milliseconds, or 0 if it can't be determined on this
+     * platform.
+     */
+    static qint64 cpuTime(qint64 pid = 0);
+
+    /**
+     * Returns the process rendering the page shown by @p part: the one it
+     * reported with konqRendererPid, or this one.
+     */
+    static qint64 rendererPid(const QObject *part);
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_navigationStart;
+    qint64 m_firstPaint;
+    qint64 m_loadFinished;
+    qint64 m_bytes;
+    bool m_aborted;
+    // The renderer when the navigation started, and how much CPU it had used
+    qint64 m_cpuPid;
+    qint64 m_cpuTimeAtStart;
+};
+
+#endif // KONQVIEWMETRICS_H
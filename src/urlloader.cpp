@@ -11,6 +11,7 @@
 #include "konqmainwindow.h"
 #include "konqview.h"
 #include "konqurl.h"
+#include "konqmimetypecache.h"
 
 #include <KIO/OpenUrlJob>
 #include <KIO/JobUiDelegate>
@@ -98,7 +99,8 @@ void UrlLoader::start()
         detectSettingsForRemoteFiles();
     }
 
-    if (isMimeTypeKnown(m_mimeType)) {
+    // A guessed type mustn't change how the URL is handled if it turns out to be wrong
+    if (isMimeTypeKnown(m_mimeType) && !m_mimeTypeGuessed) {
         KService::Ptr preferredService = KApplicationTrader::preferredService(m_mimeType);
         if (serviceIsKonqueror(preferredService)) {
             m_request.forceAutoEmbed = true;
@@ -129,15 +131,37 @@ void UrlLoader::decideAction()
             return;
         default:
             if (isViewLocked() || shouldEmbedThis()) {
+                // A guessed type is only used to embed the URL without asking,
+                // since KonqMainWindow can open it again if verify() says otherwise
+                if (m_mimeTypeGuessed && !embedWithoutAskingToSave(m_mimeType)) {
+                    discardGuess();
+                    return;
+                }
                 bool success = decideEmbedOrSave();
                 if (success) {
                     return;
                 }
             }
+            // Opening or saving the URL can't be undone: ask the server first
+            if (m_mimeTypeGuessed) {
+                discardGuess();
+                return;
+            }
             decideOpenOrSave();
     }
 }
 
+void UrlLoader::discardGuess()
+{
+    m_mimeType.clear();
+    m_request.args.setMimeType(QString());
+    m_mimeTypeGuessed = false;
+    m_service = nullptr;
+    m_action = OpenUrlAction::UnknwonAction;
+    m_ready = false;
+    m_isAsync = true;
+}
+
 void UrlLoader::abort()
 {
     if (m_openUrlJob) {
@@ -337,6 +361,7 @@ void UrlLoader::launchOpenUrlJob(bool pauseOnMimeTypeDetermined)
 void UrlLoader::mimetypeDeterminedByJob(const QString &mimeType)
 {
     m_mimeType=mimeType;
+    KonqMimeTypeCache::self()->record(m_url, m_mimeType);
     m_openUrlJob->suspend();
     decideAction();
     if (m_action != OpenUrlAction::Execute) {
@@ -362,6 +387,17 @@ void UrlLoader::detectSettingsForRemoteFiles()
     if (m_url.isLocalFile()) {
         return;
     }
+    // http URLs go to the HTML engine first, which finds their type itself.
+    // The others, and those it gave up on, would need an OpenUrlJob.
+    if (!isMimeTypeKnown(m_mimeType) && !shouldUseDefaultHttpMimeype()) {
+        const QString guess = KonqMimeTypeCache::self()->guess(m_url);
+        // If the HTML engine gave up, it isn't HTML, whatever similar URLs were
+        if (!guess.isEmpty() && !(m_dontPassToWebEnginePart && guess == QLatin1String("text/html"))) {
+            m_mimeType = guess;
+            m_request.args.setMimeType(guess);
+            m_mimeTypeGuessed = true;
+        }
+    }
     if (shouldUseDefaultHttpMimeype()) {
         m_mimeType = QLatin1String("text/html");
         m_request.args.setMimeType(QStringLiteral("text/html"));
@@ -412,8 +448,7 @@ void UrlLoader::detectSettingsForLocalFiles()
             }
         }
     } else {
-        QMimeDatabase db;
-        m_mimeType = db.mimeTypeForFile(m_url.path()).name();
+        m_mimeType = KonqMimeTypeCache::self()->mimeTypeForLocalFile(m_url.path());
     }
 }
 
@@ -427,6 +462,10 @@ void UrlLoader::embed()
 {
     bool embedded = m_mainWindow->openView(m_mimeType, m_url, m_view, m_request);
     if (embedded) {
+        if (m_mimeTypeGuessed) {
+            // KonqMainWindow reopens the URL if the guess was wrong
+            KonqMimeTypeCache::self()->verify(m_url, m_mimeType);
+        }
         done();
     } else {
         decideOpenOrSave();
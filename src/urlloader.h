@@ -9,6 +9,7 @@
 #ifndef URLLLOADER_H
 #define URLLLOADER_H
 
+#include "konqprivate_export.h"
 #include "konqopenurlrequest.h"
 
 #include <QObject>
@@ -46,7 +47,7 @@ class KonqView;
  * - call goOn(): this will asynchronously determine the mimetype and the action to carry out, if not already done,
  * and perform the action itself
  */
-class UrlLoader : public QObject
+class KONQ_TESTS_EXPORT UrlLoader : public QObject
 {
     Q_OBJECT
 
@@ -95,6 +96,8 @@ public:
      * - the URL is a local file
      * - the URL scheme is `http` and the URL hasn't yet been processed by the default HTML engine (in this case,
      * a fake `text/html` mimetype will be used and the HTML engine will take care of determining the mimetype)
+     * - KonqMimeTypeCache can guess the mimetype from similar URLs and the URL will be embedded without asking
+     * (the guess is verified afterwards)
      *
      * @note This function *doesn't* create or start the `OpenUrlJob`, even if it will be needed.
      */
@@ -166,6 +169,7 @@ private:
     bool embedWithoutAskingToSave(const QString &mimeType);
     bool shouldUseDefaultHttpMimeype() const;
     void decideAction();
+    void discardGuess();
     bool isViewLocked() const;
 
     typedef QPair<OpenUrlAction, KService::Ptr> OpenSaveAnswer;
@@ -191,6 +195,7 @@ private:
     QString m_oldLocationBarUrl;
     bool m_jobHadError;
     bool m_dontPassToWebEnginePart;
+    bool m_mimeTypeGuessed = false;
 };
 
 QDebug operator<<(QDebug dbg, UrlLoader::OpenUrlAction action);
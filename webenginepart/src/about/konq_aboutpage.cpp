@@ -1,4 +1,5 @@
 #include "konq_aboutpage.h"
+#include "settings/webenginesettings.h"
 
 #include <QApplication>
 #include <QDir>
@@ -8,7 +9,16 @@
 #include <QTextStream>
 #include <QUrl>
 #include <QBuffer>
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QWebEnginePage>
 #include <QWebEngineUrlRequestJob>
+#include <QWidget>
 
 #include <kiconloader.h>
 #include <KLocalizedString>
@@ -347,6 +357,129 @@ QString KonqAboutPageSingleton::plugins()
     return res;
 }
 
+QString KonqAboutPageSingleton::performance()
+{
+    if (!m_performance_html.isEmpty()) {
+        return m_performance_html;
+    }
+
+    QString res = loadFile(QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("konqueror/about/performance.html")));
+    if (res.isEmpty()) {
+        return res;
+    }
+
+    res = res.arg(i18n("Performance"))
+          .arg(i18nc("State of a tab whose page was unloaded to save memory", "hibernated"))
+          .arg(i18nc("State of a tab whose page isn't loaded yet", "loading"))
+          .arg(i18n("Konqueror process"))
+          .arg(i18n("Memory"))
+          .arg(i18n("CPU time"))
+          .arg(i18n("<th>Page</th><th>Part</th><th>Process</th><th>Memory</th><th>CPU time</th>"
+                    "<th>First paint</th><th>Loaded in</th><th>Transferred</th><th>Blocked</th>"))
+          .arg(i18n("Caches"))
+          .arg(i18n("<th>History entries</th><th>Favicons</th><th>Ad filter decisions</th><th>MIME types</th>"));
+
+    m_performance_html = res;
+    return res;
+}
+
+static const int s_performanceUpdateInterval = 1000;
+
+KonqPerformancePageUpdater::KonqPerformancePageUpdater(QWebEnginePage *page)
+    : QObject(page),
+      m_page(page),
+      m_waitingForReply(false)
+{
+    m_timer.setInterval(s_performanceUpdateInterval);
+    connect(&m_timer, &QTimer::timeout, this, &KonqPerformancePageUpdater::update);
+    connect(page, &QWebEnginePage::urlChanged, this, [this](const QUrl &url) {
+        if (!url.path().endsWith(QLatin1String("performance"))) {
+            deleteLater();
+        }
+    });
+    m_timer.start();
+}
+
+void KonqPerformancePageUpdater::start(QWebEnginePage *page)
+{
+    KonqPerformancePageUpdater *updater = page->findChild<KonqPerformancePageUpdater *>(QString(), Qt::FindDirectChildrenOnly);
+    if (!updater) {
+        updater = new KonqPerformancePageUpdater(page);
+    }
+    // After a reload the tables are empty again
+    updater->requestStatistics();
+}
+
+void KonqPerformancePageUpdater::update()
+{
+    // Nobody looks at a page in a background tab, don't spend time on it
+    QWidget *view = m_page->view();
+    if (view && !view->isVisible()) {
+        return;
+    }
+    requestStatistics();
+}
+
+void KonqPerformancePageUpdater::requestStatistics()
+{
+    if (m_waitingForReply) {
+        return;
+    }
+    // The part lives in the Konqueror process, whose main object knows all the views
+    QDBusMessage message = QDBusMessage::createMethodCall(QDBusConnection::sessionBus().baseService(), QStringLiteral("/KonqMain"),
+                                                          QStringLiteral("org.kde.Konqueror.Main"), QStringLiteral("performanceStatistics"));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &KonqPerformancePageUpdater::slotStatisticsReceived);
+    m_waitingForReply = true;
+}
+
+// The maps and lists nested in a D-Bus reply stay marshalled
+static QVariant demarshall(const QVariant &value)
+{
+    if (value.userType() != qMetaTypeId<QDBusArgument>()) {
+        return value;
+    }
+    const QDBusArgument argument = value.value<QDBusArgument>();
+    if (argument.currentType() == QDBusArgument::MapType) {
+        QVariantMap map = qdbus_cast<QVariantMap>(argument);
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            it.value() = demarshall(it.value());
+        }
+        return map;
+    }
+    if (argument.currentType() == QDBusArgument::ArrayType) {
+        QVariantList list = qdbus_cast<QVariantList>(argument);
+        for (QVariant &item : list) {
+            item = demarshall(item);
+        }
+        return list;
+    }
+    return value;
+}
+
+void KonqPerformancePageUpdater::slotStatisticsReceived(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    m_waitingForReply = false;
+    const QDBusPendingReply<QVariantMap> reply = *watcher;
+    if (reply.isError()) {
+        qCDebug(WEBENGINEPART_LOG) << "Couldn't get the performance statistics:" << reply.error().message();
+        return;
+    }
+
+    QVariantMap statistics = reply.value();
+    for (auto it = statistics.begin(); it != statistics.end(); ++it) {
+        it.value() = demarshall(it.value());
+    }
+    // Konqueror doesn't know about the caches of the part
+    QVariantMap caches = statistics.value(QStringLiteral("caches")).toMap();
+    caches.insert(QStringLiteral("adFilter"), WebEngineSettings::self()->adFilterCacheSize());
+    statistics.insert(QStringLiteral("caches"), caches);
+
+    const QByteArray json = QJsonDocument(QJsonObject::fromVariantMap(statistics)).toJson(QJsonDocument::Compact);
+    m_page->runJavaScript(QStringLiteral("konqUpdatePerformance(%1)").arg(QString::fromUtf8(json)));
+}
+
 KonqUrlSchemeHandler::KonqUrlSchemeHandler(QObject *parent) : QWebEngineUrlSchemeHandler(parent)
 {
 }
@@ -370,6 +503,8 @@ void KonqUrlSchemeHandler::requestStarted(QWebEngineUrlRequestJob *req)
     data = s_staticData->tips();
   } else if (path.endsWith("plugins")) {
     data = s_staticData->plugins();
+  } else if (path.endsWith("performance")) {
+    data = s_staticData->performance();
   } else {
     data = s_staticData->launch();
   }
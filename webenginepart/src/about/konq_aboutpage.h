@@ -2,7 +2,10 @@
 #define __konq_aboutpage_h__
 
 #include <QWebEngineUrlSchemeHandler>
+#include <QTimer>
 
+class QDBusPendingCallWatcher;
+class QWebEnginePage;
 
 class KonqAboutPageSingleton
 {
@@ -12,9 +15,10 @@ public:
     QString specs();
     QString tips();
     QString plugins();
+    QString performance();
 
 private:
-    QString m_launch_html, m_intro_html, m_specs_html, m_tips_html, m_plugins_html;
+    QString m_launch_html, m_intro_html, m_specs_html, m_tips_html, m_plugins_html, m_performance_html;
 };
 
 class KonqUrlSchemeHandler : public QWebEngineUrlSchemeHandler
@@ -32,4 +36,30 @@ private:
     QString m_what;
 };
 
+/**
+ * Keeps konq:performance up to date: the page only contains empty tables,
+ * this asks Konqueror for the statistics of its views periodically and hands
+ * them to the page, which fills the tables without being reloaded.
+ */
+class KonqPerformancePageUpdater : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Starts updating @p page, which has just loaded konq:performance. The
+     * updates stop when it loads something else.
+     */
+    static void start(QWebEnginePage *page);
+
+private:
+    explicit KonqPerformancePageUpdater(QWebEnginePage *page);
+    void update();
+    void requestStatistics();
+    void slotStatisticsReceived(QDBusPendingCallWatcher *watcher);
+
+    QWebEnginePage *m_page;
+    QTimer m_timer;
+    bool m_waitingForReply;
+};
+
 #endif
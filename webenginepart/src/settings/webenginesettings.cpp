@@ -19,6 +19,7 @@
 #include <KMessageBox>
 
 #include <QWebEngineSettings>
+#include <QCache>
 #include <QFontDatabase>
 #include <QFileInfo>
 #include <QDir>
@@ -128,6 +129,9 @@ public:
 
     KDEPrivate::FilterSet adBlackList;
     KDEPrivate::FilterSet adWhiteList;
+    // Pages ask for the same images over and over, matching them against
+    // the filter lists each time is the expensive part
+    QCache<QString, bool> adFilterDecisions;
     QList< QPair< QString, QChar > > m_fallbackAccessKeysAssignments;
 
     KSharedConfig::Ptr nonPasswordStorableSites;
@@ -141,6 +145,7 @@ class WebEngineSettingsPrivate : public QObject, public WebEngineSettingsData
 public:
     void adblockFilterLoadList(const QString& filename)
     {
+        adFilterDecisions.clear();
         /** load list file and process each line */
         QFile file(filename);
         if (file.open(QIODevice::ReadOnly)) {
@@ -277,6 +282,7 @@ void WebEngineSettings::readDomainSettings(const KConfigGroup &config, bool rese
 WebEngineSettings::WebEngineSettings()
   :d (new WebEngineSettingsPrivate)
 {
+  d->adFilterDecisions.setMaxCost(10000);
   init();
 }
 
@@ -342,6 +348,7 @@ void WebEngineSettings::init( KConfig * config, bool reset )
 
       d->adBlackList.clear();
       d->adWhiteList.clear();
+      d->adFilterDecisions.clear();
 
       /** read maximum age for filter list files, minimum is one day */
       int htmlFilterListMaxAgeDays = cgFilter.readEntry(QStringLiteral("HTMLFilterListMaxAgeDays")).toInt();
@@ -848,7 +855,22 @@ bool WebEngineSettings::isAdFiltered( const QString &url ) const
     if (url.startsWith(QLatin1String("data:")))
         return false;
 
-    return d->adBlackList.isUrlMatched(url) && !d->adWhiteList.isUrlMatched(url);
+    if (const bool *filtered = d->adFilterDecisions.object(url))
+        return *filtered;
+
+    const bool filtered = d->adBlackList.isUrlMatched(url) && !d->adWhiteList.isUrlMatched(url);
+    d->adFilterDecisions.insert(url, new bool(filtered));
+    return filtered;
+}
+
+int WebEngineSettings::adFilterCacheSize() const
+{
+    return d->adFilterDecisions.count();
+}
+
+void WebEngineSettings::clearAdFilterCache()
+{
+    d->adFilterDecisions.clear();
 }
 
 QString WebEngineSettings::adFilteredBy( const QString &url, bool *isWhiteListed ) const
@@ -901,6 +923,7 @@ void WebEngineSettings::addAdFilter( const QString &url )
             d->adWhiteList.addFilter(url);
         else
             d->adBlackList.addFilter(url);
+        d->adFilterDecisions.clear();
     }
     else
     {
@@ -86,6 +86,9 @@ public:
     bool isHideAdsEnabled() const;
     void addAdFilter( const QString &url );
     QString adFilteredBy( const QString &url, bool *isWhiteListed = nullptr ) const;
+    // Decisions of isAdFiltered() are remembered until the filters change
+    int adFilterCacheSize() const;
+    void clearAdFilterCache();
 
     // Access Keys
     bool accessKeysEnabled() const;
@@ -20,6 +20,7 @@
 #include <QWebEngineSettings>
 #include <QWebEngineProfile>
 #include <QUrlQuery>
+#include <QTimer>
 
 #include "webenginepart_ext.h"
 #include "webengineview.h"
@@ -195,6 +196,11 @@ WebEnginePart::WebEnginePart(QWidget *parentWidget, QObject *parent,
     connect(m_webView, &QWebEngineView::loadFinished,
             this, &WebEnginePart::slotLoadFinished);
 
+    connect(WebEnginePartControls::self(), &WebEnginePartControls::requestBlocked,
+            this, &WebEnginePart::slotRequestBlocked);
+    connect(WebEnginePartControls::self(), &WebEnginePartControls::schemeRequestHandled,
+            this, &WebEnginePart::slotSchemeRequestHandled);
+
     // Init the QAction we are going to use...
     initActions();
 
@@ -359,6 +365,11 @@ void WebEnginePart::connectWebEnginePageSignals(WebEnginePage* page)
 //            page, SLOT(downloadUrl(QUrl)));
 
     connect(page, &QWebEnginePage::loadProgress, m_browserExtension, &KParts::BrowserExtension::loadingProgress);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    connect(page, &QWebEnginePage::renderProcessPidChanged, this, [this](qint64 pid) {
+        setProperty("konqRendererPid", pid);
+    });
+#endif
     connect(page, &QWebEnginePage::selectionChanged, m_browserExtension, &WebEngineBrowserExtension::updateEditActions);
 //    connect(m_browserExtension, SIGNAL(saveUrl(QUrl)),
 //            page, SLOT(downloadUrl(QUrl)));
@@ -523,10 +534,23 @@ void WebEnginePart::slotLoadStarted()
     }
     // Unless we go via openUrl again, the next time we are here we emit (e.g. after clicking on a link)
     m_emitOpenUrlNotify = true;
+
+    // The metrics Konqueror reads, see updatePageMetrics()
+    setProperty("konqBlockedRequests", 0);
+    setProperty("konqSchemeHandlerTime", 0);
+    setProperty("konqBytesReceived", QVariant());
+    setProperty("konqFirstPaint", QVariant());
 }
 
 void WebEnginePart::slotLoadFinished (bool ok)
 {
+    // Before completed() is emitted below, so that Konqueror finds them then
+    if (ok)
+        updatePageMetrics();
+
+    if (ok && url() == QUrl(QStringLiteral("konq:performance")))
+        KonqPerformancePageUpdater::start(page());
+
     if (!ok || !m_doLoadFinishedActions)
         return;
 
@@ -563,6 +587,62 @@ void WebEnginePart::slotLoadFinished (bool ok)
     updateActions();
 }
 
+// How many times, and how often, to look for the first paint of a page which wasn't painted yet
+static const int s_firstPaintAttempts = 10;
+static const int s_firstPaintInterval = 100;
+
+void WebEnginePart::updatePageMetrics(int attempt)
+{
+    // transferSize is 0 for local files and cached resources, their size is counted instead
+    const QString script = QL1S("(function() {"
+                                "  var entries = performance.getEntriesByType('navigation').concat(performance.getEntriesByType('resource'));"
+                                "  var bytes = 0;"
+                                "  for (var i = 0; i < entries.length; ++i) {"
+                                "    bytes += entries[i].transferSize || entries[i].decodedBodySize || 0;"
+                                "  }"
+                                "  var paint = performance.getEntriesByName('first-paint');"
+                                "  return {bytes: bytes, firstPaint: paint.length > 0 ? Math.round(paint[0].startTime) : -1};"
+                                "})()");
+    const QUrl pageUrl = m_webView->url();
+    auto callback = [this, attempt, pageUrl](const QVariant &res) {
+        const QVariantMap metrics = res.toMap();
+        setProperty("konqBytesReceived", metrics.value(QStringLiteral("bytes")).toLongLong());
+        const qint64 firstPaint = metrics.value(QStringLiteral("firstPaint")).toLongLong();
+        if (firstPaint >= 0) {
+            setProperty("konqFirstPaint", firstPaint);
+        } else if (attempt + 1 < s_firstPaintAttempts) {
+            // Not painted yet, unless it's in a background tab it will be soon
+            QTimer::singleShot(s_firstPaintInterval, this, [this, attempt, pageUrl]() {
+                if (m_webView->url() == pageUrl && !property("konqFirstPaint").isValid()) {
+                    updatePageMetrics(attempt + 1);
+                }
+            });
+        }
+    };
+    page()->runJavaScript(script, QWebEngineScript::ApplicationWorld, callback);
+}
+
+void WebEnginePart::slotRequestBlocked(const QUrl &firstPartyUrl)
+{
+    if (firstPartyUrl.adjusted(QUrl::RemoveFragment) == m_webView->url().adjusted(QUrl::RemoveFragment)) {
+        setProperty("konqBlockedRequests", property("konqBlockedRequests").toInt() + 1);
+    }
+}
+
+void WebEnginePart::slotSchemeRequestHandled(const QUrl &url, qint64 time)
+{
+    // Scheme handlers don't know which page made the request, so it's counted
+    // for the pages from the same place, including the one being opened
+    const QUrl pageUrl = m_webView->url();
+    const QUrl requestedUrl = page()->requestedUrl();
+    const auto sameOrigin = [url](const QUrl &other) {
+        return url.scheme() == other.scheme() && url.host() == other.host();
+    };
+    if (sameOrigin(pageUrl) || sameOrigin(requestedUrl)) {
+        setProperty("konqSchemeHandlerTime", property("konqSchemeHandlerTime").toLongLong() + time);
+    }
+}
+
 void WebEnginePart::slotLoadAborted(const QUrl & url)
 {
     closeUrl();
@@ -1036,6 +1116,12 @@ void WebEnginePart::exitFullScreen()
     page()->triggerAction(QWebEnginePage::ExitFullScreen);
 }
 
+void WebEnginePart::trimCaches()
+{
+    // Shared by all the parts, each page fills it again as it needs
+    WebEngineSettings::self()->clearAdFilterCache();
+}
+
 void WebEnginePart::walletFinishedFormDetection(const QUrl& url, bool found, bool autoFillableFound)
 {
     if (page() && page()->url() == url) {
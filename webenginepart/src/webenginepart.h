@@ -132,6 +132,11 @@ public:
 public Q_SLOTS:
     void exitFullScreen();
     void setInspectedPart(KParts::ReadOnlyPart *part);
+    /**
+     * Called by Konqueror under memory pressure: drops what can be computed
+     * again when needed.
+     */
+    void trimCaches();
 
 protected:
     /**
@@ -183,6 +188,9 @@ private Q_SLOTS:
     void walletFinishedFormDetection(const QUrl &url, bool found, bool autoFillableFound);
     void updateWalletActions();
 
+    void slotRequestBlocked(const QUrl &firstPartyUrl);
+    void slotSchemeRequestHandled(const QUrl &url, qint64 time);
+
 private:
     WebEnginePage* page();
     const WebEnginePage* page() const;
@@ -202,6 +210,19 @@ private:
 
     void attemptInstallKIOSchemeHandler(const QUrl &url);
 
+    /**
+     * @brief Reports the metrics of the loaded page to Konqueror
+     *
+     * The amount of bytes transferred and the time of the first paint are
+     * taken from the Performance API of the page, and stored in the
+     * `konqBytesReceived` and `konqFirstPaint` properties. Since a small page
+     * can finish loading before it's painted, the time of the first paint is
+     * asked again a few times if needed.
+     *
+     * @param attempt how many times the metrics were asked for this page before
+     */
+    void updatePageMetrics(int attempt = 0);
+
     void initActions();
     void createWalletActions();
     void updateActions();
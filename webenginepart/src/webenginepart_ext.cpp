@@ -132,6 +132,10 @@ void WebEngineBrowserExtension::saveState(QDataStream &stream)
     const int historyIndex = (history ? history->currentItemIndex() : -1);
     const QUrl historyUrl = (history && historyIndex > -1) ? QUrl(history->currentItem().url()) : m_part->url();
 
+    // The navigation history of the page isn't serialized: the host keeps one
+    // state per history entry, and restoreState() drops all but the current
+    // item in Konqueror anyway. m_historyData is only set by saveHistory(),
+    // which nothing calls, so it stays empty.
     stream << historyUrl
            << static_cast<qint32>(xOffset())
            << static_cast<qint32>(yOffset())
@@ -96,3 +96,13 @@ bool WebEnginePartControls::handleCertificateError(const QWebEngineCertificateEr
 {
     return m_certificateErrorDialogManager->handleCertificateError(ce, page);
 }
+
+void WebEnginePartControls::reportBlockedRequest(const QUrl& firstPartyUrl)
+{
+    emit requestBlocked(firstPartyUrl);
+}
+
+void WebEnginePartControls::reportSchemeRequest(const QUrl& url, qint64 time)
+{
+    emit schemeRequestHandled(url, time);
+}
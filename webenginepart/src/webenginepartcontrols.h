@@ -11,6 +11,7 @@
 
 #include <QObject>
 #include <QWebEngineCertificateError>
+#include <QUrl>
 
 class QWebEngineProfile;
 class WebEnginePartCookieJar;
@@ -42,6 +43,22 @@ public:
 
     bool handleCertificateError(const QWebEngineCertificateError &ce, WebEnginePage *page);
 
+    /**
+     * Called by the request interceptor when the ad filter blocks a request
+     * made by the page at @p firstPartyUrl.
+     */
+    void reportBlockedRequest(const QUrl &firstPartyUrl);
+
+    /**
+     * Called by the scheme handlers when they took @p time milliseconds to
+     * answer the request for @p url.
+     */
+    void reportSchemeRequest(const QUrl &url, qint64 time);
+
+signals:
+    void requestBlocked(const QUrl &firstPartyUrl);
+    void schemeRequestHandled(const QUrl &url, qint64 time);
+
 private:
 
     WebEnginePartControls();
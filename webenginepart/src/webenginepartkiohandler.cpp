@@ -7,6 +7,7 @@
 */
 
 #include "webenginepartkiohandler.h"
+#include "webenginepartcontrols.h"
 
 #include <QMimeDatabase>
 #include <QBuffer>
@@ -39,6 +40,7 @@ void WebEnginePartKIOHandler::sendReply()
         } else {
             m_currentRequest->fail(m_error);
         }
+        WebEnginePartControls::self()->reportSchemeRequest(m_currentRequest->requestUrl(), m_requestTimer.elapsed());
         m_currentRequest.clear();
     }
     processNextRequest();
@@ -57,6 +59,7 @@ void WebEnginePartKIOHandler::processNextRequest()
     if (!m_currentRequest) {
         return;
     }
+    m_requestTimer.start();
     KIO::StoredTransferJob *job =  KIO::storedGet(m_currentRequest ->requestUrl(), KIO::NoReload, KIO::HideProgressInfo);
     connect(job, &KIO::StoredTransferJob::result, this, [this, job](){kioJobFinished(job);});
 }
@@ -13,6 +13,7 @@
 #include <QWebEngineUrlRequestJob>
 #include <QPointer>
 #include <QMimeType>
+#include <QElapsedTimer>
 
 namespace KIO {
   class StoredTransferJob;  
@@ -298,6 +299,11 @@ private:
      * This is valid only after the call to kioJobFinished()
      */ 
     QMimeType m_mimeType;
+
+    /**
+     * @brief Measures how long answering the current request takes
+     */
+    QElapsedTimer m_requestTimer;
     
 };
 
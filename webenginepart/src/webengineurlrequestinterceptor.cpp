@@ -8,6 +8,7 @@
 
 #include "settings/webenginesettings.h"
 #include "webengineurlrequestinterceptor.h"
+#include "webenginepartcontrols.h"
 
 WebEngineUrlRequestInterceptor::WebEngineUrlRequestInterceptor(QObject* parent) :
     QWebEngineUrlRequestInterceptor(parent)
@@ -17,6 +18,10 @@ WebEngineUrlRequestInterceptor::WebEngineUrlRequestInterceptor(QObject* parent)
 void WebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo &info)
 {
     if (info.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeImage) {
-        info.block(WebEngineSettings::self()->isAdFiltered(info.requestUrl().url()));
+        const bool blocked = WebEngineSettings::self()->isAdFiltered(info.requestUrl().url());
+        info.block(blocked);
+        if (blocked) {
+            WebEnginePartControls::self()->reportBlockedRequest(info.firstPartyUrl());
+        }
     }
 }